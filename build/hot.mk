@@ -20,6 +20,7 @@ HOT_SOURCES = \
 	$(ENGINE_SRC_DIR)/Waypoints/Waypoints.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/Airspaces.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleArea.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSector.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/MacCready.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlidePolar.cpp \
 	$(ENGINE_SRC_DIR)/Route/FlatTriangleFan.cpp \
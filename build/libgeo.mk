@@ -26,6 +26,7 @@ GEO_SOURCES := \
 	$(GEO_SRC_DIR)/GeoVector.cpp \
 	$(GEO_SRC_DIR)/GeoBounds.cpp \
 	$(GEO_SRC_DIR)/GeoClip.cpp \
+	$(GEO_SRC_DIR)/DouglasPeucker.cpp \
 	$(GEO_SRC_DIR)/Quadrilateral.cpp \
 	$(GEO_SRC_DIR)/SearchPoint.cpp \
 	$(GEO_SRC_DIR)/SearchPointVector.cpp \
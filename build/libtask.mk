@@ -4,6 +4,7 @@ TASK_SOURCES = \
 	$(TASK_SRC_DIR)/Shapes/FAITriangleSettings.cpp \
 	$(TASK_SRC_DIR)/Shapes/FAITriangleRules.cpp \
 	$(TASK_SRC_DIR)/Shapes/FAITriangleArea.cpp \
+	$(TASK_SRC_DIR)/Shapes/FAITriangleSector.cpp \
 	$(TASK_SRC_DIR)/Shapes/FAITriangleTask.cpp \
 	$(TASK_SRC_DIR)/Shapes/FAITrianglePointValidator.cpp \
 	$(TASK_SRC_DIR)/TaskBehaviour.cpp \
@@ -23,6 +24,7 @@ TASK_SOURCES = \
 	$(TASK_SRC_DIR)/Ordered/Points/AATPoint.cpp \
 	$(TASK_SRC_DIR)/Ordered/AATIsoline.cpp \
 	$(TASK_SRC_DIR)/Ordered/AATIsolineSegment.cpp \
+	$(TASK_SRC_DIR)/Ordered/AATIsolineMemento.cpp \
 	$(TASK_SRC_DIR)/Unordered/UnorderedTask.cpp \
 	$(TASK_SRC_DIR)/Unordered/UnorderedTaskPoint.cpp \
 	$(TASK_SRC_DIR)/Unordered/GotoTask.cpp \
@@ -65,7 +67,7 @@ TASK_SOURCES = \
 	$(TASK_SRC_DIR)/Solvers/TaskCruiseEfficiency.cpp \
 	$(TASK_SRC_DIR)/Solvers/TaskEffectiveMacCready.cpp \
 	$(TASK_SRC_DIR)/Solvers/TaskMinTarget.cpp \
-	$(TASK_SRC_DIR)/Solvers/TaskOptTarget.cpp \
+	$(TASK_SRC_DIR)/Solvers/TaskOptTargets.cpp \
 	$(TASK_SRC_DIR)/Solvers/TaskGlideRequired.cpp \
 	$(TASK_SRC_DIR)/Solvers/TaskSolution.cpp \
 	$(TASK_SRC_DIR)/Computer/ElementStatComputer.cpp \
@@ -18,7 +18,8 @@ UTIL_SOURCES = \
 	$(UTIL_SRC_DIR)/AllocatedString.cxx \
 	$(UTIL_SRC_DIR)/StringView.cxx \
 	$(UTIL_SRC_DIR)/StringCompare.cxx \
-	$(UTIL_SRC_DIR)/StringUtil.cpp
+	$(UTIL_SRC_DIR)/StringUtil.cpp \
+	$(UTIL_SRC_DIR)/TrigramIndex.cpp
 
 ifeq ($(HAVE_MSVCRT),y)
 UTIL_SOURCES += \
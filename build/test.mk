@@ -94,9 +94,12 @@ TEST_NAMES = \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestTrigramIndex TestLabelBlock TestReachabilityComputer TestGeoBounds TestGeoClip TestDouglasPeucker \
+	TestFAITriangleSector \
+	TestGuard TestTaskSnapshot \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
-	TestWaypointReader TestThermalBase \
+	TestWaypointReader TestWaypointList TestWaypointDetails TestWaypointJournal \
+	TestThermalBase \
 	TestFlarmNet \
 	TestColorRamp TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
@@ -107,7 +110,7 @@ TEST_NAMES = \
 	TestTaskWaypoint \
 	TestTeamCode \
 	TestZeroFinder \
-	TestAirspaceParser \
+	TestAirspaceParser TestAirspaceGroundLevels TestAirspaceAltitudeFilter \
 	TestMETARParser \
 	TestIGCParser \
 	TestByteOrder \
@@ -197,6 +200,22 @@ TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
 TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
+TEST_AIRSPACE_GROUND_LEVELS_SOURCES = \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceGroundLevels.cpp
+TEST_AIRSPACE_GROUND_LEVELS_DEPENDS = AIRSPACE TERRAIN IO ZZIP OS GEO MATH UTIL
+$(eval $(call link-program,TestAirspaceGroundLevels,TEST_AIRSPACE_GROUND_LEVELS))
+
+TEST_AIRSPACE_ALTITUDE_FILTER_SOURCES = \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceAltitudeFilter.cpp
+TEST_AIRSPACE_ALTITUDE_FILTER_DEPENDS = AIRSPACE GEO MATH UTIL
+$(eval $(call link-program,TestAirspaceAltitudeFilter,TEST_AIRSPACE_ALTITUDE_FILTER))
+
 TEST_DATE_TIME_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestDateTime.cpp
@@ -231,6 +250,29 @@ TEST_MAC_CREADY_OBJS = $(call SRC_TO_OBJ,$(TEST_MAC_CREADY_SOURCES))
 TEST_MAC_CREADY_DEPENDS = GLIDE GEO MATH UTIL
 $(eval $(call link-program,TestMacCready,TEST_MAC_CREADY))
 
+TEST_WAYPOINT_LIST_SOURCES = \
+	$(SRC)/Waypoint/WaypointList.cpp \
+	$(SRC)/Waypoint/WaypointListBuilder.cpp \
+	$(SRC)/Waypoint/WaypointFilter.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestWaypointList.cpp
+TEST_WAYPOINT_LIST_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+$(eval $(call link-program,TestWaypointList,TEST_WAYPOINT_LIST))
+
+TEST_WAYPOINT_DETAILS_SOURCES = \
+	$(SRC)/Waypoint/WaypointDetailsReader.cpp \
+	$(SRC)/IO/ConfiguredFile.cpp \
+	$(SRC)/IO/MapFile.cpp \
+	$(SRC)/Profile/ProfileKeys.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeProfile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestWaypointDetails.cpp
+TEST_WAYPOINT_DETAILS_DEPENDS = WAYPOINT GEO MATH IO ZZIP OS UTIL
+$(eval $(call link-program,TestWaypointDetails,TEST_WAYPOINT_DETAILS))
+
 TEST_ORDERED_TASK_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -394,6 +436,34 @@ TEST_GEO_BOUNDS_SOURCES = \
 TEST_GEO_BOUNDS_DEPENDS = GEO MATH
 $(eval $(call link-program,TestGeoBounds,TEST_GEO_BOUNDS))
 
+TEST_FAI_TRIANGLE_SECTOR_SOURCES = \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSettings.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleRules.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSector.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFAITriangleSector.cpp
+TEST_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
+$(eval $(call link-program,TestFAITriangleSector,TEST_FAI_TRIANGLE_SECTOR))
+
+TEST_GUARD_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestGuard.cpp
+TEST_GUARD_DEPENDS = THREAD
+$(eval $(call link-program,TestGuard,TEST_GUARD))
+
+TEST_TASK_SNAPSHOT_SOURCES = \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/TaskSnapshot.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTaskSnapshot.cpp
+TEST_TASK_SNAPSHOT_DEPENDS = TASK ROUTE WAYPOINT GLIDE AIRSPACE TERRAIN IO ZZIP OS THREAD GEO TIME MATH UTIL
+$(eval $(call link-program,TestTaskSnapshot,TEST_TASK_SNAPSHOT))
+
 TEST_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/FlarmNetReader.cpp \
 	$(SRC)/FLARM/FlarmId.cpp \
@@ -410,6 +480,12 @@ TEST_GEO_CLIP_SOURCES = \
 TEST_GEO_CLIP_DEPENDS = GEO MATH
 $(eval $(call link-program,TestGeoClip,TEST_GEO_CLIP))
 
+TEST_DOUGLAS_PEUCKER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDouglasPeucker.cpp
+TEST_DOUGLAS_PEUCKER_DEPENDS = GEO MATH
+$(eval $(call link-program,TestDouglasPeucker,TEST_DOUGLAS_PEUCKER))
+
 TEST_CLIMB_AV_CALC_SOURCES = \
 	$(SRC)/Computer/ClimbAverageCalculator.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -514,6 +590,7 @@ TEST_GLIDE_POLAR_SOURCES = \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideResult.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideState.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/MacCready.cpp \
+	$(ENGINE_SRC_DIR)/GlideSolvers/GlideSettings.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -610,6 +687,33 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_TRIGRAM_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrigramIndex.cpp
+TEST_TRIGRAM_INDEX_DEPENDS = UTIL
+$(eval $(call link-program,TestTrigramIndex,TEST_TRIGRAM_INDEX))
+
+TEST_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(SRC)/Renderer/LabelHistory.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLabelBlock.cpp
+TEST_LABEL_BLOCK_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_LABEL_BLOCK_DEPENDS = UTIL
+$(eval $(call link-program,TestLabelBlock,TEST_LABEL_BLOCK))
+
+TEST_REACHABILITY_COMPUTER_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Computer/ReachabilityCache.cpp \
+	$(SRC)/Computer/ReachabilityComputer.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestReachabilityComputer.cpp
+TEST_REACHABILITY_COMPUTER_DEPENDS = WAYPOINT ROUTE AIRSPACE TERRAIN IO ZZIP OS GLIDE GEO MATH UTIL
+$(eval $(call link-program,TestReachabilityComputer,TEST_REACHABILITY_COMPUTER))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -688,6 +792,7 @@ TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
 	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Operation/Operation.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
@@ -696,6 +801,22 @@ TEST_WAY_POINT_FILE_SOURCES = \
 TEST_WAY_POINT_FILE_DEPENDS = WAYPOINT GEO MATH IO ZZIP OS THREAD UTIL
 $(eval $(call link-program,TestWaypointReader,TEST_WAY_POINT_FILE))
 
+TEST_WAYPOINT_JOURNAL_SOURCES = \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/CupWriter.cpp \
+	$(SRC)/Waypoint/WaypointJournal.cpp \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestWaypointJournal.cpp
+TEST_WAYPOINT_JOURNAL_DEPENDS = WAYPOINT GEO MATH IO OS THREAD UTIL
+$(eval $(call link-program,TestWaypointJournal,TEST_WAYPOINT_JOURNAL))
+
 TEST_TRACE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(SRC)/Engine/Trace/Point.cpp \
@@ -731,6 +852,9 @@ DEBUG_PROGRAM_NAMES = \
 	FlightPath \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkAirspaceQuery \
+	BenchmarkTask \
+	BenchmarkLabels \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -786,6 +910,7 @@ DEBUG_PROGRAM_NAMES = \
 	RunRepositoryParser \
 	IGC2NMEA \
 	NearestWaypoints \
+	SearchWaypoints \
 	RunKalmanFilter1d \
 	ArcApprox
 
@@ -899,11 +1024,33 @@ $(eval $(call link-program,BenchmarkProjection,BENCHMARK_PROJECTION))
 
 BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSettings.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleRules.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleArea.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSector.cpp \
 	$(TEST_SRC_DIR)/BenchmarkFAITriangleSector.cpp
-BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
+BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = OS GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_AIRSPACE_QUERY_SOURCES = \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceQuery.cpp
+BENCHMARK_AIRSPACE_QUERY_DEPENDS = AIRSPACE GEO MATH OS UTIL
+$(eval $(call link-program,BenchmarkAirspaceQuery,BENCHMARK_AIRSPACE_QUERY))
+
+$(eval $(call link-harness-program,BenchmarkTask))
+
+BENCHMARK_LABELS_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(SRC)/Renderer/LabelHistory.cpp \
+	$(SRC)/Renderer/WaypointLabelList.cpp \
+	$(TEST_SRC_DIR)/BenchmarkLabels.cpp
+BENCHMARK_LABELS_CPPFLAGS = $(SCREEN_CPPFLAGS)
+BENCHMARK_LABELS_DEPENDS = WAYPOINT GEO MATH OS UTIL
+$(eval $(call link-program,BenchmarkLabels,BENCHMARK_LABELS))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1158,6 +1305,7 @@ $(eval $(call link-program,RunInputParser,RUN_INPUT_PARSER))
 
 RUN_WAY_POINT_PARSER_SOURCES = \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
@@ -1200,6 +1348,28 @@ NEAREST_WAYPOINTS_LDADD = $(FAKE_LIBS)
 NEAREST_WAYPOINTS_DEPENDS = WAYPOINT IO OS THREAD ZZIP GEO MATH UTIL
 $(eval $(call link-program,NearestWaypoints,NEAREST_WAYPOINTS))
 
+SEARCH_WAYPOINTS_SOURCES = \
+	$(SRC)/Waypoint/WaypointFileType.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/SearchWaypoints.cpp
+SEARCH_WAYPOINTS_LDADD = $(FAKE_LIBS)
+SEARCH_WAYPOINTS_DEPENDS = WAYPOINT IO OS THREAD ZZIP GEO MATH UTIL
+$(eval $(call link-program,SearchWaypoints,SEARCH_WAYPOINTS))
+
 RUN_FLIGHT_PARSER_SOURCES = \
 	$(SRC)/Logger/FlightParser.cpp \
 	$(TEST_SRC_DIR)/RunFlightParser.cpp
@@ -1637,7 +1807,7 @@ RUN_TASK_SOURCES = \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
 	$(TEST_SRC_DIR)/RunTask.cpp
 RUN_TASK_LDADD = $(DEBUG_REPLAY_LDADD)
-RUN_TASK_DEPENDS = TASK WAYPOINT GLIDE GEO MATH UTIL IO TIME
+RUN_TASK_DEPENDS = TASK WAYPOINT GLIDE GEO MATH UTIL IO TIME THREAD
 $(eval $(call link-program,RunTask,RUN_TASK))
 
 RUN_TRACE_SOURCES = \
@@ -1813,6 +1983,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/TaskRenderer.cpp \
 	$(SRC)/Renderer/TaskPointRenderer.cpp \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
@@ -1833,6 +2004,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Math/Screen.cpp \
 	$(MORE_SCREEN_SOURCES) \
 	$(SRC)/Renderer/LabelBlock.cpp \
+	$(SRC)/Renderer/LabelHistory.cpp \
 	$(SRC)/Renderer/TextInBox.cpp \
 	$(SRC)/Screen/Ramp.cpp \
 	$(SRC)/UISettings.cpp \
@@ -1885,6 +2057,10 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Waypoint/LastUsed.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/SaveGlue.cpp \
+	$(SRC)/Waypoint/CupWriter.cpp \
+	$(SRC)/Waypoint/WaypointJournal.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
@@ -2160,7 +2336,9 @@ RUN_FAI_TRIANGLE_SECTOR_RENDERER_SOURCES = \
 	$(SRC)/Projection/Projection.cpp \
 	$(SRC)/Projection/WindowProjection.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSettings.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleRules.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleArea.cpp \
+	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSector.cpp \
 	$(TEST_SRC_DIR)/FakeAsset.cpp \
 	$(TEST_SRC_DIR)/Fonts.cpp \
 	$(TEST_SRC_DIR)/RunFAITriangleSectorRenderer.cpp
@@ -2224,6 +2402,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Task/LoadFile.cpp \
 	$(SRC)/Task/DefaultTask.cpp \
 	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/TaskSnapshot.cpp \
 	$(SRC)/Task/ProtectedRoutePlanner.cpp \
 	$(SRC)/Task/RoutePlannerGlue.cpp \
 	$(SRC)/Task/TaskFile.cpp \
@@ -2310,6 +2489,8 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/GlideComputerBlackboard.cpp \
 	$(SRC)/Computer/TaskComputer.cpp \
 	$(SRC)/Computer/RouteComputer.cpp \
+	$(SRC)/Computer/ReachabilityCache.cpp \
+	$(SRC)/Computer/ReachabilityComputer.cpp \
 	$(SRC)/Computer/GlideComputerAirData.cpp \
 	$(SRC)/Computer/WaveComputer.cpp \
 	$(SRC)/Computer/StatsComputer.cpp \
@@ -2345,6 +2526,8 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(SRC)/Operation/ProxyOperationEnvironment.cpp \
 	$(SRC)/Operation/NoCancelOperationEnvironment.cpp \
+	$(SRC)/Operation/ThreadedOperationEnvironment.cpp \
+	$(SRC)/Job/Async.cpp \
 	$(TEST_SRC_DIR)/FakeAsset.cpp \
 	$(TEST_SRC_DIR)/FakeDialogs.cpp \
 	$(TEST_SRC_DIR)/FakeListPicker.cpp \
@@ -2475,6 +2658,7 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Task/TaskFileIGC.cpp \
 	$(SRC)/Task/TaskFileSeeYou.cpp \
 	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/TaskSnapshot.cpp \
 	$(SRC)/LocalPath.cpp \
 	$(SRC)/UtilsFont.cpp \
 	$(SRC)/Units/Units.cpp \
@@ -2483,6 +2667,10 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Formatter/Units.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/SaveGlue.cpp \
+	$(SRC)/Waypoint/CupWriter.cpp \
+	$(SRC)/Waypoint/WaypointJournal.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
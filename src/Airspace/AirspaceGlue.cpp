@@ -34,8 +34,12 @@ Copyright_License {
 #include "IO/ZipLineReader.hpp"
 #include "IO/MapFile.hpp"
 #include "Profile/Profile.hpp"
+#include "OS/Clock.hpp"
+
+#include <stdexcept>
 
 #include <string.h>
+#include <assert.h>
 
 static bool
 ParseAirspaceFile(AirspaceParser &parser, Path path,
@@ -74,33 +78,35 @@ try {
   return false;
 }
 
-void
-ReadAirspace(Airspaces &airspaces,
-             RasterTerrain *terrain,
-             const AtmosphericPressure &press,
-             OperationEnvironment &operation)
+/**
+ * Parses all configured airspace files.
+ *
+ * @return true if at least one file was parsed successfully
+ */
+static bool
+ParseAirspaceFiles(AirspaceParser &parser, Path path, Path additional_path,
+                   ZipArchive *archive, OperationEnvironment &operation)
 {
-  LogFormat("ReadAirspace");
-  operation.SetText(_("Loading Airspace File..."));
-
   bool airspace_ok = false;
 
-  AirspaceParser parser(airspaces);
-
-  // Read the airspace filenames from the registry
-  auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
   if (!path.IsNull())
     airspace_ok |= ParseAirspaceFile(parser, path, operation);
 
-  path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
-  if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+  if (!additional_path.IsNull())
+    airspace_ok |= ParseAirspaceFile(parser, additional_path, operation);
 
-  auto archive = OpenMapFile();
-  if (archive)
+  if (archive != nullptr)
     airspace_ok |= ParseAirspaceFile(parser, archive->get(), "airspace.txt",
                                      operation);
 
+  return airspace_ok;
+}
+
+static void
+FinishAirspace(Airspaces &airspaces, bool airspace_ok,
+               RasterTerrain *terrain,
+               const AtmosphericPressure &press)
+{
   if (airspace_ok) {
     airspaces.Optimise();
     airspaces.SetFlightLevels(press);
@@ -111,3 +117,99 @@ ReadAirspace(Airspaces &airspaces,
     // there was a problem
     airspaces.Clear();
 }
+
+void
+ReadAirspace(Airspaces &airspaces,
+             RasterTerrain *terrain,
+             const AtmosphericPressure &press,
+             OperationEnvironment &operation)
+{
+  LogFormat("ReadAirspace");
+  operation.SetText(_("Loading Airspace File..."));
+
+  AirspaceParser parser(airspaces);
+
+  // Read the airspace filenames from the registry
+  const auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
+  const auto additional_path =
+    Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
+  auto archive = OpenMapFile();
+
+  const bool airspace_ok =
+    ParseAirspaceFiles(parser, path, additional_path, archive.get(),
+                       operation);
+
+  FinishAirspace(airspaces, airspace_ok, terrain, press);
+}
+
+AirspaceLoader::AirspaceLoader(Airspaces &_airspaces)
+  :airspaces(_airspaces), path(nullptr), additional_path(nullptr),
+   airspace_ok(false), start_time(0), parse_duration(0) {}
+
+AirspaceLoader::~AirspaceLoader()
+{
+  if (runner.IsBusy()) {
+    runner.Cancel();
+
+    try {
+      runner.Wait();
+    } catch (const std::runtime_error &e) {
+      LogError(e);
+    }
+  }
+}
+
+void
+AirspaceLoader::Start()
+{
+  LogFormat("ReadAirspace (background)");
+
+  /* the profile is not thread-safe; look up the files here, in the
+     main thread */
+  path = Profile::GetPath(ProfileKeys::AirspaceFile);
+  additional_path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
+  archive = OpenMapFile();
+
+  start_time = MonotonicClockMS();
+  runner.Start(this, null_operation);
+}
+
+void
+AirspaceLoader::Run(OperationEnvironment &env)
+{
+  const unsigned begin = MonotonicClockMS();
+
+  AirspaceParser parser(airspaces);
+  airspace_ok = ParseAirspaceFiles(parser, path, additional_path,
+                                   archive.get(), env);
+
+  parse_duration = MonotonicClockMS() - begin;
+}
+
+void
+AirspaceLoader::Finish(RasterTerrain *terrain,
+                       const AtmosphericPressure &press,
+                       OperationEnvironment &operation)
+{
+  assert(runner.IsBusy());
+
+  operation.SetText(_("Loading Airspace File..."));
+
+  const unsigned wait_start = MonotonicClockMS();
+
+  try {
+    runner.Wait();
+  } catch (const std::runtime_error &e) {
+    LogError(e);
+    airspace_ok = false;
+  }
+
+  archive.reset();
+
+  FinishAirspace(airspaces, airspace_ok, terrain, press);
+
+  const unsigned now = MonotonicClockMS();
+  LogFormat("Airspaces available after %u ms "
+            "(parsing %u ms, startup blocked for %u ms)",
+            now - start_time, parse_duration, now - wait_start);
+}
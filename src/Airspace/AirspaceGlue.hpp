@@ -24,10 +24,17 @@ Copyright_License {
 #ifndef XCSOAR_AIRSPACE_GLUE_HPP
 #define XCSOAR_AIRSPACE_GLUE_HPP
 
+#include "Job/Job.hpp"
+#include "Job/Async.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Path.hpp"
+
+#include <memory>
+
 class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
-class OperationEnvironment;
+class ZipArchive;
 
 /**
  * Reads the airspace files into the memory
@@ -38,4 +45,52 @@ ReadAirspace(Airspaces &airspaces,
              const AtmosphericPressure &press,
              OperationEnvironment &operation);
 
+/**
+ * Parses the configured airspace files in a background thread, so
+ * the rest of the startup can proceed meanwhile.  Nobody else may
+ * access the #Airspaces object between Start() and Finish().
+ */
+class AirspaceLoader final : Job {
+  Airspaces &airspaces;
+
+  AsyncJobRunner runner;
+
+  /**
+   * Progress reports from the background thread are discarded; they
+   * would interfere with the progress of the other startup tasks.
+   */
+  NullOperationEnvironment null_operation;
+
+  /**
+   * The configured files, looked up by Start() in the main thread.
+   */
+  AllocatedPath path, additional_path;
+  std::unique_ptr<ZipArchive> archive;
+
+  bool airspace_ok;
+
+  unsigned start_time, parse_duration;
+
+public:
+  explicit AirspaceLoader(Airspaces &_airspaces);
+  ~AirspaceLoader();
+
+  /**
+   * Look up the configured airspace files and begin parsing them in
+   * a background thread.
+   */
+  void Start();
+
+  /**
+   * Wait for the background thread, then prepare the parsed
+   * airspaces like ReadAirspace() does.
+   */
+  void Finish(RasterTerrain *terrain, const AtmosphericPressure &press,
+              OperationEnvironment &operation);
+
+private:
+  /* virtual methods from class Job */
+  void Run(OperationEnvironment &env) override;
+};
+
 #endif
@@ -56,6 +56,7 @@ GlideComputer::ResetFlight(const bool full)
   stats_computer.ResetFlight(full);
   log_computer.Reset();
   retrospective.Reset();
+  reachability_computer.Reset();
 
   cu_computer.Reset();
   warning_computer.Reset();
@@ -169,6 +170,12 @@ GlideComputer::ProcessIdle(bool exhaustive)
   task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
                             exhaustive);
 
+  // Calculate the arrival altitudes for the map
+  reachability_computer.Update(waypoints, basic, calculated,
+                               GetComputerSettings().task,
+                               GetComputerSettings().polar,
+                               task_computer.GetRoutePlanner());
+
   warning_computer.Update(GetComputerSettings(), basic,
                           calculated, calculated.airspace_warnings);
 
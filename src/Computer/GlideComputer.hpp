@@ -33,6 +33,7 @@ Copyright_License {
 #include "LogComputer.hpp"
 #include "WarningComputer.hpp"
 #include "CuComputer.hpp"
+#include "ReachabilityComputer.hpp"
 #include "Compiler.h"
 #include "Engine/Contest/Solvers/Retrospective.hpp"
 
@@ -53,6 +54,7 @@ class GlideComputer : public GlideComputerBlackboard
   StatsComputer stats_computer;
   LogComputer log_computer;
   CuComputer cu_computer;
+  ReachabilityComputer reachability_computer;
 
   const Waypoints &waypoints;
 
@@ -146,6 +148,10 @@ public:
     return task_computer.GetProtectedRoutePlanner();
   }
 
+  const ProtectedReachabilityCache &GetReachability() const {
+    return reachability_computer.GetProtectedCache();
+  }
+
   void ClearAirspaces() {
     task_computer.ClearAirspaces();
   }
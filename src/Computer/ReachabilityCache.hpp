@@ -0,0 +1,105 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_REACHABILITY_CACHE_HPP
+#define XCSOAR_REACHABILITY_CACHE_HPP
+
+#include "Engine/Route/ReachResult.hpp"
+#include "Thread/Guard.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * The arrival altitudes of the landable and watched waypoints around
+ * the aircraft, calculated by #ReachabilityComputer in the
+ * calculation thread.  Waypoints which are not in the cache are out
+ * of reach.
+ */
+class ReachabilityCache {
+public:
+  /**
+   * Same order as WaypointRenderer::Reachability.
+   */
+  enum class Reachability : uint8_t {
+    INVALID,
+    UNREACHABLE,
+    STRAIGHT,
+    TERRAIN,
+  };
+
+  struct Item {
+    /**
+     * The Waypoint::id.
+     */
+    unsigned id;
+
+    Reachability reachable;
+
+    ReachResult reach;
+
+    bool operator<(const Item &other) const {
+      return id < other.id;
+    }
+  };
+
+private:
+  /**
+   * Sorted by id.
+   */
+  std::vector<Item> items;
+
+public:
+  bool IsEmpty() const {
+    return items.empty();
+  }
+
+  unsigned size() const {
+    return items.size();
+  }
+
+  void Clear() {
+    items.clear();
+  }
+
+  /**
+   * Replace the contents with the specified vector, which must be
+   * sorted by id.  The old contents are returned in the vector, to
+   * allow reusing its allocation.
+   */
+  void Swap(std::vector<Item> &other) {
+    items.swap(other);
+  }
+
+  gcc_pure
+  const Item *Find(unsigned id) const;
+};
+
+/**
+ * The #ReachabilityCache shared by the calculation thread (which
+ * writes it) and the renderers (which read it).
+ */
+typedef Guard<ReachabilityCache> ProtectedReachabilityCache;
+
+#endif
@@ -0,0 +1,270 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "ReachabilityComputer.hpp"
+#include "Computer/Settings.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Task/RoutePlannerGlue.hpp"
+#include "Geo/GeoVector.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+/**
+ * The lowest waypoint elevation assumed when estimating the glide
+ * range [m].  A few airfields are below sea level.
+ */
+static constexpr double MIN_ELEVATION = -500;
+
+bool
+ReachabilityComputer::Inputs::IsSimilar(const Inputs &other) const
+{
+  if (waypoints != other.waypoints ||
+      terrain_reach != other.terrain_reach ||
+      reach_enabled != other.reach_enabled ||
+      polar_mode != other.polar_mode ||
+      safety_height != other.safety_height ||
+      bugs != other.bugs || ballast != other.ballast ||
+      polar.a != other.polar.a || polar.b != other.polar.b ||
+      polar.c != other.polar.c || v_max != other.v_max ||
+      glide.predict_wind_drift != other.glide.predict_wind_drift)
+    return false;
+
+  if (fabs(mc - other.mc) >= MC_THRESHOLD ||
+      fabs(altitude - other.altitude) >= ALTITUDE_THRESHOLD ||
+      location.DistanceS(other.location) >= DISTANCE_THRESHOLD)
+    return false;
+
+  const auto wind_sc = wind.bearing.SinCos();
+  const auto other_sc = other.wind.bearing.SinCos();
+  return hypot(wind.norm * wind_sc.first - other.wind.norm * other_sc.first,
+               wind.norm * wind_sc.second - other.wind.norm * other_sc.second)
+    < WIND_THRESHOLD;
+}
+
+void
+ReachabilityComputer::Reset()
+{
+  last_valid = false;
+
+  watched.clear();
+  watched_valid = false;
+
+  items.clear();
+  Publish();
+}
+
+void
+ReachabilityComputer::Publish()
+{
+  {
+    ProtectedReachabilityCache::ExclusiveLease lease(protected_cache);
+    lease->Swap(items);
+  }
+
+  /* keep the old allocation for the next calculation */
+  items.clear();
+}
+
+void
+ReachabilityComputer::CollectCandidates(const Waypoints &waypoints,
+                                        const MoreData &basic,
+                                        const TaskBehaviour &task_behaviour,
+                                        const GlidePolar &glide_polar,
+                                        const SpeedVector wind)
+{
+  class LandableVisitor final : public WaypointVisitor {
+    std::vector<WaypointPtr> &list;
+
+  public:
+    explicit LandableVisitor(std::vector<WaypointPtr> &_list):list(_list) {}
+
+    void Visit(const WaypointPtr &wp) override {
+      /* watched waypoints have been added already */
+      if (wp->IsLandable() && !wp->flags.watched)
+        list.push_back(wp);
+    }
+  };
+
+  if (!watched_valid || watched_serial != waypoints.GetSerial()) {
+    watched.clear();
+    for (const auto &wp : waypoints)
+      if (wp->flags.watched)
+        watched.push_back(wp);
+
+    watched_serial = waypoints.GetSerial();
+    watched_valid = true;
+  }
+
+  /* watched waypoints show their arrival altitude even when it is
+     negative, so the range below does not apply to them */
+  candidates.assign(watched.begin(), watched.end());
+
+  const double height = basic.nav_altitude -
+    task_behaviour.safety_height_arrival - MIN_ELEVATION;
+  if (height <= 0)
+    return;
+
+  /* nothing beyond this distance can be reached: no speed covers
+     more ground per height than the best L/D plus the tail wind at
+     minimum sink */
+  const double max_ld = glide_polar.GetBestLD() +
+    wind.norm / glide_polar.GetSMin();
+
+  LandableVisitor visitor(candidates);
+  waypoints.VisitWithinRange(basic.location, height * max_ld, visitor);
+}
+
+void
+ReachabilityComputer::CalculateRoute(const RoutePlannerGlue &route_planner,
+                                     const TaskBehaviour &task_behaviour)
+{
+  for (const auto &wp : candidates) {
+    const double elevation = wp->elevation +
+      task_behaviour.safety_height_arrival;
+    const AGeoPoint p_dest(wp->location, elevation);
+
+    ReachabilityCache::Item item;
+    item.id = wp->id;
+    item.reach.Clear();
+    if (!route_planner.FindPositiveArrival(p_dest, item.reach))
+      continue;
+
+    item.reach.Subtract(elevation);
+
+    if (!item.reach.IsReachableDirect())
+      item.reachable = ReachabilityCache::Reachability::UNREACHABLE;
+    else if (task_behaviour.route_planner.IsReachEnabled() &&
+             !item.reach.IsReachableTerrain())
+      item.reachable = ReachabilityCache::Reachability::STRAIGHT;
+    else
+      item.reachable = ReachabilityCache::Reachability::TERRAIN;
+
+    items.push_back(item);
+  }
+}
+
+void
+ReachabilityComputer::CalculateDirect(const MoreData &basic,
+                                      const TaskBehaviour &task_behaviour,
+                                      const GlidePolar &glide_polar,
+                                      const SpeedVector wind)
+{
+  const unsigned n = candidates.size();
+  distance.GrowDiscard(n);
+  bearing.GrowDiscard(n);
+  altitude_difference.GrowDiscard(n);
+  arrival.GrowDiscard(n);
+  valid.GrowDiscard(n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const Waypoint &wp = *candidates[i];
+    const GeoVector vector(basic.location, wp.location);
+    distance[i] = vector.distance;
+    bearing[i] = vector.bearing;
+    altitude_difference[i] = basic.nav_altitude -
+      (wp.elevation + task_behaviour.safety_height_arrival);
+  }
+
+  /* solve all destinations in one batch */
+  const MacCready mac_cready(task_behaviour.glide, glide_polar);
+  mac_cready.SolveStraight(wind, n, distance.begin(), bearing.begin(),
+                           altitude_difference.begin(),
+                           arrival.begin(), valid.begin());
+
+  for (unsigned i = 0; i < n; ++i) {
+    if (!valid[i] || arrival[i] <= 0)
+      /* renderers treat all of these as "invalid" */
+      continue;
+
+    ReachabilityCache::Item item;
+    item.id = candidates[i]->id;
+    item.reachable = ReachabilityCache::Reachability::TERRAIN;
+    item.reach.Clear();
+    item.reach.direct = arrival[i];
+    items.push_back(item);
+  }
+}
+
+void
+ReachabilityComputer::Update(const Waypoints &waypoints,
+                             const MoreData &basic,
+                             const DerivedInfo &calculated,
+                             const TaskBehaviour &task_behaviour,
+                             const PolarSettings &polar_settings,
+                             const RoutePlannerGlue &route_planner)
+{
+  if (!basic.location_available || !basic.NavAltitudeAvailable()) {
+    if (last_valid)
+      Reset();
+    return;
+  }
+
+  const GlidePolar &glide_polar =
+    task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
+    ? polar_settings.glide_polar_task
+    : calculated.glide_polar_safety;
+
+  Inputs inputs;
+  inputs.location = basic.location;
+  inputs.altitude = basic.nav_altitude;
+  inputs.mc = glide_polar.GetMC();
+  inputs.bugs = glide_polar.GetBugs();
+  inputs.ballast = glide_polar.GetBallast();
+  inputs.polar = glide_polar.GetRealCoefficients();
+  inputs.v_max = glide_polar.IsValid() ? glide_polar.GetVMax() : 0;
+  inputs.glide = task_behaviour.glide;
+  inputs.wind = calculated.GetWindOrZero();
+  inputs.safety_height = task_behaviour.safety_height_arrival;
+  inputs.polar_mode = task_behaviour.route_planner.reach_polar_mode;
+  inputs.reach_enabled = task_behaviour.route_planner.IsReachEnabled();
+  inputs.terrain_reach = !route_planner.IsTerrainReachEmpty();
+  inputs.waypoints = waypoints.GetSerial();
+
+  if (last_valid && inputs.IsSimilar(last))
+    return;
+
+  last = inputs;
+  last_valid = true;
+
+  items.clear();
+
+  if (glide_polar.IsValid()) {
+    CollectCandidates(waypoints, basic, task_behaviour, glide_polar,
+                      inputs.wind);
+
+    if (inputs.terrain_reach)
+      CalculateRoute(route_planner, task_behaviour);
+    else
+      CalculateDirect(basic, task_behaviour, glide_polar, inputs.wind);
+  }
+
+  std::sort(items.begin(), items.end());
+  Publish();
+}
@@ -0,0 +1,174 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_REACHABILITY_COMPUTER_HPP
+#define XCSOAR_REACHABILITY_COMPUTER_HPP
+
+#include "ReachabilityCache.hpp"
+#include "Engine/Route/Config.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/PolarCoefficients.hpp"
+#include "Engine/Waypoint/Ptr.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Util/Serial.hpp"
+
+#include <vector>
+
+struct MoreData;
+struct DerivedInfo;
+struct TaskBehaviour;
+struct PolarSettings;
+class Waypoints;
+class GlidePolar;
+class RoutePlannerGlue;
+
+/**
+ * Calculates the arrival altitude of all landable waypoints within
+ * glide range and of all watched waypoints, for the map renderers.  This runs in
+ * the calculation thread, and only when the aircraft state, the polar
+ * or the wind has changed noticeably since the last time, so the
+ * renderers don't have to do it for each frame.
+ */
+class ReachabilityComputer {
+  /**
+   * Recalculate after the aircraft has moved this far (m).
+   */
+  static constexpr double DISTANCE_THRESHOLD = 100;
+
+  /**
+   * Recalculate after the altitude has changed this much (m).
+   */
+  static constexpr double ALTITUDE_THRESHOLD = 5;
+
+  /**
+   * Recalculate after the MacCready setting has changed this much
+   * (m/s).
+   */
+  static constexpr double MC_THRESHOLD = 0.05;
+
+  /**
+   * Recalculate after the wind has changed this much (m/s).
+   */
+  static constexpr double WIND_THRESHOLD = 0.5;
+
+  /**
+   * The parameters the cache was calculated with.
+   */
+  struct Inputs {
+    GeoPoint location;
+    double altitude;
+
+    double mc, bugs, ballast;
+
+    /**
+     * A fingerprint of the polar itself, which may be replaced
+     * without changing the MacCready, bugs or ballast settings.
+     */
+    PolarCoefficients polar;
+    double v_max;
+
+    GlideSettings glide;
+
+    SpeedVector wind;
+
+    double safety_height;
+    RoutePlannerConfig::Polar polar_mode;
+    bool reach_enabled;
+
+    /**
+     * Was the terrain reach of the route planner available?
+     */
+    bool terrain_reach;
+
+    Serial waypoints;
+
+    gcc_pure
+    bool IsSimilar(const Inputs &other) const;
+  };
+
+  ReachabilityCache cache;
+  ProtectedReachabilityCache protected_cache;
+
+  Inputs last;
+  bool last_valid;
+
+  /**
+   * The new cache contents while they are calculated.
+   */
+  std::vector<ReachabilityCache::Item> items;
+
+  /**
+   * The landable waypoints within glide range, and all watched
+   * waypoints.
+   */
+  std::vector<WaypointPtr> candidates;
+
+  /**
+   * All watched waypoints, which get an arrival altitude at any
+   * distance.  They are collected again when the serial of the
+   * #Waypoints changes.
+   */
+  std::vector<WaypointPtr> watched;
+  Serial watched_serial;
+  bool watched_valid;
+
+  AllocatedArray<double> distance, altitude_difference, arrival;
+  AllocatedArray<Angle> bearing;
+  AllocatedArray<bool> valid;
+
+public:
+  ReachabilityComputer()
+    :protected_cache(cache), last_valid(false), watched_valid(false) {}
+
+  const ProtectedReachabilityCache &GetProtectedCache() const {
+    return protected_cache;
+  }
+
+  void Reset();
+
+  void Update(const Waypoints &waypoints,
+              const MoreData &basic, const DerivedInfo &calculated,
+              const TaskBehaviour &task_behaviour,
+              const PolarSettings &polar_settings,
+              const RoutePlannerGlue &route_planner);
+
+private:
+  void Publish();
+
+  void CollectCandidates(const Waypoints &waypoints,
+                         const MoreData &basic,
+                         const TaskBehaviour &task_behaviour,
+                         const GlidePolar &glide_polar,
+                         const SpeedVector wind);
+
+  void CalculateRoute(const RoutePlannerGlue &route_planner,
+                      const TaskBehaviour &task_behaviour);
+
+  void CalculateDirect(const MoreData &basic,
+                       const TaskBehaviour &task_behaviour,
+                       const GlidePolar &glide_polar,
+                       const SpeedVector wind);
+};
+
+#endif
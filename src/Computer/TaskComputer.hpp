@@ -60,6 +60,14 @@ public:
     return task;
   }
 
+  /**
+   * Returns a reference to the unprotected route planner object,
+   * which must not be used outside of the calculation thread.
+   */
+  const RoutePlannerGlue &GetRoutePlanner() const {
+    return route.GetRoutePlanner();
+  }
+
   const ProtectedRoutePlanner &GetProtectedRoutePlanner() const {
     return route.GetProtectedRoutePlanner();
   }
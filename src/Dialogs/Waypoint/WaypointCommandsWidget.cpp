@@ -288,17 +288,17 @@ WaypointCommandsWidget::OnAction(int id)
         // TODO: refresh data instead of closing dialog?
         form->SetModalResult(mrOK);
 
+        try {
+          WaypointGlue::SaveReplacedWaypoint(*waypoint, wp_copy);
+        } catch (const std::runtime_error &e) {
+          ShowError(e, _("Failed to save waypoints"));
+        }
+
         {
           ScopeSuspendAllThreads suspend;
           way_points.Replace(waypoint, std::move(wp_copy));
           way_points.Optimise();
         }
-
-        try {
-          WaypointGlue::SaveWaypoints(way_points);
-        } catch (const std::runtime_error &e) {
-          ShowError(e, _("Failed to save waypoints"));
-        }
       }
     }
     break;
@@ -76,6 +76,12 @@ static constexpr unsigned distance_filter_items[] = {
   0, 25, 50, 75, 100, 150, 250, 500, 1000
 };
 
+/**
+ * The number of list items which are sorted by distance before the
+ * list is shown; the rest is sorted when it is scrolled into view.
+ */
+static constexpr unsigned SORT_AHEAD = 32;
+
 static constexpr int direction_filter_items[] = {
   -1, -1, 0, 30, 60, 90, 120, 150, 180, 210, 240, 270, 300, 330
 };
@@ -131,6 +137,14 @@ class WaypointListWidget final
 
   WaypointList items;
 
+  /**
+   * The filter #items was built with, if it holds all waypoints
+   * matching it.  A narrower filter is then applied to #items
+   * instead of the whole database.
+   */
+  WaypointFilter items_filter;
+  bool items_complete = false;
+
   TwoTextRowsRenderer row_renderer;
 
   const GeoPoint location;
@@ -155,10 +169,13 @@ public:
 
   void OnWaypointListEnter();
 
-  WaypointPtr GetCursorObject() const {
-    return items.empty()
-      ? nullptr
-      : items[GetList().GetCursorIndex()].waypoint;
+  WaypointPtr GetCursorObject() {
+    if (items.empty())
+      return nullptr;
+
+    const unsigned i = GetList().GetCursorIndex();
+    items.SortUpTo(i + 1);
+    return items[i].waypoint;
   }
 
   /* virtual methods from class Widget */
@@ -273,23 +290,44 @@ WaypointFilterWidget::Update(Angle _last_heading)
   direction_control.RefreshDisplay();
 }
 
-static void
+/**
+ * @param filter the filter the list was built with; updated
+ * @param complete does the list hold all waypoints matching #filter?
+ * @return true if the new list holds all waypoints matching the new
+ * #filter
+ */
+static bool
 FillList(WaypointList &list, const Waypoints &src,
          GeoPoint location, Angle heading, const WaypointListDialogState &state,
-         OrderedTask *ordered_task, unsigned ordered_task_index)
+         OrderedTask *ordered_task, unsigned ordered_task_index,
+         WaypointFilter &filter, bool complete)
 {
-  if (!state.IsDefined() && src.size() >= 500)
-    return;
-
-  WaypointFilter filter;
-  state.ToFilter(filter, heading);
+  WaypointFilter new_filter;
+  state.ToFilter(new_filter, heading);
 
-  WaypointListBuilder builder(filter, location, list,
+  WaypointListBuilder builder(new_filter, location, list,
                               ordered_task, ordered_task_index);
+
+  if (complete && new_filter.IsSubsetOf(filter)) {
+    /* another letter of the name was typed: filter the previous
+       result, which keeps its order */
+    builder.Narrow(list);
+    filter = new_filter;
+    return true;
+  }
+
+  list.clear();
+
+  if (!state.IsDefined() && src.size() >= 500)
+    return false;
+
   builder.Visit(src);
 
-  if (filter.distance > 0 || !filter.direction.IsNegative())
-    list.SortByDistance(location);
+  if (new_filter.distance > 0 || !new_filter.direction.IsNegative())
+    list.PartialSortByDistance(location, SORT_AHEAD);
+
+  filter = new_filter;
+  return true;
 }
 
 static void
@@ -309,15 +347,16 @@ FillLastUsedList(WaypointList &list,
 void
 WaypointListWidget::UpdateList()
 {
-  items.clear();
-
-  if (dialog_state.type_index == TypeFilter::LAST_USED)
+  if (dialog_state.type_index == TypeFilter::LAST_USED) {
+    items.clear();
+    items_complete = false;
     FillLastUsedList(items, LastUsedWaypoints::GetList(),
                      way_points);
-  else
-    FillList(items, way_points, location, last_heading,
-             dialog_state,
-             ordered_task, ordered_task_index);
+  } else
+    items_complete = FillList(items, way_points, location, last_heading,
+                              dialog_state,
+                              ordered_task, ordered_task_index,
+                              items_filter, items_complete);
 
   auto &list = GetList();
   list.SetLength(std::max(1u, (unsigned)items.size()));
@@ -460,6 +499,8 @@ WaypointListWidget::OnPaintItem(Canvas &canvas, const PixelRect rc,
 
   assert(i < items.size());
 
+  items.SortUpTo(i + SORT_AHEAD);
+
   const struct WaypointListItem &info = items[i];
 
   WaypointListRenderer::Draw(canvas, rc, *info.waypoint,
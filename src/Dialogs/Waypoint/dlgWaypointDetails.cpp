@@ -48,6 +48,7 @@ Copyright_License {
 #include "Compiler.h"
 #include "Language/Language.hpp"
 #include "Waypoint/LastUsed.hpp"
+#include "Waypoint/WaypointDetailsReader.hpp"
 #include "Profile/Current.hpp"
 #include "Profile/Map.hpp"
 #include "Profile/ProfileKeys.hpp"
@@ -64,11 +65,11 @@ Copyright_License {
 
 class WaypointExternalFileListHandler final
   : public ListItemRenderer, public ListCursorHandler {
-  const WaypointPtr waypoint;
+  const AirfieldDetails &details;
 
 public:
-  explicit WaypointExternalFileListHandler(WaypointPtr _waypoint)
-    :waypoint(std::move(_waypoint)) {}
+  explicit WaypointExternalFileListHandler(const AirfieldDetails &_details)
+    :details(_details) {}
 
   /* virtual methods from class ListItemRenderer */
   void OnPaintItem(Canvas &canvas, const PixelRect rc,
@@ -84,10 +85,9 @@ public:
 void
 WaypointExternalFileListHandler::OnActivateItem(unsigned i)
 {
-  auto file = waypoint->files_external.begin();
-  std::advance(file, i);
+  const auto &file = details.files_external[i];
 
-  RunFile(LocalPath(file->c_str()).c_str());
+  RunFile(LocalPath(file.c_str()).c_str());
 }
 
 void
@@ -95,11 +95,9 @@ WaypointExternalFileListHandler::OnPaintItem(Canvas &canvas,
                                              const PixelRect paint_rc,
                                              unsigned i)
 {
-  auto file = waypoint->files_external.begin();
-  std::advance(file, i);
   canvas.DrawText(paint_rc.left + Layout::GetTextPadding(),
                   paint_rc.top + Layout::GetTextPadding(),
-                  file->c_str());
+                  details.files_external[i].c_str());
 }
 #endif
 
@@ -126,7 +124,7 @@ class WaypointDetailsWidget final
     PixelRect file_list;
 #endif
 
-    explicit Layout(const PixelRect &rc, const Waypoint &waypoint);
+    explicit Layout(const PixelRect &rc, const AirfieldDetails &details);
   };
 
   WidgetDialog &dialog;
@@ -134,6 +132,13 @@ class WaypointDetailsWidget final
 
   const WaypointPtr waypoint;
 
+  /**
+   * The airfield details of #waypoint.  They are loaded into this
+   * copy and not into the waypoint, which is shared with other
+   * threads.
+   */
+  const AirfieldDetails &details;
+
   ProtectedTaskManager *const task_manager;
 
   Button goto_button;
@@ -162,15 +167,17 @@ class WaypointDetailsWidget final
 
 public:
   WaypointDetailsWidget(WidgetDialog &_dialog, WaypointPtr _waypoint,
+                        const AirfieldDetails &_details,
                         ProtectedTaskManager *_task_manager, bool allow_edit)
     :dialog(_dialog), look(dialog.GetLook()),
      waypoint(std::move(_waypoint)),
+     details(_details),
      task_manager(_task_manager),
      page(0), last_page(0),
      info_widget(look, waypoint),
      commands_widget(look, &_dialog, waypoint, _task_manager, allow_edit),
 #ifdef HAVE_RUN_FILE
-     file_list(look), file_list_handler(waypoint),
+     file_list(look), file_list_handler(details),
 #endif
      zoom(0) {}
 
@@ -199,7 +206,7 @@ public:
   void Unprepare() override;
 
   void Show(const PixelRect &rc) override {
-    const Layout layout(rc, *waypoint);
+    const Layout layout(rc, details);
 
     if (task_manager != nullptr)
       goto_button.MoveAndShow(layout.goto_button);
@@ -218,7 +225,7 @@ public:
     details_panel.Move(layout.main);
     details_text.Move(layout.details_text);
 #ifdef HAVE_RUN_FILE
-    if (!waypoint->files_external.empty())
+    if (!details.files_external.empty())
       file_list.Move(layout.file_list);
 #endif
 
@@ -253,7 +260,7 @@ public:
   }
 
   void Move(const PixelRect &rc) override {
-    const Layout layout(rc, *waypoint);
+    const Layout layout(rc, details);
 
     if (task_manager != nullptr)
       goto_button.Move(layout.goto_button);
@@ -272,7 +279,7 @@ public:
     details_panel.Move(layout.main);
     details_text.Move(layout.details_text);
 #ifdef HAVE_RUN_FILE
-    if (!waypoint->files_external.empty())
+    if (!details.files_external.empty())
       file_list.Move(layout.file_list);
 #endif
     commands_dock.Move(layout.main);
@@ -319,7 +326,7 @@ private:
 };
 
 WaypointDetailsWidget::Layout::Layout(const PixelRect &rc,
-                                      const Waypoint &waypoint)
+                                      const AirfieldDetails &details)
 {
   const unsigned width = rc.GetWidth(), height = rc.GetHeight();
   const unsigned button_height = ::Layout::GetMaximumControlHeight();
@@ -389,8 +396,7 @@ WaypointDetailsWidget::Layout::Layout(const PixelRect &rc,
   details_text.bottom = main.GetHeight();
 
 #ifdef HAVE_RUN_FILE
-  const unsigned num_files = std::distance(waypoint.files_external.begin(),
-                                           waypoint.files_external.end());
+  const unsigned num_files = details.files_external.size();
   if (num_files > 0) {
     file_list_item_height = ::Layout::Scale(18);
     file_list = details_text;
@@ -404,7 +410,7 @@ WaypointDetailsWidget::Layout::Layout(const PixelRect &rc,
 void
 WaypointDetailsWidget::Prepare(ContainerWindow &parent, const PixelRect &rc)
 {
-  for (const auto &i : waypoint->files_embed) {
+  for (const auto &i : details.files_embed) {
     if (images.full())
       break;
 
@@ -419,7 +425,7 @@ WaypointDetailsWidget::Prepare(ContainerWindow &parent, const PixelRect &rc)
     }
   }
 
-  const Layout layout(rc, *waypoint);
+  const Layout layout(rc, details);
 
   WindowStyle dock_style;
   dock_style.Hide();
@@ -458,11 +464,10 @@ WaypointDetailsWidget::Prepare(ContainerWindow &parent, const PixelRect &rc)
   details_panel.Create(parent, look, layout.main, dock_style);
   details_text.Create(details_panel, layout.details_text);
   details_text.SetFont(look.text_font);
-  details_text.SetText(waypoint->details.c_str());
+  details_text.SetText(details.details.c_str());
 
 #ifdef HAVE_RUN_FILE
-  const unsigned num_files = std::distance(waypoint->files_external.begin(),
-                                           waypoint->files_external.end());
+  const unsigned num_files = details.files_external.size();
   if (num_files > 0) {
     file_list.Create(details_panel, layout.file_list,
                      WindowStyle(), layout.file_list_item_height);
@@ -527,9 +532,9 @@ WaypointDetailsWidget::NextPage(int step)
     // skip wDetails frame, if there are no details
   } while (page == 1 &&
 #ifdef HAVE_RUN_FILE
-           waypoint->files_external.empty() &&
+           details.files_external.empty() &&
 #endif
-           waypoint->details.empty());
+           details.details.empty());
 
   UpdatePage();
 
@@ -687,9 +692,16 @@ dlgWaypointDetailsShowModal(WaypointPtr _waypoint,
 {
   LastUsedWaypoints::Add(*_waypoint);
 
+  /* the airfield details file has only been indexed at startup;
+     if it could not be indexed, it has been loaded into the
+     waypoints */
+  AirfieldDetails details;
+  if (!WaypointDetails::LoadFromProfile(*_waypoint, details))
+    details = AirfieldDetails(*_waypoint);
+
   const DialogLook &look = UIGlobals::GetDialogLook();
   WidgetDialog dialog(look);
-  WaypointDetailsWidget widget(dialog, _waypoint,
+  WaypointDetailsWidget widget(dialog, _waypoint, details,
                                allow_navigation ? protected_task_manager : nullptr,
                                allow_edit);
   dialog.CreateFull(UIGlobals::GetMainWindow(), _T(""), &widget);
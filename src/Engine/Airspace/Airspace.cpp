@@ -23,6 +23,72 @@
 #include "Airspace.hpp"
 #include "AbstractAirspace.hpp"
 #include "AirspaceIntersectionVector.hpp"
+#include "Atmosphere/Pressure.hpp"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * The QNH range for which the altitude bounds of flight level
+ * boundaries are calculated.  This covers the lowest and highest
+ * pressures ever recorded at sea level.
+ */
+static constexpr auto min_qnh = AtmosphericPressure::HectoPascal(850);
+static constexpr auto max_qnh = AtmosphericPressure::HectoPascal(1100);
+
+static constexpr double fl_feet_to_m(30.48);
+
+/**
+ * Returns the lowest altitude (m AMSL) this boundary can resolve to.
+ */
+gcc_pure
+static double
+GetLowestAltitude(const AirspaceAltitude &altitude)
+{
+  switch (altitude.reference) {
+  case AltitudeReference::NONE:
+  case AltitudeReference::AGL:
+    /* depends on the terrain below the aircraft */
+    return std::numeric_limits<double>::lowest();
+
+  case AltitudeReference::MSL:
+    return altitude.altitude;
+
+  case AltitudeReference::STD:
+    return std::min(min_qnh.PressureAltitudeToQNHAltitude(altitude.flight_level
+                                                          * fl_feet_to_m),
+                    max_qnh.PressureAltitudeToQNHAltitude(altitude.flight_level
+                                                          * fl_feet_to_m));
+  }
+
+  gcc_unreachable();
+}
+
+/**
+ * Returns the highest altitude (m AMSL) this boundary can resolve to.
+ */
+gcc_pure
+static double
+GetHighestAltitude(const AirspaceAltitude &altitude)
+{
+  switch (altitude.reference) {
+  case AltitudeReference::NONE:
+  case AltitudeReference::AGL:
+    /* depends on the terrain below the aircraft */
+    return std::numeric_limits<double>::max();
+
+  case AltitudeReference::MSL:
+    return altitude.altitude;
+
+  case AltitudeReference::STD:
+    return std::max(min_qnh.PressureAltitudeToQNHAltitude(altitude.flight_level
+                                                          * fl_feet_to_m),
+                    max_qnh.PressureAltitudeToQNHAltitude(altitude.flight_level
+                                                          * fl_feet_to_m));
+  }
+
+  gcc_unreachable();
+}
 
 void
 Airspace::Destroy()
@@ -33,7 +99,9 @@ Airspace::Destroy()
 Airspace::Airspace(AbstractAirspace &airspace,
                    const FlatProjection &tp)
   :FlatBoundingBox(airspace.GetBoundingBox(tp)),
-   airspace(&airspace)
+   airspace(&airspace),
+   altitude_min(GetLowestAltitude(airspace.GetBase())),
+   altitude_max(GetHighestAltitude(airspace.GetTop()))
 {
 }
 
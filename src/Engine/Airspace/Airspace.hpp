@@ -50,6 +50,15 @@ class Airspace final : public FlatBoundingBox
 {
   AbstractAirspace *airspace;
 
+  /**
+   * Conservative bounds (m AMSL) of the vertical extent of the
+   * airspace.  They do not depend on QNH (within plausible limits)
+   * or on the terrain, so they remain valid for the lifetime of this
+   * envelope and can be used to reject airspaces from a search
+   * without looking at the #AbstractAirspace.
+   */
+  double altitude_min, altitude_max;
+
 public:
 
   /**
@@ -63,6 +72,19 @@ public:
   Airspace(AbstractAirspace &airspace,
            const FlatProjection &projection);
 
+  /**
+   * Checks whether the conservative vertical extent of this airspace
+   * overlaps the specified altitude range.  If this returns false,
+   * the airspace is certainly outside the range; if it returns true,
+   * the caller still has to check the actual altitudes.
+   *
+   * @param min Lower bound of the altitude range (m AMSL)
+   * @param max Upper bound of the altitude range (m AMSL)
+   */
+  constexpr bool IntersectsAltitude(double min, double max) const {
+    return altitude_max >= min && altitude_min <= max;
+  }
+
   /**
    * Checks whether an aircraft is inside the airspace.
    *
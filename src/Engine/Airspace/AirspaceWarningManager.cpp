@@ -28,6 +28,8 @@
 #include "AirspaceAircraftPerformance.hpp"
 #include "Task/Stats/TaskStats.hpp"
 
+#include <limits>
+
 #define CRUISE_FILTER_FACT 0.5
 
 AirspaceWarningManager::AirspaceWarningManager(const AirspaceWarningConfig &_config,
@@ -299,11 +301,22 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
                                              warning_state, max_time_limit,
                                              ceiling);
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  /* airspaces with a base above the ceiling are excluded by the
+     visitor anyway; let the airspace index skip them before the
+     intersections are calculated */
+  const auto max_alt = ceiling > 0
+    ? ceiling
+    : std::numeric_limits<double>::max();
+
+  airspaces.VisitIntersecting(state.location, location_predicted, false,
+                              std::numeric_limits<double>::lowest(), max_alt,
+                              visitor);
 
   visitor.SetMode(true);
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
+  for (const auto &i : airspaces.QueryInside(state.location,
+                                             std::numeric_limits<double>::lowest(),
+                                             max_alt)) {
     const AbstractAirspace &airspace = i.GetAirspace();
     visitor.Visit(airspace);
   }
@@ -394,7 +407,8 @@ AirspaceWarningManager::UpdateInside(const AircraftState& state,
 
   bool found = false;
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
+  for (const auto &i : airspaces.QueryInside(state.location,
+                                             state.altitude, state.altitude)) {
     const AbstractAirspace &airspace = i.GetAirspace();
 
     const AltitudeState &altitude = state;
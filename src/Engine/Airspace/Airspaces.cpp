@@ -30,6 +30,8 @@
 #include <boost/geometry/algorithms/intersection.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 
+#include <limits>
+
 namespace bgi = boost::geometry::index;
 
 Airspaces::const_iterator_range
@@ -43,6 +45,25 @@ Airspaces::QueryWithinRange(const GeoPoint &location, double range) const
   return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryWithinRange(const GeoPoint &location, double range,
+                            double altitude_min, double altitude_max) const
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  const FlatBoundingBox box = task_projection.ProjectSquare(location, range);
+  const auto _begin =
+    airspace_tree.qbegin(bgi::intersects(box) &&
+                         bgi::satisfies([altitude_min, altitude_max](const Airspace &as){
+                             return as.IntersectsAltitude(altitude_min,
+                                                          altitude_max);
+                           }));
+
+  return {_begin, airspace_tree.qend()};
+}
+
 Airspaces::const_iterator_range
 Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const
 {
@@ -58,17 +79,52 @@ Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const
   return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b,
+                             double altitude_min, double altitude_max) const
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  // TODO: use StaticArray instead of std::vector
+  boost::geometry::model::linestring<FlatGeoPoint> line;
+  line.push_back(task_projection.ProjectInteger(a));
+  line.push_back(task_projection.ProjectInteger(b));
+
+  const auto _begin =
+    airspace_tree.qbegin(bgi::intersects(line) &&
+                         bgi::satisfies([altitude_min, altitude_max](const Airspace &as){
+                             return as.IntersectsAltitude(altitude_min,
+                                                          altitude_max);
+                           }));
+
+  return {_begin, airspace_tree.qend()};
+}
+
+void
+Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
+                             bool include_inside,
+                             AirspaceIntersectionVisitor &visitor) const
+{
+  VisitIntersecting(loc, end, include_inside,
+                    std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::max(),
+                    visitor);
+}
+
 void
 Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
                              bool include_inside,
+                             double altitude_min, double altitude_max,
                              AirspaceIntersectionVisitor &visitor) const
 {
-  for (const auto &i : QueryIntersecting(loc, end))
+  for (const auto &i : QueryIntersecting(loc, end, altitude_min, altitude_max))
     if (visitor.SetIntersections(i.Intersects(loc, end, task_projection)))
       visitor.Visit(i.GetAirspace());
 
   if (include_inside) {
-    for (const auto &i : QueryInside(loc)) {
+    for (const auto &i : QueryInside(loc, altitude_min, altitude_max)) {
       if (i.IsInside(end)) {
         /* the vector is completely inside the airspace, and thus does
            not intersect with airspace's outline: on caller's request,
@@ -159,6 +215,8 @@ Airspaces::Clear()
 
   // then delete the tree
   airspace_tree.clear();
+
+  ++serial;
 }
 
 unsigned
@@ -279,6 +337,28 @@ Airspaces::QueryInside(const GeoPoint &loc) const
   return {_begin, airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryInside(const GeoPoint &loc,
+                       double altitude_min, double altitude_max) const
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  const auto flat_location = task_projection.ProjectInteger(loc);
+  const FlatBoundingBox box(flat_location, flat_location);
+
+  const auto _begin =
+    airspace_tree.qbegin(bgi::intersects(box) &&
+                         bgi::satisfies([&loc, altitude_min, altitude_max](const Airspace &as){
+                             return as.IntersectsAltitude(altitude_min,
+                                                          altitude_max) &&
+                               as.IsInside(loc);
+                           }));
+
+  return {_begin, airspace_tree.qend()};
+}
+
 Airspaces::const_iterator_range
 Airspaces::QueryInside(const AircraftState &aircraft) const
 {
@@ -292,7 +372,9 @@ Airspaces::QueryInside(const AircraftState &aircraft) const
   const auto _begin =
     airspace_tree.qbegin(bgi::intersects(box) &&
                          bgi::satisfies([&aircraft](const Airspace &as){
-                             return as.IsInside(aircraft);
+                             return as.IntersectsAltitude(aircraft.altitude,
+                                                          aircraft.altitude) &&
+                               as.IsInside(aircraft);
                            }));
 
   return {_begin, airspace_tree.qend()};
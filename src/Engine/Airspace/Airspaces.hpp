@@ -33,6 +33,7 @@
 #include <deque>
 
 class RasterTerrain;
+class RasterMap;
 class AirspaceIntersectionVisitor;
 class AirspacePredicate;
 
@@ -57,6 +58,14 @@ class Airspaces : public AirspacesInterface {
    */
   Serial serial;
 
+  /**
+   * The #serial and the terrain serial of the last SetGroundLevels()
+   * call.  Used to skip the terrain lookups if neither the airspaces
+   * nor the terrain have changed since.
+   */
+  Serial ground_level_serial, ground_level_terrain_serial;
+  bool ground_levels_valid = false;
+
 public:
   /**
    * Constructor.
@@ -123,12 +132,20 @@ public:
   bool IsEmpty() const;
 
   /**
-   * Set terrain altitude for all AGL-referenced airspace altitudes
+   * Set terrain altitude for all AGL-referenced airspace altitudes.
+   * Doesn't do anything if neither the airspaces nor the terrain
+   * have changed since the last call.
    *
    * @param terrain Terrain model for lookup
    */
   void SetGroundLevels(const RasterTerrain &terrain);
 
+  /**
+   * Same as SetGroundLevels(const RasterTerrain &), but the caller
+   * holds the lock on the #RasterMap.
+   */
+  void SetGroundLevels(const RasterMap &map);
+
   /**
    * Set QNH pressure for all FL-referenced airspace altitudes.
    * Doesn't do anything if QNH is unchanged
@@ -162,6 +179,23 @@ public:
   const_iterator_range QueryWithinRange(const GeoPoint &location,
                                         double range) const;
 
+  /**
+   * Query airspaces within range of location which may overlap the
+   * specified altitude range.  Airspaces which are certainly outside
+   * the altitude range are skipped inside the index; the caller
+   * still needs to check the exact altitudes of the results.
+   *
+   * @param loc location of origin of search
+   * @param range distance in meters of search radius
+   * @param altitude_min lower bound of the altitude range (m AMSL)
+   * @param altitude_max upper bound of the altitude range (m AMSL)
+   */
+  gcc_pure
+  const_iterator_range QueryWithinRange(const GeoPoint &location,
+                                        double range,
+                                        double altitude_min,
+                                        double altitude_max) const;
+
   /**
    * Query airspaces intersecting the vector (bounding box check
    * only).  The result is in no specific order.
@@ -170,6 +204,16 @@ public:
   const_iterator_range QueryIntersecting(const GeoPoint &a,
                                          const GeoPoint &b) const;
 
+  /**
+   * Like QueryIntersecting(), but skip airspaces which are certainly
+   * outside the specified altitude range (m AMSL).
+   */
+  gcc_pure
+  const_iterator_range QueryIntersecting(const GeoPoint &a,
+                                         const GeoPoint &b,
+                                         double altitude_min,
+                                         double altitude_max) const;
+
   /**
    * Call visitor class on airspaces intersected by vector.
    * Note that the visitor is not instantiated separately for each match
@@ -189,6 +233,16 @@ public:
     VisitIntersecting(location, end, false, visitor);
   }
 
+  /**
+   * Like VisitIntersecting(), but airspaces which are certainly
+   * outside the specified altitude range (m AMSL) are skipped before
+   * the intersections are calculated.
+   */
+  void VisitIntersecting(const GeoPoint &location, const GeoPoint &end,
+                         bool include_inside,
+                         double altitude_min, double altitude_max,
+                         AirspaceIntersectionVisitor &visitor) const;
+
   /**
    * Query airspaces this location is inside.
    *
@@ -197,6 +251,16 @@ public:
   gcc_pure
   const_iterator_range QueryInside(const GeoPoint &location) const;
 
+  /**
+   * Query airspaces this location is inside, skipping those which
+   * are certainly outside the specified altitude range (m AMSL)
+   * before testing the lateral boundary.
+   */
+  gcc_pure
+  const_iterator_range QueryInside(const GeoPoint &location,
+                                   double altitude_min,
+                                   double altitude_max) const;
+
   /**
    * Query airspaces the aircraft is inside (taking altitude into
    * account).
@@ -26,14 +26,32 @@
 void 
 Airspaces::SetGroundLevels(const RasterTerrain &terrain)
 {
-  for (auto &v : QueryAll()) {
+  /* the terrain serial must be read under the lock, because the
+     terrain may be loading tiles at the same time */
+  RasterTerrain::Lease lease(terrain);
+  const RasterMap &map = lease;
+  SetGroundLevels(map);
+}
+
+void
+Airspaces::SetGroundLevels(const RasterMap &map)
+{
+  if (ground_levels_valid && ground_level_serial == serial &&
+      ground_level_terrain_serial == map.GetSerial())
+    /* the results of the previous call are still attached to the
+       airspaces */
+    return;
+
+  for (const auto &v : QueryAll()) {
     // If we don't need the ground level we don't have to calculate it
     if (!v.NeedGroundLevel())
       continue;
 
-    FlatGeoPoint c_flat = v.GetCenter();
-    GeoPoint g = task_projection.Unproject(c_flat);
-    v.SetGroundLevel(terrain.GetTerrainHeight(g).GetValueOr0());
+    const GeoPoint location = task_projection.Unproject(v.GetCenter());
+    v.SetGroundLevel(map.GetHeight(location).GetValueOr0());
   }
-}
 
+  ground_level_serial = serial;
+  ground_level_terrain_serial = map.GetSerial();
+  ground_levels_valid = true;
+}
@@ -261,6 +261,7 @@ GlidePolar::IsGlidePossible(const GlideState &task) const
   return true;
 }
 
+#if 0
 /**
  * Finds speed to fly for a given MacCready setting
  * Intended to be used temporarily.
@@ -318,13 +319,29 @@ public:
     return Vopt + m_head_wind;
   }
 };
+#endif
 
 double
 GlidePolar::SpeedToFly(const double stf_sink_rate, const double head_wind) const
 {
   assert(IsValid());
+
+#if 0
+  // this method to be used if polar is not parabolic
   GlidePolarSpeedToFly gp_stf(*this, stf_sink_rate, head_wind, Vmin, Vmax);
   return gp_stf.solve(Vmax);
+#else
+  /* minimise (MSinkRate(V) + stf_sink_rate) / (V - head_wind); its
+     derivative vanishes where a*V^2 - 2*a*h*V - (b*h + c + mc + s)
+     = 0, and the larger root is the minimum */
+  const auto k = polar.c + mc + stf_sink_rate;
+  const auto d = Square(head_wind) + (polar.b * head_wind + k) / polar.a;
+  const auto v = head_wind + sqrt(std::max(d, 0.));
+
+  /* same search range as the iterative solver */
+  const auto v_lower = std::max(1., Vmin - head_wind) + head_wind;
+  return Clamp(v, v_lower, std::max(v_lower, Vmax));
+#endif
 }
 
 double
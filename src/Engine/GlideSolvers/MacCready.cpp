@@ -25,7 +25,11 @@
 #include "GlidePolar.hpp"
 #include "GlideResult.hpp"
 #include "Math/ZeroFinder.hpp"
+#include "Math/Util.hpp"
 #include "Util/Tolerances.hpp"
+#include "Util/Clamp.hpp"
+
+#include <algorithm>
 
 #include <assert.h>
 
@@ -380,6 +384,71 @@ public:
   }
 };
 
+/**
+ * Calculate the ground speed like GlideState::CalcAverageSpeed(), but
+ * from scalars.
+ *
+ * @return Ground speed (m/s), or a negative value if the wind is
+ * excessive
+ */
+gcc_const
+static inline double
+CalcGroundSpeed(const double head_wind, const double wind_speed_squared,
+                const double v_eff)
+{
+  const auto d = Square(head_wind) - wind_speed_squared + Square(v_eff);
+  return d >= 0
+    ? sqrt(d) - head_wind
+    : -1;
+}
+
+/**
+ * Calculate the cruise speed which minimises the glide angle over
+ * ground at MC=0.  For a parabolic polar (a, b, c) and a ground speed
+ * which is linear in the air speed (g*V - h), minimising
+ * SinkRate(V) / (g*V - h) has a closed-form solution.  This is exact
+ * for a pure head or tail wind; with cross wind, the ground speed is
+ * replaced by its tangent at the previous estimate until the estimate
+ * converges, which is then the true optimum.
+ *
+ * @param task_head_wind Head wind component (m/s)
+ * @param wind_speed Wind speed (m/s)
+ * @return Initial speed for the #MacCreadyVopt search (m/s)
+ */
+gcc_pure
+static double
+EstimateGlideSpeed(const GlidePolar &glide_polar, const double task_head_wind,
+                   const double wind_speed, const double cruise_efficiency)
+{
+  const auto polar = glide_polar.GetRealCoefficients();
+  const auto e = cruise_efficiency;
+  const auto wind_speed_squared = Square(wind_speed);
+  const bool cross_wind = Square(task_head_wind) < wind_speed_squared;
+
+  auto slope = e;
+  auto head_wind = task_head_wind;
+  double v = glide_polar.GetVBestLD();
+  for (unsigned i = 0; i < 8; ++i) {
+    const auto d = Square(head_wind)
+      + slope * (polar.b * head_wind + polar.c * slope) / polar.a;
+    const auto v_previous = v;
+    v = (head_wind + sqrt(std::max(d, 0.))) / slope;
+
+    if (!cross_wind || fabs(v - v_previous) < 0.01)
+      break;
+
+    const auto ground_speed =
+      CalcGroundSpeed(task_head_wind, wind_speed_squared, v * e);
+    if (ground_speed <= 0)
+      break;
+
+    slope = Square(e) * v / (ground_speed + task_head_wind);
+    head_wind = slope * v - ground_speed;
+  }
+
+  return Clamp(v, glide_polar.GetVMin(), glide_polar.GetVMax());
+}
+
 GlideResult
 MacCready::OptimiseGlide(const GlideState &task, const bool allow_partial) const
 {
@@ -389,7 +458,76 @@ MacCready::OptimiseGlide(const GlideState &task, const bool allow_partial) const
                        glide_polar.GetVMin(), glide_polar.GetVMax(),
                        allow_partial);
 
-  return mc_vopt.Result(glide_polar.GetVMin());
+  /* starting at the analytic solution lets ZeroFinder skip the search
+     after verifying that it is within tolerance */
+  return mc_vopt.Result(EstimateGlideSpeed(glide_polar, task.head_wind,
+                                           task.wind.norm,
+                                           cruise_efficiency));
+}
+
+void
+MacCready::SolveStraight(const SpeedVector wind, const unsigned n,
+                         const double *distance, const Angle *bearing,
+                         const double *altitude_difference,
+                         double *arrival, bool *valid) const
+{
+  if (!glide_polar.IsValid()) {
+    std::fill_n(valid, n, false);
+    return;
+  }
+
+  const auto e = cruise_efficiency;
+
+  if (wind.IsZero() && std::all_of(distance, distance + n,
+                                   [](double d){ return d > 0; })) {
+    /* without wind, the glide ratio over ground is the same for all
+       destinations (at MC=0, VBestLD is also the speed of the optimal
+       glide), which leaves a branch-free loop the compiler can
+       vectorise */
+    const auto inv_ld = glide_polar.GetSBestLD()
+      / (glide_polar.GetVBestLD() * e);
+
+    for (unsigned i = 0; i < n; ++i)
+      arrival[i] = altitude_difference[i] - distance[i] * inv_ld;
+
+    std::fill_n(valid, n, true);
+    return;
+  }
+
+  const bool optimise = glide_polar.GetMC() <= 0;
+  const auto wind_reciprocal = wind.bearing.Reciprocal();
+  const auto wind_speed_squared = Square(wind.norm);
+
+  for (unsigned i = 0; i < n; ++i) {
+    if (distance[i] <= 0) {
+      /* rare: needs the climb solution from SolveVertical() */
+      const GlideState task(GeoVector(0, bearing[i]), 0,
+                            altitude_difference[i], wind);
+      const GlideResult result = SolveStraight(task);
+      arrival[i] = result.pure_glide_altitude_difference;
+      valid[i] = result.IsOk();
+      continue;
+    }
+
+    const auto head_wind = wind.IsNonZero()
+      ? -wind.norm * (wind_reciprocal - bearing[i]).cos()
+      : 0.;
+
+    const auto v = optimise
+      ? EstimateGlideSpeed(glide_polar, head_wind, wind.norm, e)
+      : glide_polar.GetVBestLD();
+    const auto sink_rate = optimise
+      ? glide_polar.SinkRate(v)
+      : glide_polar.GetSBestLD();
+
+    const auto ground_speed =
+      CalcGroundSpeed(head_wind, wind_speed_squared, v * e);
+
+    valid[i] = ground_speed > 0;
+    arrival[i] = valid[i]
+      ? altitude_difference[i] - distance[i] * sink_rate / ground_speed
+      : altitude_difference[i];
+  }
 }
 
 /*
@@ -28,6 +28,8 @@ struct GlideSettings;
 struct GlideState;
 struct GlideResult;
 class GlidePolar;
+struct SpeedVector;
+class Angle;
 
 /**
  *  Helper class used to calculate times/speeds and altitude differences
@@ -87,6 +89,30 @@ public:
   gcc_pure
   GlideResult SolveStraight(const GlideState &task) const;
 
+  /**
+   * Calculate the arrival altitude of many destinations at once,
+   * which share one wind vector.  This is equivalent to calling
+   * SolveStraight() for each destination and reading
+   * GlideResult::pure_glide_altitude_difference, but avoids
+   * constructing a #GlideState and a #GlideResult per destination.
+   * Input and output are parallel arrays.
+   *
+   * @param wind the wind vector
+   * @param n the number of destinations
+   * @param distance distance to each destination (m)
+   * @param bearing bearing to each destination
+   * @param altitude_difference aircraft altitude above each
+   * destination's minimum arrival altitude (m)
+   * @param arrival receives the altitude above the minimum arrival
+   * altitude at each destination (m)
+   * @param valid receives whether a glide solution exists for each
+   * destination
+   */
+  void SolveStraight(SpeedVector wind, unsigned n,
+                     const double *distance, const Angle *bearing,
+                     const double *altitude_difference,
+                     double *arrival, bool *valid) const;
+
   /** 
    * Calculates the glide solution for a classical MacCready theory task.
    * Internally different calculations are used depending on the nature of the
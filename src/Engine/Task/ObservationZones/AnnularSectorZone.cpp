@@ -29,28 +29,34 @@ AnnularSectorZone::GetBoundary() const
 {
   OZBoundary boundary;
 
-  const unsigned steps = 20;
-  const Angle delta = Angle::FullCircle() / steps;
+  const Angle delta = Angle::FullCircle() / OZBoundary::ARC_STEPS;
   const Angle start = GetStartRadial().AsBearing();
   Angle end = GetEndRadial().AsBearing();
   if (end <= start + Angle::FullCircle() / 512)
     end += Angle::FullCircle();
 
+  boundary.arcs.push_front({GetReference(), GetInnerRadius(),
+                            start, end - start});
+  boundary.arcs.push_front({GetReference(), GetRadius(), start, end - start});
+
   const GeoPoint inner_start =
     GeoVector(GetInnerRadius(), GetStartRadial()).EndPoint(GetReference());
   const GeoPoint inner_end =
     GeoVector(GetInnerRadius(), GetEndRadial()).EndPoint(GetReference());
 
   GeoVector inner_vector(GetInnerRadius(), start + delta);
-  for (; inner_vector.bearing < end; inner_vector.bearing += delta)
-    boundary.push_front(inner_vector.EndPoint(GetReference()));
+  for (unsigned i = 1; inner_vector.bearing < end;
+       ++i, inner_vector.bearing += delta)
+    boundary.PushArcPoint(inner_vector.EndPoint(GetReference()), i,
+                          inner_vector.bearing + delta >= end);
 
   boundary.push_front(inner_end);
   boundary.push_front(inner_start);
 
   GeoVector vector(GetRadius(), start + delta);
-  for (; vector.bearing < end; vector.bearing += delta)
-    boundary.push_front(vector.EndPoint(GetReference()));
+  for (unsigned i = 1; vector.bearing < end; ++i, vector.bearing += delta)
+    boundary.PushArcPoint(vector.EndPoint(GetReference()), i,
+                          vector.bearing + delta >= end);
 
   boundary.push_front(GetSectorEnd());
   boundary.push_front(GetSectorStart());
@@ -24,18 +24,46 @@
 #include "Boundary.hpp"
 #include "Geo/GeoVector.hpp"
 
+#include <math.h>
+
+bool
+OZBoundary::Arc::IsOnArc(const GeoPoint &location) const
+{
+  const GeoVector vector(center, location);
+  return fabs(vector.distance - radius) < 1 && IsWithin(vector.bearing);
+}
+
+GeoPoint
+OZBoundary::Arc::GetPoint(Angle bearing) const
+{
+  return GeoVector(radius, bearing).EndPoint(center);
+}
+
 void
 OZBoundary::GenerateArcExcluding(const GeoPoint &center, double radius,
                                  Angle start_radial, Angle end_radial)
 {
-  const unsigned steps = 20;
-  const Angle delta = Angle::FullCircle() / steps;
+  const Angle delta = Angle::FullCircle() / ARC_STEPS;
   const Angle start = start_radial.AsBearing();
   Angle end = end_radial.AsBearing();
   if (end <= start + Angle::FullCircle() / 512)
     end += Angle::FullCircle();
 
+  arcs.push_front({center, radius, start, end - start});
+
   GeoVector vector(radius, start + delta);
-  for (; vector.bearing < end; vector.bearing += delta)
-    push_front(vector.EndPoint(center));
+  for (unsigned i = 1; vector.bearing < end; ++i, vector.bearing += delta)
+    PushArcPoint(vector.EndPoint(center), i, vector.bearing + delta >= end);
+}
+
+void
+OZBoundary::GenerateCircle(const GeoPoint &center, double radius)
+{
+  const auto delta = Angle::FullCircle() / ARC_STEPS;
+
+  arcs.push_front({center, radius, Angle::Zero(), Angle::FullCircle()});
+
+  GeoVector vector(radius, Angle::Zero());
+  for (unsigned i = 0; i < ARC_STEPS; ++i, vector.bearing += delta)
+    PushArcPoint(vector.EndPoint(center), i, false);
 }
@@ -25,17 +25,92 @@
 #define XCSOAR_OBSERVATION_ZONE_BOUNDARY_HPP
 
 #include "Geo/GeoPoint.hpp"
+#include "Compiler.h"
 
 #include <forward_list>
 
 class OZBoundary : public std::forward_list<GeoPoint> {
 public:
+  /**
+   * An arc of the boundary.  Its points are only a coarse
+   * approximation; the task search refines its solution along the
+   * arc.
+   */
+  struct Arc {
+    GeoPoint center;
+    double radius;
+
+    /** the arc goes clockwise from this bearing ... */
+    Angle start;
+
+    /** ... by this angle (up to a full circle) */
+    Angle sweep;
+
+    /**
+     * Does the given point lie on this arc?
+     */
+    gcc_pure
+    bool IsOnArc(const GeoPoint &location) const;
+
+    /**
+     * Is the given bearing (from #center) within the arc?
+     */
+    gcc_pure
+    bool IsWithin(Angle bearing) const {
+      return (bearing - start).AsBearing() <= sweep;
+    }
+
+    gcc_pure
+    GeoPoint GetPoint(Angle bearing) const;
+  };
+
+  /**
+   * The number of points used to approximate a full circle.
+   */
+  static constexpr unsigned ARC_STEPS = 20;
+
+  /**
+   * The number of points per full circle which the task search
+   * starts with.  Only every (ARC_STEPS / SEARCH_STEPS)th arc point
+   * is used; the solution is then refined along the arcs.
+   */
+  static constexpr unsigned SEARCH_STEPS = 10;
+
+  static_assert(ARC_STEPS % SEARCH_STEPS == 0,
+                "SEARCH_STEPS must divide ARC_STEPS");
+
+  std::forward_list<Arc> arcs;
+
+  /**
+   * The arc points which the task search skips (see #SEARCH_STEPS),
+   * in the same order as in this list.
+   */
+  std::forward_list<GeoPoint> skipped;
+
+  /**
+   * Add a point of an arc.
+   *
+   * @param step the index of the point, counted from the start of
+   * the arc
+   * @param last is this the last point before the end of the arc?
+   */
+  void PushArcPoint(const GeoPoint &location, unsigned step, bool last) {
+    push_front(location);
+    if (step % (ARC_STEPS / SEARCH_STEPS) != 0 && !last)
+      skipped.push_front(location);
+  }
+
   /**
    * Generate boundary points for the arc described by the parameters.
    * This excludes the points at the start/end angle.
    */
   void GenerateArcExcluding(const GeoPoint &center, double radius,
                             Angle start_radial, Angle end_radial);
+
+  /**
+   * Generate boundary points for a full circle.
+   */
+  void GenerateCircle(const GeoPoint &center, double radius);
 };
 
 #endif
@@ -36,14 +36,7 @@ OZBoundary
 CylinderZone::GetBoundary() const
 {
   OZBoundary boundary;
-
-  const unsigned steps = 20;
-  const auto delta = Angle::FullCircle() / steps;
-
-  GeoVector vector(GetRadius(), Angle::Zero());
-  for (unsigned i = 0; i < steps; ++i, vector.bearing += delta)
-    boundary.push_front(vector.EndPoint(GetReference()));
-
+  boundary.GenerateCircle(GetReference(), GetRadius());
   return boundary;
 }
 
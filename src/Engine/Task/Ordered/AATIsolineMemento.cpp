@@ -0,0 +1,56 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "AATIsolineMemento.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+
+bool
+AATIsolineMemento::Lookup(const GeoPoint &_previous, const GeoPoint &_next,
+                          const GeoPoint &_target,
+                          const FlatProjection &projection,
+                          double &_t_up, double &_t_down) const
+{
+  if (!center.IsValid() ||
+      projection.GetCenter() != center ||
+      _previous != previous ||
+      _next != next ||
+      _target != target)
+    return false;
+
+  _t_up = t_up;
+  _t_down = t_down;
+  return true;
+}
+
+void
+AATIsolineMemento::Store(const GeoPoint &_previous, const GeoPoint &_next,
+                         const GeoPoint &_target,
+                         const FlatProjection &projection,
+                         double _t_up, double _t_down)
+{
+  previous = _previous;
+  next = _next;
+  target = _target;
+  center = projection.GetCenter();
+  t_up = _t_up;
+  t_down = _t_down;
+}
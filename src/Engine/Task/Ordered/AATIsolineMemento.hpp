@@ -0,0 +1,94 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef AATISOLINE_MEMENTO_HPP
+#define AATISOLINE_MEMENTO_HPP
+
+#include "Geo/GeoPoint.hpp"
+#include "Compiler.h"
+
+class FlatProjection;
+
+/**
+ * Memento object to store the end points of the isoline segment found
+ * by the previous AATIsolineSegment constructor.  The segment only
+ * depends on the previous and next remaining locations, the target
+ * and the projection, so it can be reused as long as none of them
+ * changed and the observation zone was not modified.
+ *
+ * It is not synchronised: Store() and Reset() may only be called
+ * with write access to the task (i.e. by the calculation thread
+ * holding the exclusive lease), while readers only call Lookup().
+ */
+class AATIsolineMemento
+{
+  /** Remaining location of the previous task point */
+  GeoPoint previous;
+
+  /** Remaining location of the next task point */
+  GeoPoint next;
+
+  /** Target of the AAT point */
+  GeoPoint target;
+
+  /**
+   * Center of the projection used for the ellipse.  It determines
+   * the whole #FlatProjection, so a query with another projection
+   * (e.g. the map's) never matches a segment saved for the task.
+   */
+  GeoPoint center;
+
+  /** Parametric end points of the segment saved from previous query */
+  double t_up, t_down;
+
+public:
+  /** Constructor, initialises to trigger update on first call. */
+  AATIsolineMemento() {
+    Reset();
+  }
+
+  /**
+   * Forget the saved segment, e.g. because the observation zone
+   * has changed.
+   */
+  void Reset() {
+    center.SetInvalid();
+  }
+
+  /**
+   * Look up the segment end points saved from the previous query.
+   *
+   * @return true if the arguments are identical to the previous
+   * query and _t_up/_t_down were set
+   */
+  gcc_pure
+  bool Lookup(const GeoPoint &_previous, const GeoPoint &_next,
+              const GeoPoint &_target, const FlatProjection &projection,
+              double &_t_up, double &_t_down) const;
+
+  /** Save the segment end points of a query. */
+  void Store(const GeoPoint &_previous, const GeoPoint &_next,
+             const GeoPoint &_target, const FlatProjection &projection,
+             double _t_up, double _t_down);
+};
+
+#endif
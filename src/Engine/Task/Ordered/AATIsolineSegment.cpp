@@ -21,12 +21,12 @@
  */
 
 #include "AATIsolineSegment.hpp"
+#include "Points/AATPoint.hpp"
 #include "Task/PathSolvers/IsolineCrossingFinder.hpp"
 #include "Util/Tolerances.hpp"
 
-AATIsolineSegment::AATIsolineSegment(const AATPoint &ap,
-                                     const FlatProjection &projection)
-  :AATIsoline(ap, projection)
+void
+AATIsolineSegment::Search(const AATPoint &ap)
 {
   IsolineCrossingFinder icf_up(ap, ell, 0, 0.5);
   IsolineCrossingFinder icf_down(ap, ell, -0.5, 0);
@@ -41,6 +41,34 @@ AATIsolineSegment::AATIsolineSegment(const AATPoint &ap,
   }
 }
 
+AATIsolineSegment::AATIsolineSegment(const AATPoint &ap,
+                                     const FlatProjection &projection)
+  :AATIsoline(ap, projection)
+{
+  if (!ap.GetIsolineMemento().Lookup(ap.GetPrevious()->GetLocationRemaining(),
+                                     ap.GetNext()->GetLocationRemaining(),
+                                     ap.GetTargetLocation(), projection,
+                                     t_up, t_down))
+    Search(ap);
+}
+
+AATIsolineSegment::AATIsolineSegment(AATPoint &ap,
+                                     const FlatProjection &projection)
+  :AATIsoline(ap, projection)
+{
+  const GeoPoint &previous = ap.GetPrevious()->GetLocationRemaining();
+  const GeoPoint &next = ap.GetNext()->GetLocationRemaining();
+  AATIsolineMemento &memento = ap.GetIsolineMemento();
+  if (memento.Lookup(previous, next, ap.GetTargetLocation(), projection,
+                     t_up, t_down))
+    return;
+
+  Search(ap);
+
+  memento.Store(previous, next, ap.GetTargetLocation(), projection,
+                t_up, t_down);
+}
+
 bool
 AATIsolineSegment::IsValid() const
 {
@@ -32,17 +32,24 @@
  *  of all points along the isoline within the OZ.
  * 
  *  End-points of segments are searched for and so this
- *  class is slow to instantiate.
+ *  class is slow to instantiate.  The calculation thread saves the
+ *  result in the AATPoint's AATIsolineMemento, and all users reuse it
+ *  while the task geometry does not change.
  */
 class AATIsolineSegment: public AATIsoline
 {
   double t_up;
   double t_down;
 
+  void Search(const AATPoint &ap);
+
 public:
   /**
    * Constructor.  This performs the search for the isoline
-   * segment and so is slow.
+   * segment and so is slow, unless the segment saved in the
+   * AATPoint's AATIsolineMemento matches.  It does not modify the
+   * AATPoint, so it may be used by any thread with a read-only
+   * lease on the task.
    *
    * @param ap The AAT point for which the isoline is sought
    *
@@ -50,6 +57,13 @@ public:
    */
   AATIsolineSegment(const AATPoint &ap, const FlatProjection &projection);
 
+  /**
+   * Constructor which also saves the search result in the
+   * AATPoint's AATIsolineMemento.  This requires write access to
+   * the task, i.e. it is used by the calculation thread only.
+   */
+  AATIsolineSegment(AATPoint &ap, const FlatProjection &projection);
+
   /**
    * Test whether segment is valid (nonzero length)
    *
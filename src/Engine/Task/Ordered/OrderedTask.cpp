@@ -25,6 +25,8 @@
 #include "Points/OrderedTaskPoint.hpp"
 #include "Points/StartPoint.hpp"
 #include "Points/FinishPoint.hpp"
+#include "Points/AATPoint.hpp"
+#include "AATIsolineSegment.hpp"
 #include "Task/Solvers/TaskMacCreadyTravelled.hpp"
 #include "Task/Solvers/TaskMacCreadyRemaining.hpp"
 #include "Task/Solvers/TaskMacCreadyTotal.hpp"
@@ -33,7 +35,7 @@
 #include "Task/Solvers/TaskBestMc.hpp"
 #include "Task/Solvers/TaskMinTarget.hpp"
 #include "Task/Solvers/TaskGlideRequired.hpp"
-#include "Task/Solvers/TaskOptTarget.hpp"
+#include "Task/Solvers/TaskOptTargets.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
 
 #include "Task/Factory/Create.hpp"
@@ -46,6 +48,7 @@
 #include "Task/Stats/TaskSummary.hpp"
 #include "Task/PathSolvers/TaskDijkstraMin.hpp"
 #include "Task/PathSolvers/TaskDijkstraMax.hpp"
+#include "Task/ObservationZones/Boundary.hpp"
 #include "Task/ObservationZones/ObservationZoneClient.hpp"
 #include "Task/ObservationZones/CylinderZone.hpp"
 
@@ -221,6 +224,49 @@ OrderedTask::ScanLegStartTime()
 
 // DISTANCES
 
+/**
+ * The search only uses a coarse subset of the boundary (see
+ * OZBoundary::SEARCH_STEPS).  Moving each solution along its arc
+ * while the neighbouring solutions stay fixed converges after a few
+ * rounds; this is the number of rounds.
+ */
+static constexpr unsigned REFINE_ROUNDS = 2;
+
+void
+OrderedTask::RefineSolution(const TaskDijkstra &dijkstra,
+                            unsigned first_index, bool is_min,
+                            const GeoPoint &location,
+                            SearchPoint *solution) const
+{
+  const unsigned n = TaskSize() - first_index;
+  for (unsigned stage = 0; stage != n; ++stage)
+    solution[stage] = dijkstra.GetSolution(stage);
+
+  for (unsigned round = 0; round != REFINE_ROUNDS; ++round) {
+    for (unsigned stage = 0; stage != n; ++stage) {
+      const OrderedTaskPoint &tp = *task_points[first_index + stage];
+
+      /* only stages which searched the coarse boundary */
+      if (&dijkstra.GetBoundary(stage) != &tp.GetCoarseBoundaryPoints())
+        continue;
+
+      const GeoPoint &previous = stage > 0
+        ? solution[stage - 1].GetLocation()
+        : location;
+      const GeoPoint next = stage + 1 < n
+        ? solution[stage + 1].GetLocation()
+        : GeoPoint::Invalid();
+
+      const GeoPoint &current = solution[stage].GetLocation();
+      const GeoPoint refined =
+        tp.RefineBoundaryPoint(current, previous, next, is_min,
+                               task_projection);
+      if (refined != current)
+        solution[stage] = SearchPoint(refined, task_projection);
+    }
+  }
+}
+
 inline bool
 OrderedTask::RunDijsktraMin(const GeoPoint &location)
 {
@@ -235,7 +281,11 @@ OrderedTask::RunDijsktraMin(const GeoPoint &location)
   const unsigned active_index = GetActiveIndex();
   dijkstra.SetTaskSize(task_size - active_index);
   for (unsigned i = active_index; i != task_size; ++i) {
-    const SearchPointVector &boundary = task_points[i]->GetSearchPoints();
+    const OrderedTaskPoint &tp = *task_points[i];
+    const SearchPointVector &boundary =
+      &tp.GetSearchPoints() == &tp.GetBoundaryPoints()
+      ? tp.GetCoarseBoundaryPoints()
+      : tp.GetSearchPoints();
     dijkstra.SetBoundary(i - active_index, boundary);
   }
 
@@ -243,8 +293,11 @@ OrderedTask::RunDijsktraMin(const GeoPoint &location)
   if (!dijkstra.DistanceMin(ac))
     return false;
 
+  SearchPoint solutions[TaskDijkstra::MAX_STAGES];
+  RefineSolution(dijkstra, active_index, true, location, solutions);
+
   for (unsigned i = active_index; i != task_size; ++i)
-    SetPointSearchMin(i, dijkstra.GetSolution(i - active_index));
+    SetPointSearchMin(i, solutions[i - active_index]);
 
   return true;
 }
@@ -294,12 +347,14 @@ OrderedTask::RunDijsktraMax()
   const unsigned active_index = GetActiveIndex();
   dijkstra.SetTaskSize(task_size);
   for (unsigned i = 0; i != task_size; ++i) {
-    const SearchPointVector &boundary = i == active_index
+    const OrderedTaskPoint &tp = *task_points[i];
+    const SearchPointVector &boundary = i == active_index ||
+      &tp.GetSearchPoints() == &tp.GetBoundaryPoints()
       /* since one can still travel further in the current sector, use
          the full boundary here */
-      ? task_points[i]->GetBoundaryPoints()
-      : task_points[i]->GetSearchPoints();
-    dijkstra_max->SetBoundary(i, boundary);
+      ? tp.GetCoarseBoundaryPoints()
+      : tp.GetSearchPoints();
+    dijkstra.SetBoundary(i, boundary);
   }
 
   double start_radius(-1), finish_radius(-1);
@@ -319,17 +374,20 @@ OrderedTask::RunDijsktraMax()
       dijkstra.SetBoundary(task_size - 1, finish.GetNominalPoints());
   }
 
-  if (!dijkstra_max->DistanceMax())
+  if (!dijkstra.DistanceMax())
     return false;
 
+  SearchPoint solutions[TaskDijkstra::MAX_STAGES];
+  RefineSolution(dijkstra, 0, false, GeoPoint::Invalid(), solutions);
+
   for (unsigned i = 0; i != task_size; ++i) {
-    SearchPoint solution = dijkstra.GetSolution(i);
+    SearchPoint solution = solutions[i];
 
     if (i == 0 && start_radius > 0) {
       /* subtract start cylinder radius by finding the intersection
          with the cylinder boundary */
       const GeoPoint &current = task_points.front()->GetLocation();
-      const GeoPoint &neighbour = dijkstra.GetSolution(i + 1).GetLocation();
+      const GeoPoint &neighbour = solutions[i + 1].GetLocation();
       GeoPoint gp = current.IntermediatePoint(neighbour, start_radius);
       solution = SearchPoint(gp, task_projection);
     }
@@ -338,7 +396,7 @@ OrderedTask::RunDijsktraMax()
       /* subtract finish cylinder radius by finding the intersection
          with the cylinder boundary */
       const GeoPoint &current = task_points.back()->GetLocation();
-      const GeoPoint &neighbour = dijkstra.GetSolution(i - 1).GetLocation();
+      const GeoPoint &neighbour = solutions[i - 1].GetLocation();
       GeoPoint gp = current.IntermediatePoint(neighbour, finish_radius);
       solution = SearchPoint(gp, task_projection);
     }
@@ -627,21 +685,35 @@ OrderedTask::UpdateIdle(const AircraftState &state,
     CalcMinTarget(state, glide_polar,
                   GetOrderedTaskSettings().aat_min_time + task_behaviour.optimise_targets_margin);
 
-    if (task_behaviour.optimise_targets_bearing &&
-        task_points[active_task_point]->GetType() == TaskPointType::AAT) {
-      AATPoint *ap = (AATPoint *)task_points[active_task_point];
-      // very nasty hack
-      TaskOptTarget tot(task_points, active_task_point, state,
-                        task_behaviour.glide, glide_polar,
-                        *ap, task_projection, taskpoint_start);
-      tot.search(0.5);
+    if (task_behaviour.optimise_targets_bearing) {
+      TaskOptTargets tot(task_points, active_task_point, state,
+                         task_behaviour.glide, glide_polar,
+                         task_projection, taskpoint_start);
+      tot.Search();
     }
     retval = true;
   }
 
+  UpdateIsolines();
+
   return retval;
 }
 
+void
+OrderedTask::UpdateIsolines()
+{
+  for (OrderedTaskPoint *tp : task_points) {
+    if (tp->GetType() != TaskPointType::AAT)
+      continue;
+
+    AATPoint &ap = static_cast<AATPoint &>(*tp);
+    if (ap.valid()) {
+      /* the constructor saves the segment */
+      const AATIsolineSegment segment(ap, task_projection);
+    }
+  }
+}
+
 bool
 OrderedTask::UpdateSample(const AircraftState &state,
                           gcc_unused const GlidePolar &glide_polar,
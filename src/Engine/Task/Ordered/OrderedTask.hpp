@@ -39,6 +39,7 @@ class OrderedTaskPoint;
 class StartPoint;
 class FinishPoint;
 class AbstractTaskFactory;
+class TaskDijkstra;
 class TaskDijkstraMin;
 class TaskDijkstraMax;
 class Waypoints;
@@ -436,6 +437,19 @@ private:
    */
   bool RunDijsktraMin(const GeoPoint &location);
 
+  /**
+   * Copy the solution of the given search to #solution, and move the
+   * solutions of the stages which searched the coarse boundary
+   * points along their arcs.  See
+   * SampledTaskPoint::RefineBoundaryPoint().
+   *
+   * @param first_index the task point index of the first stage
+   * @param location the aircraft location for the minimum search,
+   * invalid for the maximum search
+   */
+  void RefineSolution(const TaskDijkstra &dijkstra, unsigned first_index,
+                      bool is_min, const GeoPoint &location,
+                      SearchPoint *solution) const;
 
   double ScanDistanceMin(const GeoPoint &ref, bool full);
 
@@ -459,6 +473,13 @@ private:
                        const GlidePolar &glide_polar,
                        const double t_target);
 
+  /**
+   * Save the isoline segment of each AAT point in its
+   * #AATIsolineMemento, so the renderers, which can only look it
+   * up, don't need to search it on every frame.
+   */
+  void UpdateIsolines();
+
   /**
    * Sets previous/next taskpoint pointers for task point at specified
    * index in sequence.
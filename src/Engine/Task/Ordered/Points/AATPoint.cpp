@@ -106,7 +106,7 @@ AATPoint::CheckTargetOutside(const AircraftState& state)
 /*
   // this is optional, to be replaced!
   
-  // now uses TaskOptTarget
+  // now uses TaskOptTargets
 
   if (!GetPrevious()->isInSector(state)) {
     double b0s = GetPrevious()->get_location_remaining()
@@ -221,3 +221,13 @@ AATPoint::Equals(const OrderedTaskPoint &other) const
     target_locked == tp.target_locked &&
     target_location == tp.target_location;
 }
+
+void
+AATPoint::UpdateOZ(const FlatProjection &projection)
+{
+  /* the observation zone may have been modified, and the saved
+     isoline segment may cross it elsewhere now */
+  isoline_memento.Reset();
+
+  OrderedTaskPoint::UpdateOZ(projection);
+}
@@ -25,6 +25,7 @@
 #define AATPOINT_HPP
 
 #include "IntermediatePoint.hpp"
+#include "Task/Ordered/AATIsolineMemento.hpp"
 #include "Math/Angle.hpp"
 
 struct RangeAndRadial {
@@ -58,6 +59,9 @@ class AATPoint final : public IntermediateTaskPoint {
   /** Whether target can float */
   bool target_locked;
 
+  /** Isoline segment found by the last AATIsolineSegment */
+  AATIsolineMemento isoline_memento;
+
 public:
   /**
    * Constructor.  Initialises to unlocked target, target is
@@ -168,6 +172,18 @@ public:
     return target_locked;
   }
 
+  /**
+   * Accessor for the isoline segment saved by AATIsolineSegment, to
+   * avoid searching it again while the task geometry is unchanged.
+   */
+  const AATIsolineMemento &GetIsolineMemento() const {
+    return isoline_memento;
+  }
+
+  AATIsolineMemento &GetIsolineMemento() {
+    return isoline_memento;
+  }
+
 private:
   /**
    * Check whether target needs to be moved and if so, to
@@ -215,6 +231,7 @@ public:
 
   /* virtual methods from class OrderedTaskPoint */
   bool Equals(const OrderedTaskPoint &other) const override;
+  void UpdateOZ(const FlatProjection &projection) override;
   bool UpdateSampleNear(const AircraftState &state,
                         const FlatProjection &projection) override;
   bool UpdateSampleFar(const AircraftState &state,
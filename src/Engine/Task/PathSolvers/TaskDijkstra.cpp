@@ -23,66 +23,135 @@
 #include "TaskDijkstra.hpp"
 #include "Geo/SearchPointVector.hpp"
 
+#include <algorithm>
+
 TaskDijkstra::TaskDijkstra(bool _is_min)
-  :NavDijkstra(0),
-   is_min(_is_min)
+  :num_stages(0), previous_num_stages(0),
+   is_min(_is_min), stages_calculated(0)
 {
 }
 
-inline unsigned
-TaskDijkstra::GetStageSize(const unsigned stage) const
+const SearchPoint &
+TaskDijkstra::GetPoint(unsigned stage, unsigned index) const
 {
   assert(stage < num_stages);
 
-  return boundaries[stage]->size();
+  return (*stages[stage].boundary)[index];
 }
 
-const SearchPoint &
-TaskDijkstra::GetPoint(const ScanTaskPoint sp) const
+bool
+TaskDijkstra::UpdateLocations(Stage &stage)
 {
-  return (*boundaries[sp.GetStageNumber()])[sp.GetPointIndex()];
+  const SearchPointVector &boundary = *stage.boundary;
+
+  bool changed = boundary.size() != stage.locations.size();
+  if (!changed) {
+    for (unsigned i = 0, n = boundary.size(); i < n; ++i) {
+      if (boundary[i].GetLocation() != stage.locations[i]) {
+        changed = true;
+        break;
+      }
+    }
+  }
+
+  if (changed) {
+    stage.locations.clear();
+    stage.locations.reserve(boundary.size());
+    for (const auto &i : boundary)
+      stage.locations.push_back(i.GetLocation());
+  }
+
+  return changed;
 }
 
 void
-TaskDijkstra::AddEdges(const ScanTaskPoint curNode)
+TaskDijkstra::CalculateStage(unsigned stage_number)
 {
-  ScanTaskPoint destination(curNode.GetStageNumber() + 1, 0);
-  const unsigned dsize = GetStageSize(destination.GetStageNumber());
-
-  for (const ScanTaskPoint end(destination.GetStageNumber(), dsize);
-       destination != end; destination.IncrementPointIndex())
-    Link(destination, curNode, CalcDistance(curNode, destination));
+  Stage &stage = stages[stage_number];
+  const unsigned size = stage.locations.size();
+
+  stage.value.resize(size);
+  stage.next.resize(size);
+
+  if (stage_number + 1 == num_stages) {
+    /* final stage */
+    std::fill(stage.value.begin(), stage.value.end(), 0u);
+    std::fill(stage.next.begin(), stage.next.end(), 0u);
+    return;
+  }
+
+  const Stage &next = stages[stage_number + 1];
+  const unsigned next_size = next.locations.size();
+  assert(next_size > 0);
+
+  for (unsigned i = 0; i < size; ++i) {
+    const GeoPoint &a = stage.locations[i];
+
+    unsigned best_value = 0, best_index = 0;
+    for (unsigned j = 0; j < next_size; ++j) {
+      /* using expensive floating point formulas here to avoid integer
+         rounding errors */
+      const unsigned value = (unsigned)a.Distance(next.locations[j])
+        + next.value[j];
+      if (j == 0 || IsBetter(value, best_value)) {
+        best_value = value;
+        best_index = j;
+      }
+    }
+
+    stage.value[i] = best_value;
+    stage.next[i] = best_index;
+  }
 }
 
-void
-TaskDijkstra::AddZeroStartEdges()
+bool
+TaskDijkstra::Run(const SearchPoint &location)
 {
-  const unsigned stage = 0;
-  ScanTaskPoint destination(stage, 0);
-  const unsigned dsize = GetStageSize(stage);
+  assert(num_stages > 0);
 
-  for (const ScanTaskPoint end(stage, dsize);
-       destination != end; destination.IncrementPointIndex())
-    LinkStart(destination, 0);
-}
+  bool changed = num_stages != previous_num_stages;
+  previous_num_stages = 0;
+  stages_calculated = 0;
 
-void 
-TaskDijkstra::AddStartEdges(unsigned stage, const SearchPoint &currentLocation)
-{
-  assert(currentLocation.IsValid());
+  for (unsigned i = num_stages; i-- > 0;) {
+    Stage &stage = stages[i];
+    if (stage.boundary->empty())
+      /* no way to reach the final stage */
+      return false;
 
-  ScanTaskPoint destination(stage, 0);
-  const unsigned dsize = GetStageSize(stage);
+    if (UpdateLocations(stage))
+      changed = true;
 
-  for (const ScanTaskPoint end(stage, dsize);
-       destination != end; destination.IncrementPointIndex())
-    LinkStart(destination, CalcDistance(destination, currentLocation));
-}
+    if (changed) {
+      /* this stage or one after it has changed: the distances to the
+         end of the task need to be recalculated */
+      CalculateStage(i);
+      ++stages_calculated;
+    }
+  }
 
-bool
-TaskDijkstra::Run()
-{
-  const bool retval = DistanceGeneral() == SolverResult::VALID;
-  dijkstra.Clear();
-  return retval;
+  previous_num_stages = num_stages;
+
+  /* find the best start point */
+
+  const Stage &first = stages[0];
+  unsigned best_value = 0, best_index = 0;
+  for (unsigned i = 0, n = first.locations.size(); i < n; ++i) {
+    unsigned value = first.value[i];
+    if (location.IsValid())
+      value += (unsigned)first.locations[i].Distance(location.GetLocation());
+
+    if (i == 0 || IsBetter(value, best_value)) {
+      best_value = value;
+      best_index = i;
+    }
+  }
+
+  /* follow the chain */
+
+  solution[0] = best_index;
+  for (unsigned i = 0; i + 1 < num_stages; ++i)
+    solution[i + 1] = stages[i].next[solution[i]];
+
+  return true;
 }
@@ -23,21 +23,19 @@
 #ifndef TASK_DIJKSTRA_HPP
 #define TASK_DIJKSTRA_HPP
 
-#include "PathSolvers/NavDijkstra.hpp"
 #include "Geo/SearchPoint.hpp"
+#include "Compiler.h"
+
+#include <vector>
 
 #include <assert.h>
 
-class OrderedTask;
 class SearchPointVector;
 
 /**
  * Class used to scan an OrderedTask for maximum/minimum distance
  * points.
  *
- * Uses flat-projected integer representation of search points for
- * speed, but this also makes the system approximate.
- *
  * Search points are located on OZ boundaries and each form a convex
  * hull, as this produces the minimum search vector size without loss
  * of accuracy.
@@ -49,14 +47,50 @@ class SearchPointVector;
  * Before each calculation, set up this object with SetTaskSize() and
  * call SetBoundary() for each task point.
  *
- * This uses a Dijkstra search and so is O(N log(N)).
+ * Edges only connect consecutive stages, so instead of a general
+ * Dijkstra search, the best distance from each point to the end of
+ * the task is calculated stage by stage, starting at the final stage.
+ * These per-stage results are kept: the next search recalculates only
+ * the stages whose boundary has changed and the stages before them.
+ * When only the active task point was sampled, that is one stage.
  */
-class TaskDijkstra : protected NavDijkstra
-{
-  const SearchPointVector *boundaries[MAX_STAGES];
+class TaskDijkstra {
+public:
+  static constexpr unsigned MAX_STAGES = 32;
+
+private:
+  struct Stage {
+    /** the boundary passed to SetBoundary() */
+    const SearchPointVector *boundary;
+
+    /** the boundary locations #value was calculated for */
+    std::vector<GeoPoint> locations;
+
+    /** best distance from each point to the end of the task */
+    std::vector<unsigned> value;
+
+    /** index of the best point in the next stage for each point */
+    std::vector<unsigned> next;
+  };
+
+  Stage stages[MAX_STAGES];
+
+  /** Number of stages in search */
+  unsigned num_stages;
+
+  /** Number of stages in the previous search */
+  unsigned previous_num_stages;
+
+  /**
+   * An array containing the point index for each of the solution's stages.
+   */
+  unsigned solution[MAX_STAGES];
 
   const bool is_min;
 
+  /** Number of stages recalculated by the last search */
+  unsigned stages_calculated;
+
 public:
   /**
    * Constructor
@@ -65,14 +99,32 @@ public:
    */
   TaskDijkstra(const bool is_min);
 
+  TaskDijkstra(const TaskDijkstra &) = delete;
+
   void SetTaskSize(unsigned size) {
-    SetStageCount(size);
+    assert(size <= MAX_STAGES);
+
+    num_stages = size;
   }
 
   void SetBoundary(unsigned idx, const SearchPointVector &boundary) {
     assert(idx < num_stages);
 
-    boundaries[idx] = &boundary;
+    stages[idx].boundary = &boundary;
+  }
+
+  const SearchPointVector &GetBoundary(unsigned idx) const {
+    assert(idx < num_stages);
+
+    return *stages[idx].boundary;
+  }
+
+  /**
+   * Forget the per-stage results of previous searches, so the next
+   * one starts from scratch.
+   */
+  void Invalidate() {
+    previous_num_stages = 0;
   }
 
   /**
@@ -82,74 +134,48 @@ public:
   const SearchPoint &GetSolution(unsigned stage) const {
     assert(stage < num_stages);
 
-    return GetPoint(ScanTaskPoint(stage, solution[stage]));
+    return GetPoint(stage, solution[stage]);
+  }
+
+  /**
+   * Returns the number of stages which had to be recalculated by the
+   * last search.
+   */
+  unsigned GetStagesCalculated() const {
+    return stages_calculated;
   }
 
 protected:
   gcc_pure
-  const SearchPoint &GetPoint(ScanTaskPoint sp) const;
-
-  bool Run();
-
-  bool Link(const ScanTaskPoint node, const ScanTaskPoint parent,
-            unsigned value) {
-    if (!is_min)
-      value = DIJKSTRA_MINMAX_OFFSET - value;
-
-    return NavDijkstra::Link(node, parent, value);
-  }
+  const SearchPoint &GetPoint(unsigned stage, unsigned index) const;
 
   /**
-   * Add a zero-length start edge to each point in the first stage.
+   * Update the per-stage results and find the best solution.
+   *
+   * @param location the location of the aircraft; if it is invalid,
+   * the search may start at any point of the first stage
+   * @return true if a solution was found
    */
-  void AddZeroStartEdges();
+  bool Run(const SearchPoint &location);
 
-  /**
-   * Add a start edge from the given location to each point in the
-   * given stage.
-   */
-  void AddStartEdges(unsigned stage, const SearchPoint &loc);
-
-  /** 
-   * Distance function for free point
-   * 
-   * @param curNode Destination node
-   * @param currentLocation Origin location
-   * 
-   * @return Distance (flat) from origin to destination
-   */
+private:
   gcc_pure
-  unsigned CalcDistance(const ScanTaskPoint curNode,
-                        const SearchPoint &currentLocation) const {
-    /* using expensive floating point formulas here to avoid integer
-       rounding errors */
-
-    const GeoPoint &a = GetPoint(curNode).GetLocation();
-    const GeoPoint &b = currentLocation.GetLocation();
-
-    return (unsigned)a.Distance(b);
+  bool IsBetter(unsigned a, unsigned b) const {
+    return is_min ? a < b : a > b;
   }
 
-  /** 
-   * Distance function for edges
-   * 
-   * @param s1 Origin node
-   * @param s2 Destination node
-   * 
-   * @return Distance (flat) from origin to destination
+  /**
+   * Check whether the boundary of the given stage differs from the
+   * one of the previous search, and remember it.
    */
-  gcc_pure
-  unsigned CalcDistance(const ScanTaskPoint s1, const ScanTaskPoint s2) const {
-    return CalcDistance(s1, GetPoint(s2));
-  }
+  bool UpdateLocations(Stage &stage);
 
-private:
-  gcc_pure
-  unsigned GetStageSize(const unsigned stage) const;
-
-protected:
-  /* methods from NavDijkstra */
-  virtual void AddEdges(ScanTaskPoint curNode) final;
+  /**
+   * Calculate the best distance from each point of the given stage
+   * to the end of the task, assuming the following stage is up to
+   * date.
+   */
+  void CalculateStage(unsigned stage);
 };
 
 #endif
@@ -23,6 +23,12 @@
 #include "SampledTaskPoint.hpp"
 #include "Task/ObservationZones/Boundary.hpp"
 #include "Navigation/Aircraft.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+#include "Geo/Flat/FlatPoint.hpp"
+
+#include <algorithm>
+
+#include <math.h>
 
 SampledTaskPoint::SampledTaskPoint(const GeoPoint &location,
                                    const bool b_scored)
@@ -82,10 +88,22 @@ SampledTaskPoint::UpdateOZ(const FlatProjection &projection,
 {
   search_max = search_min = nominal_points.front();
   boundary_points.clear();
+  coarse_boundary_points.clear();
 
-  for (const SearchPoint sp : _boundary)
+  /* OZBoundary::skipped is a subsequence of the boundary */
+  auto skipped = _boundary.skipped.begin();
+  for (const SearchPoint sp : _boundary) {
     boundary_points.push_back(sp);
 
+    if (skipped != _boundary.skipped.end() && *skipped == sp.GetLocation())
+      ++skipped;
+    else
+      coarse_boundary_points.push_back(sp);
+  }
+  assert(skipped == _boundary.skipped.end());
+
+  boundary_arcs.assign(_boundary.arcs.begin(), _boundary.arcs.end());
+
   UpdateProjection(projection);
 }
 
@@ -99,6 +117,105 @@ SampledTaskPoint::UpdateProjection(const FlatProjection &projection)
   nominal_points.Project(projection);
   sampled_points.Project(projection);
   boundary_points.Project(projection);
+  coarse_boundary_points.Project(projection);
+}
+
+gcc_pure
+static double
+GetPathDistance(const GeoPoint &previous, const GeoPoint &location,
+                const GeoPoint &next)
+{
+  double distance = 0;
+  if (previous.IsValid())
+    distance += previous.DistanceS(location);
+  if (next.IsValid())
+    distance += location.DistanceS(next);
+  return distance;
+}
+
+GeoPoint
+SampledTaskPoint::RefineBoundaryPoint(const GeoPoint &location,
+                                      const GeoPoint &previous,
+                                      const GeoPoint &next,
+                                      bool is_min,
+                                      const FlatProjection &projection) const
+{
+  /* the refined location is accurate to this angle */
+  const double resolution = Angle::Degrees(0.1).Radians();
+
+  /* the golden ratio */
+  const double ratio = (sqrt(5.) - 1) / 2;
+
+  const double sign = is_min ? -1 : 1;
+
+  for (const auto &arc : boundary_arcs) {
+    if (!arc.IsOnArc(location))
+      continue;
+
+    /* the optimum lies between the neighbouring coarse points;
+       narrow it down with a golden section search on the flat
+       projection of the arc */
+    const double step =
+      (Angle::FullCircle() / OZBoundary::SEARCH_STEPS).Radians();
+    const double offset =
+      (arc.center.Bearing(location) - arc.start).AsBearing().Radians();
+    double a = offset - step, b = offset + step;
+    if (arc.sweep < Angle::FullCircle()) {
+      a = std::max(a, 0.);
+      b = std::min(b, arc.sweep.Radians());
+    }
+
+    const FlatPoint center = projection.ProjectFloat(arc.center);
+    const double radius = projection.ProjectRangeFloat(arc.center,
+                                                       arc.radius);
+    const FlatPoint flat_previous = previous.IsValid()
+      ? projection.ProjectFloat(previous)
+      : FlatPoint(0, 0);
+    const FlatPoint flat_next = next.IsValid()
+      ? projection.ProjectFloat(next)
+      : FlatPoint(0, 0);
+
+    auto f = [&](double x){
+      const auto sc = (arc.start + Angle::Radians(x)).SinCos();
+      const FlatPoint p(center.x + radius * sc.first,
+                        center.y + radius * sc.second);
+      double distance = 0;
+      if (previous.IsValid())
+        distance += flat_previous.Distance(p);
+      if (next.IsValid())
+        distance += p.Distance(flat_next);
+      return sign * distance;
+    };
+
+    double c = b - ratio * (b - a), d = a + ratio * (b - a);
+    double fc = f(c), fd = f(d);
+    while (b - a > resolution) {
+      if (fc > fd) {
+        b = d;
+        d = c;
+        fd = fc;
+        c = b - ratio * (b - a);
+        fc = f(c);
+      } else {
+        a = c;
+        c = d;
+        fc = fd;
+        d = a + ratio * (b - a);
+        fd = f(d);
+      }
+    }
+
+    /* the projection is only an approximation; keep the refined
+       location only if it is really better */
+    const GeoPoint refined =
+      arc.GetPoint(arc.start + Angle::Radians((a + b) / 2));
+    return sign * GetPathDistance(previous, refined, next) >
+      sign * GetPathDistance(previous, location, next)
+      ? refined
+      : location;
+  }
+
+  return location;
 }
 
 void
@@ -24,10 +24,12 @@
 #define SAMPLEDTASKPOINT_H
 
 #include "Geo/SearchPointVector.hpp"
+#include "Task/ObservationZones/Boundary.hpp"
 #include "Compiler.h"
 
+#include <vector>
+
 class FlatProjection;
-class OZBoundary;
 struct GeoPoint;
 struct AircraftState;
 
@@ -58,6 +60,14 @@ class SampledTaskPoint {
   SearchPointVector nominal_points;
   SearchPointVector sampled_points;
   SearchPointVector boundary_points;
+  std::vector<OZBoundary::Arc> boundary_arcs;
+
+  /**
+   * The subset of #boundary_points which the minimum/maximum
+   * distance search uses (see OZBoundary::SEARCH_STEPS).
+   */
+  SearchPointVector coarse_boundary_points;
+
   SearchPoint search_max;
   SearchPoint search_min;
 
@@ -158,6 +168,34 @@ public:
     return boundary_points;
   }
 
+  /**
+   * Retrieve the subset of the boundary points which the minimum and
+   * maximum distance searches use.
+   */
+  const SearchPointVector &GetCoarseBoundaryPoints() const {
+    assert(!coarse_boundary_points.empty());
+
+    return coarse_boundary_points;
+  }
+
+  /**
+   * Move a solution of the search on #coarse_boundary_points along
+   * its boundary arc, to minimise or maximise the length of the path
+   * from the previous to the next solution via this point.
+   *
+   * @param location the solution of the search
+   * @param previous the solution of the previous stage; may be
+   * invalid
+   * @param next the solution of the next stage; may be invalid
+   * @param projection the task projection
+   * @return the refined location, or #location if it is not on an arc
+   */
+  gcc_pure
+  GeoPoint RefineBoundaryPoint(const GeoPoint &location,
+                               const GeoPoint &previous, const GeoPoint &next,
+                               bool is_min,
+                               const FlatProjection &projection) const;
+
   /**
    * Return a #SearchPointVector that contains just the reference
    * point.
@@ -29,12 +29,6 @@
 /** min distance for any FAI Leg -- derived from circular FAI sector radius */
 static constexpr double min_fai_leg(2000);
 
-/** min angle allowable in a FAI Triangle 31.5 degrees */
-static constexpr Angle min_fai_angle = Angle::Degrees(31.5);
-
-/** max angle allowable in a FAI Triangle 113.2 degrees */
-static constexpr Angle max_fai_angle = Angle::Degrees(114);
-
 FAITrianglePointValidator::FAITrianglePointValidator(
     OrderedTask *ordered_task, const unsigned ordered_task_index)
   :task(ordered_task), t_index(ordered_task_index), t_size(0)
@@ -50,6 +44,32 @@ FAITrianglePointValidator::FAITrianglePointValidator(
   }
 
   fai_triangle_point_invalid = t_size > 4 || t_index > 3;
+
+  if (fai_triangle_point_invalid)
+    return;
+
+  /* if the candidate is the third point of a triangle whose other
+     two points are known, it must be inside the FAI area over the
+     opposite leg; the orientation is preserved by taking the points
+     in task order after the candidate */
+  const OrderedTaskPoint *a = nullptr, *b = nullptr;
+  if (t_index == 0 && t_size >= 3) {
+    a = &task->GetPoint(1);
+    b = &task->GetPoint(2);
+  } else if (t_index == 1 && t_size >= 3) {
+    a = &task->GetPoint(2);
+    b = &task->GetPoint(0);
+  } else if (t_index == 2 && t_size >= 2) {
+    a = &task->GetPoint(0);
+    b = &task->GetPoint(1);
+  }
+
+  if (a != nullptr) {
+    const FAITriangleSettings &settings =
+      task->GetOrderedTaskSettings().fai_triangle;
+    left_sector.Update(a->GetLocation(), b->GetLocation(), false, settings);
+    right_sector.Update(a->GetLocation(), b->GetLocation(), true, settings);
+  }
 }
 
 
@@ -64,18 +84,13 @@ FAITrianglePointValidator::TestFAITriangle(const double d1, const double d2,
   return FAITriangleRules::TestDistances(d1, d2, d3, settings);
 }
 
-inline bool
-FAITrianglePointValidator::IsFAIAngle(const GeoPoint &p0, const GeoPoint &p1,
-                                      const GeoPoint &p2, bool right)
+GeoBounds
+FAITrianglePointValidator::GetSearchBounds(bool right) const
 {
-  const Angle a01 = p0.Bearing(p1);
-  const Angle a21 = p2.Bearing(p1);
-  const Angle diff = (a01 - a21).AsDelta();
-
-  if (right)
-    return (diff > min_fai_angle) && (diff < max_fai_angle);
-  else
-    return diff < -min_fai_angle && diff > -max_fai_angle;
+  if (fai_triangle_point_invalid)
+    return GeoBounds::Invalid();
+
+  return GetSector(right).GetBounds();
 }
 
 bool
@@ -106,8 +121,7 @@ FAITrianglePointValidator::IsFAITrianglePoint(const Waypoint& wp,
       return p.Distance(task->GetPoint(1).GetLocation()) > min_fai_leg;
 
     default: // size == 3 or 4
-      if (!IsFAIAngle(p, task->GetPoint(1).GetLocation(),
-                      task->GetPoint(2).GetLocation(), right))
+      if (!GetSector(right).IsInside(p))
         return false;
       if (t_size == 3) {
         return TestFAITriangle(p.Distance(task->GetPoint(1).GetLocation()),
@@ -130,9 +144,7 @@ FAITrianglePointValidator::IsFAITrianglePoint(const Waypoint& wp,
       return p.Distance(task->GetPoint(0).GetLocation()) > min_fai_leg;
 
     // size == 3 or 4
-    if (!IsFAIAngle(task->GetPoint(0).GetLocation(),
-                    p,
-                    task->GetPoint(2).GetLocation(), right))
+    if (!GetSector(right).IsInside(p))
       return false;
 
     if (t_size == 3) {
@@ -151,9 +163,8 @@ FAITrianglePointValidator::IsFAITrianglePoint(const Waypoint& wp,
   // append or replace point #2
   if (t_index == 2) {
     assert(t_size >= 2);
-    if (!IsFAIAngle(task->GetPoint(0).GetLocation(),
-                    task->GetPoint(1).GetLocation(),
-                    p, right))
+
+    if (!GetSector(right).IsInside(p))
       return false;
 
     if (t_size < 4) { // no finish point yet
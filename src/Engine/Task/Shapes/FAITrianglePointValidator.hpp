@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_FAI_TRIANGLE_POINT_VALIDATOR_HPP
 #define XCSOAR_FAI_TRIANGLE_POINT_VALIDATOR_HPP
 
+#include "FAITriangleSector.hpp"
 #include "Compiler.h"
 
 class OrderedTask;
@@ -46,6 +47,12 @@ class FAITrianglePointValidator
 
   bool fai_triangle_point_invalid;
 
+  /**
+   * The areas of valid candidates over the opposite leg, if the
+   * other two points of the triangle are known.
+   */
+  FAITriangleSector left_sector, right_sector;
+
 public:
   FAITrianglePointValidator(OrderedTask *ordered_task,
                             const unsigned ordered_task_index);
@@ -60,25 +67,24 @@ public:
   gcc_pure
   bool IsFAITrianglePoint(const Waypoint &wp, bool right) const;
 
+  /**
+   * Returns a bounding box of all points which may pass
+   * IsFAITrianglePoint(), or an invalid GeoBounds if the candidates
+   * are not restricted to an area.  This allows looking up the
+   * candidates spatially instead of testing all waypoints.
+   */
+  gcc_pure
+  GeoBounds GetSearchBounds(bool right) const;
+
 private:
+  const FAITriangleSector &GetSector(bool right) const {
+    return right ? right_sector : left_sector;
+  }
+
   gcc_pure
   static bool TestFAITriangle(double d1, double d2, double d3,
                               const FAITriangleSettings &settings);
 
-  /**
-   * Perform fast check to exclude point as from further consideration
-   * based on min/max possible values for any FAI triangle
-   * @param p0 point 1 of angle
-   * @param p1 point 2 of angle
-   * @param p2 point 3 of angle
-   * @param right.  = 1 if angle is for right triangle, -1 if left triangle.
-   * @returns False if angle from three points is out of possible range for
-   * an FAI triangle.
-   */
-  gcc_pure
-  static bool IsFAIAngle(const GeoPoint &p0, const GeoPoint &p1,
-                         const GeoPoint &p2, bool right);
-
   void PrepareFAITest(OrderedTask *ordered_task,
                       const unsigned ordered_task_index);
 };
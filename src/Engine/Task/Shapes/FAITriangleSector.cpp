@@ -0,0 +1,249 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FAITriangleSector.hpp"
+#include "FAITriangleRules.hpp"
+#include "Geo/Math.hpp"
+#include "Math/Util.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+using namespace FAITriangleRules;
+
+bool
+FAITriangleSector::Update(const GeoPoint &_pt1, const GeoPoint &_pt2,
+                          bool _reverse, const FAITriangleSettings &_settings)
+{
+  if (IsDefined() && _pt1 == pt1 && _pt2 == pt2 && _reverse == reverse &&
+      _settings.threshold == settings.threshold)
+    return false;
+
+  pt1 = _pt1;
+  pt2 = _pt2;
+  reverse = _reverse;
+  settings = _settings;
+  leg = pt1.DistanceBearing(pt2);
+
+  BuildEdges();
+  vertex_steps = 0;
+  bounds.SetInvalid();
+  return true;
+}
+
+void
+FAITriangleSector::BuildEdges()
+{
+  edges.clear();
+
+  const auto c = leg.distance;
+  if (c <= 0)
+    return;
+
+  const auto large_threshold = settings.GetThreshold();
+
+  const auto dist_max = c / SMALL_MIN_LEG;
+  const auto dist_min = c / SMALL_MAX_LEG;
+
+  const auto large_dist_min = c / LARGE_MAX_LEG;
+  const auto large_dist_max = c / LARGE_MIN_LEG;
+
+  /* the total distance where the third point's leg to pt1 reaches
+     25% while the other one is at 45% */
+  const auto total_for_a = c / (1 - LARGE_MAX_LEG - LARGE_MIN_LEG);
+
+  const bool have_large = large_dist_max > large_threshold;
+  const bool have_small = large_threshold > large_dist_min ||
+    dist_min <= large_dist_min;
+
+  if (have_small) {
+    /* Total=min..max; A=28% */
+    const auto total_end = std::min(dist_max, large_threshold);
+    if (total_end > dist_min)
+      AddEdge(SMALL_MIN_LEG * dist_min,
+              dist_min - SMALL_MIN_LEG * dist_min - c,
+              SMALL_MIN_LEG * total_end,
+              total_end - SMALL_MIN_LEG * total_end - c);
+
+    if (have_large) {
+      /* Total=threshold; A=28%..25% */
+      const auto min_leg = large_threshold * (1 - LARGE_MAX_LEG) - c;
+      const auto a_start = large_threshold * SMALL_MIN_LEG;
+      const auto a_end = std::max(min_leg, LargeMinLeg(large_threshold));
+      if (a_start > a_end)
+        AddEdge(a_start, large_threshold - c - a_start,
+                a_end, large_threshold - c - a_end);
+    }
+  } else {
+    /* Total=C/LARGE_MAX_LEG; A=30..25%; B=25..30% */
+    const auto total = large_dist_min;
+    const auto b = LargeMinLeg(total);
+    const auto a = total - c - b;
+    AddEdge(a, b, b, a);
+  }
+
+  if (have_large) {
+    /* Total=threshold..; A=25%; B=30%..45% */
+    const auto right1_start = std::max(large_dist_min, large_threshold);
+    const auto right1_end = std::min(large_dist_max, total_for_a);
+    if (right1_end > right1_start)
+      AddEdge(LargeMinLeg(right1_start),
+              right1_start - LargeMinLeg(right1_start) - c,
+              LargeMinLeg(right1_end),
+              right1_end - LargeMinLeg(right1_end) - c);
+
+    /* Total=..max; A=25%..30%; B=45% */
+    const auto right2_start = std::max(right1_start, total_for_a);
+    if (large_dist_max > right2_start)
+      AddEdge(right2_start * (1 - LARGE_MAX_LEG) - c,
+              right2_start * LARGE_MAX_LEG,
+              large_dist_max * (1 - LARGE_MAX_LEG) - c,
+              large_dist_max * LARGE_MAX_LEG);
+
+    /* Total=max; A=30%..45%; B=45%..30% */
+    const auto max_leg = large_dist_max * LARGE_MAX_LEG;
+    const auto min_leg = large_dist_max - c - max_leg;
+    assert(max_leg >= min_leg);
+    AddEdge(min_leg, max_leg, max_leg, min_leg);
+
+    /* Total=max..; A=45%; B=30%..25% */
+    const auto left2_end = std::max(large_threshold, total_for_a);
+    if (large_dist_max > left2_end)
+      AddEdge(large_dist_max * LARGE_MAX_LEG,
+              large_dist_max * (1 - LARGE_MAX_LEG) - c,
+              left2_end * LARGE_MAX_LEG,
+              left2_end * (1 - LARGE_MAX_LEG) - c);
+
+    /* Total=..threshold; A=45%..30%; B=25% */
+    const auto left1_start = std::min(large_dist_max, total_for_a);
+    const auto left1_end = std::max(large_dist_min, large_threshold);
+    if (left1_start > left1_end)
+      AddEdge(left1_start - LargeMinLeg(left1_start) - c,
+              LargeMinLeg(left1_start),
+              left1_end - LargeMinLeg(left1_end) - c,
+              LargeMinLeg(left1_end));
+  }
+
+  if (have_small) {
+    if (have_large) {
+      /* Total=threshold; B=25%..28% */
+      const auto min_leg = large_threshold * (1 - LARGE_MAX_LEG) - c;
+      const auto b_start = std::max(min_leg, LargeMinLeg(large_threshold));
+      const auto b_end = large_threshold * SMALL_MIN_LEG;
+      if (b_start < b_end)
+        AddEdge(large_threshold - c - b_start, b_start,
+                large_threshold - c - b_end, b_end);
+    } else
+      /* Total=max; A=28%..44%; B=44%..28% */
+      AddEdge(c, dist_max - 2 * c, dist_max - 2 * c, c);
+
+    /* Total=max..min; B=28% */
+    const auto total_start = std::min(dist_max, large_threshold);
+    if (total_start > dist_min)
+      AddEdge(total_start - SMALL_MIN_LEG * total_start - c,
+              SMALL_MIN_LEG * total_start,
+              dist_min - SMALL_MIN_LEG * dist_min - c,
+              SMALL_MIN_LEG * dist_min);
+  }
+}
+
+GeoPoint
+FAITriangleSector::GetEdgePoint(const Edge &edge, double t) const
+{
+  const auto dist_a = edge.a0 + t * (edge.a1 - edge.a0);
+  const auto dist_b = edge.b0 + t * (edge.b1 - edge.b0);
+  const auto c = leg.distance;
+
+  /* the angle at pt1 between the leg and the third point */
+  const auto cos_alpha = (Square(dist_b) + Square(c) - Square(dist_a))
+    / (2 * c * dist_b);
+  const Angle alpha = Angle::acos(cos_alpha);
+
+  return FindLatitudeLongitude(pt1,
+                               reverse ? leg.bearing + alpha : leg.bearing - alpha,
+                               dist_b);
+}
+
+ConstBuffer<GeoPoint>
+FAITriangleSector::GetBoundary(unsigned steps) const
+{
+  assert(steps > 0 && steps <= MAX_STEPS);
+
+  if (steps == vertex_steps)
+    return {vertices.raw(), vertices.size()};
+
+  const unsigned n_edges = edges.size();
+  const unsigned old_steps = vertex_steps;
+  vertices.resize(n_edges * steps);
+  vertex_steps = steps;
+
+  if (old_steps > 0 && steps > old_steps && steps % old_steps == 0) {
+    /* refine: move the existing vertices to their new positions
+       (backwards, so none is overwritten before it is moved), and
+       only calculate the new ones in between */
+    const unsigned k = steps / old_steps;
+    for (unsigned i = n_edges * old_steps; i-- > 0;)
+      vertices[i / old_steps * steps + i % old_steps * k] = vertices[i];
+
+    for (unsigned e = 0; e < n_edges; ++e)
+      for (unsigned j = 0; j < steps; ++j)
+        if (j % k != 0)
+          vertices[e * steps + j] = GetEdgePoint(edges[e], double(j) / steps);
+  } else {
+    for (unsigned e = 0; e < n_edges; ++e)
+      for (unsigned j = 0; j < steps; ++j)
+        vertices[e * steps + j] = GetEdgePoint(edges[e], double(j) / steps);
+  }
+
+  return {vertices.raw(), vertices.size()};
+}
+
+void
+FAITriangleSector::UpdateBounds() const
+{
+  /* the vertices at the default resolution are close enough to the
+     real boundary that a small margin makes the box safe to reject
+     points with */
+  const auto boundary = GetBoundary(std::max(vertex_steps,
+                                             unsigned(DEFAULT_STEPS)));
+  bounds = GeoBounds(boundary.front());
+  for (const GeoPoint &p : boundary)
+    bounds.Extend(p);
+
+  bounds = bounds.Scale(1.1);
+}
+
+bool
+FAITriangleSector::IsInside(const GeoPoint &p) const
+{
+  if (edges.empty() || !GetBounds().IsInside(p))
+    return false;
+
+  const GeoVector v = pt1.DistanceBearing(p);
+  const Angle delta = (v.bearing - leg.bearing).AsDelta();
+  if (reverse ? delta <= Angle::Zero() : delta >= Angle::Zero())
+    return false;
+
+  return TestDistances(leg.distance, p.Distance(pt2), v.distance, settings);
+}
@@ -0,0 +1,153 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FAI_TRIANGLE_SECTOR_HPP
+#define XCSOAR_FAI_TRIANGLE_SECTOR_HPP
+
+#include "FAITriangleArea.hpp"
+#include "FAITriangleSettings.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Util/StaticArray.hxx"
+#include "Util/ConstBuffer.hxx"
+#include "Compiler.h"
+
+/**
+ * The area of all valid third points of an FAI triangle over a given
+ * leg, on one side of the leg.
+ *
+ * The boundary is stored parametrically: each edge is a straight
+ * line in the space of the two distances from the third point to the
+ * ends of the leg, which makes it cheap to build and allows
+ * generating vertices at any resolution.  Generated vertices are
+ * cached and reused (and refined) as long as the leg does not change.
+ */
+class FAITriangleSector {
+public:
+  /** Maximum number of edges of the boundary */
+  static constexpr unsigned MAX_EDGES = 9;
+
+  /** Maximum number of vertices generated per edge */
+  static constexpr unsigned MAX_STEPS = FAI_TRIANGLE_SECTOR_MAX / MAX_EDGES;
+
+  /** Number of vertices per edge of GenerateFAITriangleArea() */
+  static constexpr unsigned DEFAULT_STEPS = FAI_TRIANGLE_SECTOR_MAX / 3 / 8;
+
+private:
+  /**
+   * One edge of the boundary.  The distances of the third point from
+   * the first (b) and second (a) point of the leg vary linearly
+   * from the start to the end of the edge.
+   */
+  struct Edge {
+    double a0, b0, a1, b1;
+  };
+
+  GeoPoint pt1, pt2;
+  bool reverse;
+  FAITriangleSettings settings;
+
+  /** The leg from #pt1 to #pt2 */
+  GeoVector leg;
+
+  StaticArray<Edge, MAX_EDGES> edges;
+
+  /**
+   * Bounding box of the area, used to reject points quickly.
+   * Calculated on demand by GetBounds().
+   */
+  mutable GeoBounds bounds;
+
+  /** Vertices generated for the current leg */
+  mutable StaticArray<GeoPoint, FAI_TRIANGLE_SECTOR_MAX> vertices;
+
+  /** Number of #vertices per edge, 0 if none were generated yet */
+  mutable unsigned vertex_steps;
+
+public:
+  FAITriangleSector()
+    :pt1(GeoPoint::Invalid()), pt2(GeoPoint::Invalid()),
+     bounds(GeoBounds::Invalid()), vertex_steps(0) {}
+
+  /**
+   * Set up the area for the given leg.  Does nothing if the leg and
+   * the settings are the same as in the previous call.
+   *
+   * @param reverse true for the area on the right side of the leg
+   * from pt1 to pt2
+   * @return true if the area was modified
+   */
+  bool Update(const GeoPoint &pt1, const GeoPoint &pt2, bool reverse,
+              const FAITriangleSettings &settings);
+
+  bool IsDefined() const {
+    return pt1.IsValid();
+  }
+
+  gcc_pure
+  const GeoVector &GetLeg() const {
+    return leg;
+  }
+
+  /**
+   * Returns a bounding box containing the whole area, or an invalid
+   * GeoBounds if the area is empty.
+   */
+  const GeoBounds &GetBounds() const {
+    if (!bounds.IsValid() && !edges.empty())
+      UpdateBounds();
+    return bounds;
+  }
+
+  /**
+   * Would the given point be a valid third point of an FAI triangle
+   * over this leg (on this side)?
+   */
+  gcc_pure
+  bool IsInside(const GeoPoint &p) const;
+
+  /**
+   * Returns the boundary polygon with the given number of vertices
+   * per edge.  The result is cached until the next modifying
+   * Update() call; it remains valid until the next call of this
+   * method or IsInside().
+   *
+   * @param steps the number of vertices per edge, between 1 and
+   * #MAX_STEPS
+   */
+  ConstBuffer<GeoPoint> GetBoundary(unsigned steps=DEFAULT_STEPS) const;
+
+private:
+  void AddEdge(double a0, double b0, double a1, double b1) {
+    edges.append({a0, b0, a1, b1});
+  }
+
+  gcc_pure
+  GeoPoint GetEdgePoint(const Edge &edge, double t) const;
+
+  void BuildEdges();
+  void UpdateBounds() const;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "TaskOptTargets.hpp"
+#include "Task/Ordered/Points/AATPoint.hpp"
+#include "Task/Ordered/Points/StartPoint.hpp"
+#include "Task/Ordered/AATIsolineSegment.hpp"
+#include "GlideSolvers/GlideState.hpp"
+#include "GlideSolvers/GlideResult.hpp"
+#include "GlideSolvers/MacCready.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <assert.h>
+
+TaskOptTargets::TaskOptTargets(const std::vector<OrderedTaskPoint *> &tps,
+                               const unsigned _active_index,
+                               const AircraftState &_aircraft,
+                               const GlideSettings &_settings,
+                               const GlidePolar &gp,
+                               const FlatProjection &_projection,
+                               StartPoint *ts)
+  :task_points(tps), active_index(_active_index),
+   aircraft(_aircraft), settings(_settings), glide_polar(gp),
+   projection(_projection),
+   tp_start(ts)
+{
+  assert(active_index < task_points.size());
+  assert(aircraft.location.IsValid());
+
+  const OrderedTaskPoint &first = *task_points[active_index];
+
+  /* ignore the travel to the start point, like
+     TaskMacCreadyRemaining does */
+  skip_first_leg = active_index == 0 &&
+    first.GetType() == TaskPointType::START && !first.HasEntered();
+  if (skip_first_leg) {
+    origin = first.GetLocation();
+    origin_altitude = first.GetElevation();
+  } else {
+    origin = aircraft.location;
+    origin_altitude = aircraft.altitude;
+  }
+
+  for (unsigned i = active_index, n = task_points.size();
+       i != n && !locations.full(); ++i) {
+    locations.push_back(task_points[i]->GetLocationRemaining());
+    min_heights.push_back(std::max(0., task_points[i]->GetElevation()));
+  }
+
+  for (unsigned i = 0; i < locations.size(); ++i)
+    legs.push_back(CalcLegVector(i, locations[i]));
+
+  time_elapsed = CalcTimeElapsed(legs.begin());
+}
+
+GeoVector
+TaskOptTargets::CalcLegVector(unsigned i, const GeoPoint &destination) const
+{
+  if (i > 0)
+    return locations[i - 1].DistanceBearing(destination);
+
+  GeoVector vector = origin.DistanceBearing(destination);
+  if (skip_first_leg)
+    vector.distance = 0;
+  return vector;
+}
+
+double
+TaskOptTargets::CalcTimeElapsed(const GeoVector *_legs) const
+{
+  double altitude = origin_altitude;
+  double time = 0;
+
+  for (unsigned i = 0; i < locations.size(); ++i) {
+    const GlideState gs(_legs[i], min_heights[i], altitude, aircraft.wind);
+    const GlideResult gr = MacCready::Solve(settings, glide_polar, gs);
+    if (!gr.IsOk())
+      return std::numeric_limits<double>::max();
+
+    time += gr.time_elapsed;
+
+    /* see TaskMacCready::glide_solution() */
+    altitude = min_heights[i];
+    if (gr.altitude_difference > 0)
+      altitude += gr.altitude_difference;
+  }
+
+  return time;
+}
+
+double
+TaskOptTargets::GetTimeElapsed() const
+{
+  return time_elapsed < std::numeric_limits<double>::max()
+    ? time_elapsed
+    : -1;
+}
+
+void
+TaskOptTargets::EvaluateCandidates(unsigned i, const GeoPoint *candidates,
+                                   unsigned n, double *times) const
+{
+  assert(i < locations.size());
+
+  GeoVector candidate_legs[MAX_SIZE];
+  std::copy(legs.begin(), legs.end(), candidate_legs);
+
+  for (unsigned j = 0; j < n; ++j) {
+    /* only the two legs adjacent to the target change */
+    candidate_legs[i] = CalcLegVector(i, candidates[j]);
+    if (i + 1 < locations.size())
+      candidate_legs[i + 1] = candidates[j].DistanceBearing(locations[i + 1]);
+
+    times[j] = CalcTimeElapsed(candidate_legs);
+  }
+}
+
+bool
+TaskOptTargets::SearchIsoline(unsigned i)
+{
+  AATPoint &ap = (AATPoint &)*task_points[active_index + i];
+  if (ap.IsTargetLocked())
+    return false;
+
+  const AATIsolineSegment iso(ap, projection);
+  if (!iso.IsValid())
+    return false;
+
+  double best_time = time_elapsed;
+  GeoPoint best_location = GeoPoint::Invalid();
+
+  /* evaluate a grid of isoline positions, then repeat with a finer
+     grid around the best one */
+  double t_min = 0.02, t_max = 0.98;
+  for (unsigned step = 0; step < NUM_STEPS; ++step) {
+    const double dt = (t_max - t_min) / (NUM_CANDIDATES - 1);
+
+    GeoPoint candidates[NUM_CANDIDATES];
+    for (unsigned j = 0; j < NUM_CANDIDATES; ++j)
+      candidates[j] = iso.Parametric(t_min + dt * j);
+
+    double times[NUM_CANDIDATES];
+    EvaluateCandidates(i, candidates, NUM_CANDIDATES, times);
+
+    const unsigned j = std::distance(times,
+                                     std::min_element(times,
+                                                      times + NUM_CANDIDATES));
+    if (times[j] < best_time) {
+      best_time = times[j];
+      best_location = candidates[j];
+    }
+
+    const double t = t_min + dt * j;
+    t_min = std::max(0.02, t - dt);
+    t_max = std::min(0.98, t + dt);
+  }
+
+  if (!best_location.IsValid())
+    return false;
+
+  ap.SetTarget(best_location);
+  locations[i] = best_location;
+  legs[i] = CalcLegVector(i, best_location);
+  if (i + 1 < locations.size())
+    legs[i + 1] = best_location.DistanceBearing(locations[i + 1]);
+  time_elapsed = best_time;
+  return true;
+}
+
+bool
+TaskOptTargets::Search()
+{
+  if (time_elapsed >= std::numeric_limits<double>::max())
+    /* no valid solution to start with */
+    return false;
+
+  bool modified = false;
+  for (unsigned i = 0; i < locations.size(); ++i)
+    if (task_points[active_index + i]->HasTarget() && SearchIsoline(i))
+      modified = true;
+
+  if (modified)
+    tp_start->ScanDistanceRemaining(aircraft.location);
+
+  return modified;
+}
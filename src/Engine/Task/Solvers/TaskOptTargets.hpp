@@ -0,0 +1,154 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef TASKOPTTARGETS_HPP
+#define TASKOPTTARGETS_HPP
+
+#include "Util/StaticArray.hxx"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/GeoVector.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+struct GlideSettings;
+class FlatProjection;
+class OrderedTaskPoint;
+class StartPoint;
+
+/**
+ * Adjust the targets of all remaining AAT points along their isolines
+ * to minimise the elapsed time to finish.
+ *
+ * The remaining task is copied into plain arrays of locations and leg
+ * vectors, so each candidate target is evaluated without modifying
+ * the task points and without rescanning the task.  All candidates of
+ * one isoline are evaluated as one batch; only the best one is
+ * applied to its AATPoint, which then defines the isolines of its
+ * neighbours.
+ */
+class TaskOptTargets {
+  static constexpr unsigned MAX_SIZE = 32;
+
+  /** Number of isoline positions evaluated per refinement step */
+  static constexpr unsigned NUM_CANDIDATES = 9;
+
+  /** Number of refinement steps per isoline */
+  static constexpr unsigned NUM_STEPS = 3;
+
+  const std::vector<OrderedTaskPoint *> &task_points;
+  const unsigned active_index;
+
+  const AircraftState &aircraft;
+  const GlideSettings &settings;
+  const GlidePolar &glide_polar;
+  const FlatProjection &projection;
+
+  /** Start of task (to initiate scans) */
+  StartPoint *const tp_start;
+
+  /** Start of the first remaining leg */
+  GeoPoint origin;
+
+  /** Altitude at #origin */
+  double origin_altitude;
+
+  /** Ignore the travel to the start point? */
+  bool skip_first_leg;
+
+  /** Remaining locations, beginning with the active task point */
+  StaticArray<GeoPoint, MAX_SIZE> locations;
+
+  /** Minimum arrival height of each remaining task point */
+  StaticArray<double, MAX_SIZE> min_heights;
+
+  /** Vector of each remaining leg */
+  StaticArray<GeoVector, MAX_SIZE> legs;
+
+  /** Elapsed time with the current #legs */
+  double time_elapsed;
+
+public:
+  TaskOptTargets(const std::vector<OrderedTaskPoint *> &tps,
+                 unsigned active_index,
+                 const AircraftState &aircraft,
+                 const GlideSettings &settings, const GlidePolar &gp,
+                 const FlatProjection &projection,
+                 StartPoint *ts);
+
+  /**
+   * Search the isolines of all remaining AAT points whose target is
+   * not locked.  Targets are only moved if that reduces the elapsed
+   * time.
+   *
+   * @return true if at least one target has been moved
+   */
+  bool Search();
+
+  /**
+   * Calculate the elapsed time for the remaining task with the
+   * current targets.
+   *
+   * @return the elapsed time [s], or a negative value if the task
+   * cannot be solved
+   */
+  gcc_pure
+  double GetTimeElapsed() const;
+
+private:
+  /**
+   * Calculate the vector of the given remaining leg ending at the
+   * given location.
+   */
+  gcc_pure
+  GeoVector CalcLegVector(unsigned i, const GeoPoint &destination) const;
+
+  /**
+   * Calculate the elapsed time for the remaining task with the given
+   * leg vectors.
+   *
+   * @return the elapsed time [s], or std::numeric_limits::max() if
+   * the task cannot be solved
+   */
+  gcc_pure
+  double CalcTimeElapsed(const GeoVector *legs) const;
+
+  /**
+   * Calculate the elapsed time for each of the given target
+   * locations of one task point.  The evaluations are independent of
+   * each other.
+   */
+  void EvaluateCandidates(unsigned i, const GeoPoint *candidates,
+                          unsigned n, double *times) const;
+
+  /**
+   * Search the isoline of one AAT point.
+   *
+   * @param i the index in #locations
+   * @return true if the target has been moved
+   */
+  bool SearchIsoline(unsigned i);
+};
+
+#endif
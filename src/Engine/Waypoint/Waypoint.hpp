@@ -25,6 +25,7 @@
 
 #include "Origin.hpp"
 #include "Util/tstring.hpp"
+#include "Util/SharedString.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "Geo/Flat/FlatGeoPoint.hpp"
 #include "RadioFrequency.hpp"
@@ -120,8 +121,11 @@ struct Waypoint {
 
   /** Name of waypoint */
   tstring name;
-  /** Additional comment text for waypoint */
-  tstring comment;
+  /**
+   * Additional comment text for waypoint.  Waypoints loaded from a
+   * file share the buffers of equal comments.
+   */
+  SharedString comment;
   /** Airfield or additional (long) details */
   tstring details;
   /** Additional files to be displayed in the WayointDetails dialog */
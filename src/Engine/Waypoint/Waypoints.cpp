@@ -22,10 +22,20 @@
 
 #include "Waypoints.hpp"
 #include "WaypointVisitor.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
 #include "Util/StringUtil.hpp"
 
+#include <algorithm>
+#include <iterator>
+
+#include <stdint.h>
+
+#include <math.h>
+
 // global, used for test harness
 unsigned n_queries = 0;
+unsigned n_best_first_searches = 0;
 
 /**
  * Container accessor to allow a WaypointVisitor to visit
@@ -72,6 +82,23 @@ struct VisitorAdapter {
   }
 };
 
+/**
+ * Passes only the waypoints inside a box to the contained visitor.
+ */
+struct BoundingBoxVisitorAdapter {
+  const FlatBoundingBox &box;
+  WaypointVisitor &visitor;
+
+  BoundingBoxVisitorAdapter(const FlatBoundingBox &_box,
+                            WaypointVisitor &_visitor)
+    :box(_box), visitor(_visitor) {}
+
+  void operator()(const WaypointPtr &wp) {
+    if (box.IsInside(wp->flat_location))
+      visitor.Visit(wp);
+  }
+};
+
 WaypointPtr
 Waypoints::WaypointNameTree::Get(const TCHAR *name) const
 {
@@ -118,6 +145,7 @@ Waypoints::WaypointNameTree::Remove(const WaypointPtr &wp)
 
 Waypoints::Waypoints()
   :next_id(1),
+   index_changes(0),
    home(nullptr)
 {
 }
@@ -125,19 +153,120 @@ Waypoints::Waypoints()
 void
 Waypoints::Optimise()
 {
-  if (waypoint_tree.IsEmpty() || waypoint_tree.HaveBounds())
-    /* empty or already optimised */
+  if (waypoint_tree.IsEmpty())
     return;
 
-  task_projection.Update();
+  bool rebuild = index_changes > MAX_INDEX_CHANGES;
 
-  for (auto &i : waypoint_tree) {
-    // TODO: eliminate this const_cast hack
-    Waypoint &w = const_cast<Waypoint &>(*i);
-    w.Project(task_projection);
+  if (!waypoint_tree.HaveBounds()) {
+    task_projection.Update();
+
+    for (auto &i : waypoint_tree) {
+      // TODO: eliminate this const_cast hack
+      Waypoint &w = const_cast<Waypoint &>(*i);
+      w.Project(task_projection);
+    }
+
+    waypoint_tree.Optimise();
+
+    /* the flat locations have changed */
+    rebuild = true;
+  }
+
+  if (rebuild) {
+    waypoint_index.Build(waypoint_tree.begin(), waypoint_tree.end());
+    index_added.clear();
+    index_changes = 0;
+    BuildTextIndex();
+  }
+}
+
+void
+Waypoints::AddToWaypointIndex(const WaypointPtr &wp)
+{
+  if (waypoint_index.IsEmpty() || !waypoint_tree.HaveBounds())
+    /* the next Optimise() indexes it */
+    return;
+
+  index_added.push_back(wp);
+  ++index_changes;
+}
+
+void
+Waypoints::RemoveFromWaypointIndex(const WaypointPtr &wp)
+{
+  auto i = std::find(index_added.begin(), index_added.end(), wp);
+  if (i != index_added.end())
+    index_added.erase(i);
+  else if (waypoint_index.Remove(wp))
+    ++index_changes;
+}
+
+void
+Waypoints::BuildTextIndex()
+{
+  ClearTextIndex();
+
+  text_index_waypoints.assign(waypoint_tree.begin(), waypoint_tree.end());
+  std::sort(text_index_waypoints.begin(), text_index_waypoints.end(),
+            [](const WaypointPtr &a, const WaypointPtr &b){
+              return a->id < b->id;
+            });
+
+  text_index_ids.reserve(text_index_waypoints.size());
+  for (const auto &wp : text_index_waypoints) {
+    text_index_ids.push_back(wp->id);
+    text_index.Add(wp->name.c_str());
+    text_index.Add(wp->comment.c_str());
   }
 
-  waypoint_tree.Optimise();
+  text_index.Build();
+}
+
+void
+Waypoints::ClearTextIndex()
+{
+  text_index.Clear();
+  text_index_waypoints.clear();
+  text_index_ids.clear();
+  text_index_added.Clear();
+  text_index_added_waypoints.clear();
+}
+
+void
+Waypoints::AddToTextIndex(const WaypointPtr &wp)
+{
+  if (!text_index.IsBuilt() || !waypoint_tree.HaveBounds())
+    /* the next Optimise() indexes it */
+    return;
+
+  text_index_added_waypoints.push_back(wp);
+  text_index_added.Add(wp->name.c_str());
+  text_index_added.Add(wp->comment.c_str());
+}
+
+void
+Waypoints::RemoveFromTextIndex(const WaypointPtr &wp)
+{
+  /* only release the reference; the strings stay in the index until
+     it is rebuilt, and VisitText() skips them */
+
+  const auto i = std::lower_bound(text_index_ids.begin(),
+                                  text_index_ids.end(), wp->id);
+  if (i != text_index_ids.end() && *i == wp->id) {
+    auto &indexed = text_index_waypoints[i - text_index_ids.begin()];
+    if (indexed == wp) {
+      indexed = nullptr;
+      return;
+    }
+  }
+
+  /* Replace() keeps the id, so the waypoint may also have been added
+     later */
+  auto j = std::find(text_index_added_waypoints.begin(),
+                     text_index_added_waypoints.end(), wp);
+  if (j != text_index_added_waypoints.end())
+    *j = nullptr;
 }
 
 void
@@ -158,12 +287,87 @@ Waypoints::Append(WaypointPtr wp)
   task_projection.Scan(w.location);
   w.id = next_id++;
 
+  AddToWaypointIndex(wp);
+  AddToTextIndex(wp);
   waypoint_tree.Add(wp);
   name_tree.Add(wp);
 
   ++serial;
 }
 
+void
+Waypoints::Append(std::vector<Waypoint> &&waypoints)
+{
+  if (waypoints.empty())
+    return;
+
+  if (waypoint_tree.HaveBounds())
+    ScheduleOptimise();
+
+  /* the waypoints of a file often have the same comment, e.g. the
+     type of an outlanding field; let them share one copy */
+  SharedStringPool comments;
+  for (auto &wp : waypoints)
+    wp.comment = comments.Intern(wp.comment);
+
+  for (auto i = waypoints.begin(); i != waypoints.end();) {
+    const auto n = std::min<size_t>(BLOCK_SIZE, waypoints.end() - i);
+    const auto block =
+      std::make_shared<std::vector<Waypoint>>(std::make_move_iterator(i),
+                                              std::make_move_iterator(i + n));
+    for (auto &wp : *block)
+      Append(WaypointPtr(block, &wp));
+
+    i += n;
+  }
+
+  waypoints.clear();
+}
+
+gcc_const
+static uint64_t
+SquareDistance(const FlatGeoPoint &a, const FlatGeoPoint &b)
+{
+  const int64_t dx = int64_t(a.x) - b.x;
+  const int64_t dy = int64_t(a.y) - b.y;
+  return dx * dx + dy * dy;
+}
+
+/**
+ * Find the nearest waypoint within the given flat range, in the
+ * #WaypointIndex and in the list of waypoints added since it was
+ * built.
+ */
+template<typename Index, typename P>
+static WaypointPtr
+FindNearestIf(const Index &index, const std::vector<WaypointPtr> &added,
+              const FlatGeoPoint &location, unsigned range,
+              const P &predicate)
+{
+  WaypointPtr nearest;
+
+  /* only waypoints closer than this are accepted */
+  uint64_t best_distance = uint64_t(range) * range + 1;
+
+  const auto found =
+    index.FindNearestIf(typename Index::Point(location.x, location.y),
+                        range, predicate);
+  if (found != index.end()) {
+    nearest = *found;
+    best_distance = SquareDistance(nearest->flat_location, location);
+  }
+
+  for (const auto &wp : added) {
+    const uint64_t distance = SquareDistance(wp->flat_location, location);
+    if (distance < best_distance && predicate(wp)) {
+      nearest = wp;
+      best_distance = distance;
+    }
+  }
+
+  return nearest;
+}
+
 WaypointPtr
 Waypoints::GetNearest(const GeoPoint &loc, double range) const
 {
@@ -173,6 +377,11 @@ Waypoints::GetNearest(const GeoPoint &loc, double range) const
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
   const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  if (!waypoint_index.IsEmpty())
+    return FindNearestIf(waypoint_index, index_added, flat_location, mrange,
+                         [](const WaypointPtr &){ return true; });
+
   const auto found = waypoint_tree.FindNearest(point, mrange);
 
   if (found.first == waypoint_tree.end())
@@ -203,10 +412,16 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
   const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+  const auto ptr_predicate = [predicate](const WaypointPtr &ptr){
+    return predicate(*ptr);
+  };
+
+  if (!waypoint_index.IsEmpty())
+    return FindNearestIf(waypoint_index, index_added, flat_location, mrange,
+                         ptr_predicate);
+
   const auto found = waypoint_tree.FindNearestIf(point, mrange,
-                                                 [predicate](const WaypointPtr &ptr){
-                                                   return predicate(*ptr);
-                                                 });
+                                                 ptr_predicate);
 
   if (found.first == waypoint_tree.end())
     return nullptr;
@@ -214,6 +429,119 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
   return *found.first;
 }
 
+static bool
+AlwaysTrue(const Waypoint &)
+{
+  return true;
+}
+
+unsigned
+Waypoints::VisitNearest(const GeoPoint &loc, double range,
+                        unsigned max_results, WaypointVisitor &visitor) const
+{
+  return VisitNearestIf(loc, range, max_results, AlwaysTrue, visitor);
+}
+
+/**
+ * The best-first search of PackedRTree::VisitNearestIf() is only
+ * faster than visiting the whole range and sorting the matches if
+ * there are many waypoints within range.  "NearestWaypoints
+ * --benchmark" puts the break-even point at 50 to 90 waypoints.
+ */
+static constexpr unsigned NEAREST_SEARCH_MIN_CANDIDATES = 64;
+
+/**
+ * Estimate the number of waypoints within the given flat range,
+ * assuming that they are spread evenly over the bounds of the index.
+ */
+template<typename Index>
+gcc_pure
+static double
+EstimateWithinRange(const Index &index, unsigned range)
+{
+  const auto &bounds = index.GetBounds();
+  const double width = std::max(double(bounds.right) - bounds.left, 1.);
+  const double height = std::max(double(bounds.bottom) - bounds.top, 1.);
+  const double diameter = 2. * range;
+  return index.size() * std::min(diameter, width) * std::min(diameter, height)
+    * (M_PI / 4) / (width * height);
+}
+
+unsigned
+Waypoints::VisitNearestIf(const GeoPoint &loc, double range,
+                          unsigned max_results,
+                          bool (*predicate)(const Waypoint &),
+                          WaypointVisitor &visitor) const
+{
+  if (IsEmpty() || max_results == 0)
+    return 0;
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  const auto ptr_predicate = [predicate](const WaypointPtr &ptr){
+    return predicate(*ptr);
+  };
+
+  std::vector<std::pair<uint64_t, const WaypointPtr *>> found;
+  auto add = [&found, flat_location](const WaypointPtr &ptr){
+    found.emplace_back(SquareDistance(ptr->flat_location, flat_location),
+                       &ptr);
+  };
+  auto collect = [&add, &ptr_predicate](const WaypointPtr &ptr){
+    if (ptr_predicate(ptr))
+      add(ptr);
+  };
+
+  const WaypointIndex::Point point(flat_location.x, flat_location.y);
+
+  if (!waypoint_index.IsEmpty() &&
+      EstimateWithinRange(waypoint_index, mrange) >=
+      NEAREST_SEARCH_MIN_CANDIDATES) {
+    ++n_best_first_searches;
+
+    if (index_added.empty()) {
+      VisitorAdapter adapter(visitor);
+      return waypoint_index.VisitNearestIf(point, mrange, max_results,
+                                           ptr_predicate, adapter);
+    }
+
+    /* the nearest ones from the index, to be merged with the
+       waypoints added since it was built */
+    found.reserve(max_results + index_added.size());
+    waypoint_index.VisitNearestIf(point, mrange, max_results,
+                                  ptr_predicate, add);
+  } else {
+    /* few waypoints within range, or not optimised: collect all
+       matching waypoints within range and sort them */
+    found.reserve(NEAREST_SEARCH_MIN_CANDIDATES);
+
+    if (!waypoint_index.IsEmpty())
+      waypoint_index.VisitWithinRange(point, mrange, collect);
+    else
+      waypoint_tree.VisitWithinRange(WaypointTree::Point(flat_location.x,
+                                                         flat_location.y),
+                                     mrange, collect);
+  }
+
+  const uint64_t square_range = uint64_t(mrange) * mrange;
+  for (const auto &wp : index_added)
+    if (SquareDistance(wp->flat_location, flat_location) <= square_range)
+      collect(wp);
+
+  const unsigned n = std::min<unsigned>(max_results, found.size());
+  std::partial_sort(found.begin(), found.begin() + n, found.end(),
+                    [](const std::pair<uint64_t, const WaypointPtr *> &a,
+                       const std::pair<uint64_t, const WaypointPtr *> &b){
+                      return a.first < b.first;
+                    });
+
+  for (unsigned i = 0; i < n; ++i)
+    visitor.Visit(*found[i].second);
+
+  return n;
+}
+
 WaypointPtr
 Waypoints::LookupName(const TCHAR *name) const
 {
@@ -283,7 +611,53 @@ Waypoints::VisitWithinRange(const GeoPoint &loc, const double range,
 
   WaypointEnvelopeVisitor wve(&visitor);
 
-  waypoint_tree.VisitWithinRange(point, mrange, wve);
+  if (waypoint_index.IsEmpty()) {
+    waypoint_tree.VisitWithinRange(point, mrange, wve);
+    return;
+  }
+
+  waypoint_index.VisitWithinRange(WaypointIndex::Point(point.x, point.y),
+                                  mrange, wve);
+
+  const uint64_t square_range = uint64_t(mrange) * mrange;
+  for (const auto &wp : index_added)
+    if (SquareDistance(wp->flat_location, flat_location) <= square_range)
+      wve(wp);
+}
+
+void
+Waypoints::VisitWithinBounds(const GeoBounds &bounds,
+                             WaypointVisitor &visitor) const
+{
+  if (IsEmpty())
+    return; // nothing to do
+
+  /* the flat projection is equirectangular, so the bounds are a
+     rectangle in flat coordinates, and the circle around it is what
+     the QuadTree can search for */
+  const FlatBoundingBox box = task_projection.Project(bounds);
+
+  if (!waypoint_index.IsEmpty()) {
+    VisitorAdapter adapter(visitor);
+    waypoint_index.VisitWithinBox(WaypointIndex::Box(box.GetLeft(),
+                                                     box.GetBottom(),
+                                                     box.GetRight(),
+                                                     box.GetTop()),
+                                  adapter);
+
+    BoundingBoxVisitorAdapter added_adapter(box, visitor);
+    for (const auto &wp : index_added)
+      added_adapter(wp);
+    return;
+  }
+
+  const FlatGeoPoint center = box.GetCenter();
+  const WaypointTree::Point point(center.x, center.y);
+  const unsigned range =
+    unsigned(hypot(box.GetWidth(), box.GetHeight()) / 2) + 1;
+
+  BoundingBoxVisitorAdapter adapter(box, visitor);
+  waypoint_tree.VisitWithinRange(point, range, adapter);
 }
 
 void
@@ -293,12 +667,109 @@ Waypoints::VisitNamePrefix(const TCHAR *prefix,
   name_tree.VisitNormalisedPrefix(prefix, visitor);
 }
 
+struct TextMatch {
+  const WaypointPtr *waypoint;
+  unsigned errors;
+
+  /**
+   * Was the text found in the comment (and not in the name)?
+   */
+  bool comment;
+
+  /**
+   * Fewer errors first, and a match in the name before one in the
+   * comment.
+   */
+  bool IsBetterThan(const TextMatch &other) const {
+    return errors != other.errors
+      ? errors < other.errors
+      : comment < other.comment;
+  }
+};
+
+/**
+ * Search a #TrigramIndex whose string 2*i is the name and 2*i+1 the
+ * comment of waypoints[i], and append the better match of each
+ * waypoint to #dest.  Null waypoints (erased ones) are skipped.
+ *
+ * @param built search the posting lists (true) or scan all strings
+ * (false)?
+ */
+static void
+SearchText(const TrigramIndex &index, const std::vector<WaypointPtr> &waypoints,
+           bool built, const TCHAR *text, unsigned max_errors,
+           std::vector<TextMatch> &dest)
+{
+  std::vector<TrigramIndex::Match> matches;
+  if (built)
+    index.Search(text, max_errors, matches);
+  else
+    index.Scan(text, max_errors, matches);
+
+  /* matches are ordered by id, so the name and the comment of a
+     waypoint are adjacent */
+  const auto begin = dest.size();
+  for (const auto &i : matches) {
+    const WaypointPtr &wp = waypoints[i.id / 2];
+    if (wp == nullptr)
+      continue;
+
+    const TextMatch match{&wp, i.errors, i.id % 2 != 0};
+    if (dest.size() > begin && dest.back().waypoint == &wp) {
+      if (match.IsBetterThan(dest.back()))
+        dest.back() = match;
+    } else
+      dest.push_back(match);
+  }
+}
+
+unsigned
+Waypoints::VisitText(const TCHAR *text, unsigned max_errors,
+                     unsigned max_results, WaypointVisitor &visitor) const
+{
+  std::vector<TextMatch> matches;
+
+  /* not optimised yet: scan all waypoints */
+  TrigramIndex scan_index;
+  std::vector<WaypointPtr> scan_waypoints;
+
+  if (text_index.IsBuilt()) {
+    SearchText(text_index, text_index_waypoints, true,
+               text, max_errors, matches);
+    SearchText(text_index_added, text_index_added_waypoints, false,
+               text, max_errors, matches);
+  } else {
+    scan_waypoints.assign(waypoint_tree.begin(), waypoint_tree.end());
+    for (const auto &wp : scan_waypoints) {
+      scan_index.Add(wp->name.c_str());
+      scan_index.Add(wp->comment.c_str());
+    }
+
+    SearchText(scan_index, scan_waypoints, false, text, max_errors, matches);
+  }
+
+  std::stable_sort(matches.begin(), matches.end(),
+                   [](const TextMatch &a, const TextMatch &b){
+                     return a.IsBetterThan(b);
+                   });
+
+  const unsigned n = std::min<unsigned>(max_results, matches.size());
+  for (unsigned i = 0; i < n; ++i)
+    visitor.Visit(*matches[i].waypoint);
+
+  return n;
+}
+
 void
 Waypoints::Clear()
 {
   ++serial;
   home = nullptr;
   name_tree.Clear();
+  waypoint_index.Clear();
+  index_added.clear();
+  index_changes = 0;
+  ClearTextIndex();
   waypoint_tree.clear();
   next_id = 1;
 }
@@ -315,20 +786,24 @@ Waypoints::Erase(WaypointPtr &&wp)
                                        });
   assert(f.first != waypoint_tree.end());
 
+  RemoveFromWaypointIndex(wp);
+  RemoveFromTextIndex(wp);
   name_tree.Remove(std::move(wp));
   waypoint_tree.erase(f.first);
   ++serial;
 }
 
+template<typename P>
 void
-Waypoints::EraseUserMarkers()
+Waypoints::EraseIf(P &&predicate)
 {
-  waypoint_tree.EraseIf([this](const WaypointPtr &wp){
-      if (wp->origin == WaypointOrigin::USER &&
-          wp->type == Waypoint::Type::MARKER) {
+  waypoint_tree.EraseIf([this, &predicate](const WaypointPtr &wp){
+      if (predicate(wp)) {
         if (home == wp)
           home = nullptr;
 
+        RemoveFromWaypointIndex(wp);
+        RemoveFromTextIndex(wp);
         name_tree.Remove(wp);
         ++serial;
         return true;
@@ -337,6 +812,29 @@ Waypoints::EraseUserMarkers()
     });
 }
 
+void
+Waypoints::EraseUserMarkers()
+{
+  EraseIf([](const WaypointPtr &wp){
+      return wp->origin == WaypointOrigin::USER &&
+        wp->type == Waypoint::Type::MARKER;
+    });
+}
+
+void
+Waypoints::Erase(const std::vector<WaypointPtr> &list)
+{
+  if (list.empty())
+    return;
+
+  std::vector<WaypointPtr> sorted(list);
+  std::sort(sorted.begin(), sorted.end());
+
+  EraseIf([&sorted](const WaypointPtr &wp){
+      return std::binary_search(sorted.begin(), sorted.end(), wp);
+    });
+}
+
 void
 Waypoints::Replace(const WaypointPtr &orig, Waypoint &&replacement)
 {
@@ -364,6 +862,10 @@ Waypoints::Replace(const WaypointPtr &orig, Waypoint &&replacement)
                                        });
   assert(f.first != waypoint_tree.end());
 
+  RemoveFromWaypointIndex(orig);
+  RemoveFromTextIndex(orig);
+  AddToWaypointIndex(new_ptr);
+  AddToTextIndex(new_ptr);
   waypoint_tree.Replace(f.first, std::move(new_ptr));
 
   ++serial;
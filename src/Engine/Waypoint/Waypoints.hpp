@@ -24,12 +24,18 @@
 
 #include "Util/RadixTree.hpp"
 #include "Util/QuadTree.hpp"
+#include "Util/PackedRTree.hpp"
+#include "Util/TrigramIndex.hpp"
+#include "Util/SliceAllocator.hpp"
 #include "Util/Serial.hpp"
 #include "Ptr.hpp"
 #include "Waypoint.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 
+#include <vector>
+
 class WaypointVisitor;
+class GeoBounds;
 
 /**
  * Container for waypoints using kd-tree representation internally for
@@ -53,9 +59,25 @@ class Waypoints {
   };
 
   /**
-   * Type of KD-tree data structure for waypoint container
+   * Type of KD-tree data structure for waypoint container.  Its
+   * leaves are allocated in slices, instead of one heap block per
+   * waypoint.
+   */
+  typedef QuadTree<WaypointPtr, WaypointAccessor,
+                   SliceAllocator<WaypointPtr, 512u>> WaypointTree;
+
+  /**
+   * Type of the static index which is rebuilt by Optimise()
+   */
+  typedef PackedRTree<WaypointPtr, WaypointAccessor> WaypointIndex;
+
+  /**
+   * The number of waypoints which share one array in the batch
+   * Append().  A #WaypointPtr which outlives its container keeps
+   * its whole array alive, so this limits the memory held by task
+   * points and other references after a reload.
    */
-  typedef QuadTree<WaypointPtr, WaypointAccessor> WaypointTree;
+  static constexpr unsigned BLOCK_SIZE = 64;
 
   class WaypointNameTree : public RadixTree<WaypointPtr> {
   public:
@@ -75,7 +97,56 @@ class Waypoints {
   unsigned next_id;
 
   WaypointTree waypoint_tree;
+
+  /**
+   * The number of single changes after which Optimise() rebuilds
+   * #waypoint_index and #text_index.  Until then, a new marker does
+   * not cost a rebuild of the whole indexes with all threads
+   * suspended.
+   */
+  static constexpr unsigned MAX_INDEX_CHANGES = 64;
+
+  /**
+   * A packed copy of #waypoint_tree for fast spatial queries.  It is
+   * rebuilt by Optimise() whenever #waypoint_tree is (e.g. after a
+   * file load), and after #MAX_INDEX_CHANGES single changes.  While
+   * it is empty, queries fall back to #waypoint_tree.
+   */
+  WaypointIndex waypoint_index;
+
+  /**
+   * The waypoints added (or replaced) since #waypoint_index was
+   * built.  There are only a few, and the queries check each of them
+   * next to the index.
+   */
+  std::vector<WaypointPtr> index_added;
+
+  /**
+   * The number of single changes to #waypoint_index since it was
+   * built.
+   */
+  unsigned index_changes;
+
   WaypointNameTree name_tree;
+
+  /**
+   * Trigram index of the names and comments for VisitText().  String
+   * 2*i is the name and 2*i+1 the comment of
+   * #text_index_waypoints[i].  It is rebuilt by Optimise() together
+   * with #waypoint_index.  The waypoints are sorted by id (see #text_index_ids), and
+   * erased ones are reset to nullptr.
+   */
+  TrigramIndex text_index;
+  std::vector<WaypointPtr> text_index_waypoints;
+  std::vector<unsigned> text_index_ids;
+
+  /**
+   * The waypoints appended since #text_index was built.  This index
+   * is small, so it is scanned instead of being built.
+   */
+  TrigramIndex text_index_added;
+  std::vector<WaypointPtr> text_index_added_waypoints;
+
   TaskProjection task_projection;
 
   WaypointPtr home;
@@ -116,11 +187,28 @@ public:
    * @param wp Waypoint to add to internal store
    */
   WaypointPtr Append(Waypoint &&wp) {
-    WaypointPtr ptr(new Waypoint(std::move(wp)));
+    WaypointPtr ptr = std::make_shared<Waypoint>(std::move(wp));
     Append(ptr);
     return ptr;
   }
 
+  /**
+   * Add a batch of waypoints, e.g. a whole file.  Unlike a series of
+   * Append() calls, this never inserts into an optimised QuadTree
+   * one by one; the tree is flattened once and rebuilt by the next
+   * Optimise() call.  The vector is cleared.
+   *
+   * Equal comments are merged, so they share one buffer.  The
+   * waypoints are moved into arrays of #BLOCK_SIZE elements,
+   * which are shared by their #WaypointPtr instances; this saves one
+   * heap allocation per waypoint.  An array is freed when the last
+   * of its waypoints is gone, i.e. Erase() does not free the memory
+   * of a single one, and a waypoint which is still referenced after
+   * Clear() (e.g. by the task) keeps up to #BLOCK_SIZE waypoints
+   * alive.
+   */
+  void Append(std::vector<Waypoint> &&waypoints);
+
   /**
    * Erase waypoint from the internal store.  Requires Optimise() to
    * be called afterwards
@@ -129,6 +217,13 @@ public:
    */
   void Erase(WaypointPtr &&wp);
 
+  /**
+   * Erase all of the specified waypoints in one pass over the store.
+   * Unlike Erase(), this does not need an optimised tree.  Requires
+   * Optimise() to be called afterwards.
+   */
+  void Erase(const std::vector<WaypointPtr> &list);
+
   /**
    * Erase all waypoints with origin==WaypointOrigin::USER &&
    * type==Type::MARKER.
@@ -158,6 +253,9 @@ public:
    * Optimise the internal search tree after adding/removing elements.
    * Also performs projection to flat earth for new elements.
    * This updates the task_projection.
+   * After a bulk load (or many single changes), this rebuilds the
+   * packed index used by the spatial queries and the text index used
+   * by VisitText().
    *
    * Note: currently this code doesn't check for task projections
    * being modified from multiple calls to Optimise() so it should
@@ -297,12 +395,35 @@ public:
   void VisitWithinRange(const GeoPoint &loc, double range,
                         WaypointVisitor &visitor) const;
 
+  /**
+   * Call visitor function on waypoints inside the given bounding
+   * box.
+   */
+  void VisitWithinBounds(const GeoBounds &bounds,
+                         WaypointVisitor &visitor) const;
+
   /**
    * Call visitor function on waypoints with the specified name
    * prefix.
    */
   void VisitNamePrefix(const TCHAR *prefix, WaypointVisitor& visitor) const;
 
+  /**
+   * Call visitor function on waypoints whose name or comment contains
+   * the specified text.  Case and all characters except letters and
+   * digits are ignored, and up to max_errors typos (inserted, deleted
+   * or replaced characters) are tolerated.  The best matches are
+   * visited first: fewer errors, and a match in the name before one
+   * in the comment.
+   *
+   * The text index is built by Optimise(); until then, this method
+   * scans all waypoints.
+   *
+   * @return the number of waypoints visited
+   */
+  unsigned VisitText(const TCHAR *text, unsigned max_errors,
+                     unsigned max_results, WaypointVisitor &visitor) const;
+
   /**
    * Returns a set of possible characters following the specified
    * prefix.
@@ -353,6 +474,32 @@ public:
   WaypointPtr GetNearestIf(const GeoPoint &loc, double range,
                            bool (*predicate)(const Waypoint &)) const;
 
+  /**
+   * Call visitor function on the nearest waypoints within range,
+   * nearest first.  Like GetNearest(), this compares flat-earth
+   * distances.  Small ranges are answered by sorting all waypoints
+   * within range, large ones by a best-first search of the index.
+   *
+   * @param loc Location from which to search
+   * @param range Distance in meters of search radius
+   * @param max_results Maximum number of waypoints to visit
+   * @param visitor Visitor to be called on the waypoints
+   *
+   * @return the number of waypoints visited
+   */
+  unsigned VisitNearest(const GeoPoint &loc, double range,
+                        unsigned max_results,
+                        WaypointVisitor &visitor) const;
+
+  /**
+   * Like VisitNearest(), but skips waypoints which do not match the
+   * predicate; these do not count towards max_results.
+   */
+  unsigned VisitNearestIf(const GeoPoint &loc, double range,
+                          unsigned max_results,
+                          bool (*predicate)(const Waypoint &),
+                          WaypointVisitor &visitor) const;
+
   /**
    * Access first waypoint in store, for use in iterators.
    *
@@ -370,6 +517,18 @@ public:
   const_iterator end() const {
     return waypoint_tree.end();
   }
+
+private:
+  template<typename P>
+  void EraseIf(P &&predicate);
+
+  void AddToWaypointIndex(const WaypointPtr &wp);
+  void RemoveFromWaypointIndex(const WaypointPtr &wp);
+
+  void BuildTextIndex();
+  void ClearTextIndex();
+  void AddToTextIndex(const WaypointPtr &wp);
+  void RemoveFromTextIndex(const WaypointPtr &wp);
 };
 
 #endif
@@ -0,0 +1,160 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "DouglasPeucker.hpp"
+#include "GeoPoint.hpp"
+#include "Flat/FlatPoint.hpp"
+#include "Util/AllocatedArray.hxx"
+
+#include <algorithm>
+#include <limits>
+
+#include <math.h>
+
+/**
+ * Returns the distance of #p from the segment #a..#b.
+ */
+gcc_pure
+static double
+SegmentDistance(FlatPoint p, FlatPoint a, FlatPoint b)
+{
+  const FlatPoint ab = b - a, ap = p - a;
+  const double length_squared = ab.DotProduct(ab);
+  if (length_squared <= 0)
+    return ap.Magnitude();
+
+  const double t = ap.DotProduct(ab) / length_squared;
+  if (t <= 0)
+    return ap.Magnitude();
+  if (t >= 1)
+    return (p - b).Magnitude();
+
+  return fabs(ab.CrossProduct(ap)) / sqrt(length_squared);
+}
+
+/**
+ * Rank the vertices between #first and #last (exclusive).  Indices
+ * are taken modulo the number of points, so a chain may wrap around
+ * the end of a closed polygon.
+ */
+static void
+RankChain(const FlatPoint *flat, unsigned n, float *ranks,
+          unsigned first, unsigned last)
+{
+  struct Range {
+    unsigned first, last;
+
+    /**
+     * The rank of the vertex which split this range off its parent.
+     * A vertex cannot survive a tolerance its parent does not
+     * survive.
+     */
+    float parent_rank;
+  };
+
+  /* the pending ranges are disjoint, so there are never more than n
+     of them */
+  AllocatedArray<Range> stack(n);
+  unsigned stack_size = 0;
+  stack[stack_size++] = { first, last, std::numeric_limits<float>::max() };
+
+  while (stack_size > 0) {
+    const Range range = stack[--stack_size];
+    if (range.last - range.first < 2)
+      continue;
+
+    const FlatPoint a = flat[range.first % n], b = flat[range.last % n];
+
+    unsigned max_index = range.first + 1;
+    double max_distance = -1;
+    for (unsigned i = range.first + 1; i < range.last; ++i) {
+      const double distance = SegmentDistance(flat[i % n], a, b);
+      if (distance > max_distance) {
+        max_distance = distance;
+        max_index = i;
+      }
+    }
+
+    const float rank = std::min(float(max_distance), range.parent_rank);
+    ranks[max_index % n] = rank;
+
+    stack[stack_size++] = { range.first, max_index, rank };
+    stack[stack_size++] = { max_index, range.last, rank };
+  }
+}
+
+void
+CalculateDouglasPeuckerRanks(const GeoPoint *points, unsigned n,
+                             bool closed, float *ranks)
+{
+  constexpr float max_rank = std::numeric_limits<float>::max();
+
+  if (n <= 3) {
+    std::fill_n(ranks, n, max_rank);
+    return;
+  }
+
+  /* project to a plane (radians, longitude scaled at the first
+     vertex) */
+  const GeoPoint &origin = points[0];
+  const double cos_latitude = origin.latitude.fastcosine();
+
+  AllocatedArray<FlatPoint> flat(n);
+  for (unsigned i = 0; i < n; ++i)
+    flat[i] = FlatPoint((points[i].longitude - origin.longitude)
+                        .AsDelta().Native() * cos_latitude,
+                        (points[i].latitude - origin.latitude).Native());
+
+  if (!closed) {
+    ranks[0] = ranks[n - 1] = max_rank;
+    RankChain(flat.begin(), n, ranks, 0, n - 1);
+    return;
+  }
+
+  /* a closed polygon is split at the vertex farthest from the first
+     one, and each of the two chains is ranked separately */
+
+  unsigned far = 1;
+  double far_distance = -1;
+  for (unsigned i = 1; i < n; ++i) {
+    const double distance = flat[i].Distance(flat[0]);
+    if (distance > far_distance) {
+      far_distance = distance;
+      far = i;
+    }
+  }
+
+  ranks[0] = ranks[far] = max_rank;
+  RankChain(flat.begin(), n, ranks, 0, far);
+  RankChain(flat.begin(), n, ranks, far, n);
+
+  /* keep the most significant remaining vertex at all levels, so the
+     simplified polygon never degenerates to a line */
+  unsigned best = 0;
+  for (unsigned i = 1; i < n; ++i)
+    if (ranks[i] != max_rank && (best == 0 || ranks[i] > ranks[best]))
+      best = i;
+
+  if (best > 0)
+    ranks[best] = max_rank;
+}
@@ -0,0 +1,51 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_GEO_DOUGLAS_PEUCKER_HPP
+#define XCSOAR_GEO_DOUGLAS_PEUCKER_HPP
+
+struct GeoPoint;
+
+/**
+ * Calculates the Douglas-Peucker rank of each vertex of a line or a
+ * polygon.  The rank is the largest tolerance (as an angle on the
+ * earth's surface, in radians) at which the Douglas-Peucker algorithm
+ * would keep the vertex.  Selecting all vertices whose rank is at
+ * least the desired tolerance yields the simplified shape, which
+ * allows picking any level of detail without running the algorithm
+ * again.
+ *
+ * The first and last vertex of a line are always kept (their rank is
+ * the largest float value).  Of a closed polygon, at least three
+ * vertices are always kept.
+ *
+ * @param closed true if the points describe a closed polygon, false
+ * for an open line
+ * @param ranks an array allocated by the caller, large enough to
+ * hold one rank per point
+ */
+void
+CalculateDouglasPeuckerRanks(const GeoPoint *points, unsigned n,
+                             bool closed, float *ranks);
+
+#endif
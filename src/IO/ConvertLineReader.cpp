@@ -141,3 +141,9 @@ ConvertLineReader::Tell() const
 {
   return source->Tell();
 }
+
+bool
+ConvertLineReader::Seek(long offset)
+{
+  return source->Seek(offset);
+}
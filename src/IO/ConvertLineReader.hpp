@@ -55,6 +55,7 @@ public:
   TCHAR *ReadLine() override;
   long GetSize() const override;
   long Tell() const override;
+  bool Seek(long offset) override;
 };
 
 #endif
@@ -38,5 +38,14 @@ FileLineReaderA::GetSize() const
 long
 FileLineReaderA::Tell() const
 {
-  return file.GetPosition();
+  /* the beginning of the next line, not the end of the buffer */
+  return file.GetPosition() - buffered.Read().size;
+}
+
+bool
+FileLineReaderA::Seek(long offset)
+{
+  file.Seek(offset);
+  buffered.Reset();
+  return true;
 }
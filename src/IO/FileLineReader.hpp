@@ -56,6 +56,7 @@ public:
   char *ReadLine() override;
   long GetSize() const override;
   long Tell() const override;
+  bool Seek(long offset) override;
 };
 
 class FileLineReader : public ConvertLineReader {
@@ -59,6 +59,15 @@ public:
   virtual long Tell() const {
     return -1;
   }
+
+  /**
+   * Continue reading at the specified position, which must have
+   * been obtained from Tell() after a ReadLine() call.  Returns false
+   * if this reader cannot seek.
+   */
+  virtual bool Seek(gcc_unused long offset) {
+    return false;
+  }
 };
 
 class TLineReader : public LineReader<TCHAR> {};
@@ -38,5 +38,14 @@ ZipLineReaderA::GetSize() const
 long
 ZipLineReaderA::Tell() const
 {
-  return zip.GetPosition();
+  /* the beginning of the next line, not the end of the buffer */
+  return zip.GetPosition() - buffered.Read().size;
+}
+
+bool
+ZipLineReaderA::Seek(long offset)
+{
+  zip.Seek(offset);
+  buffered.Reset();
+  return true;
 }
@@ -45,6 +45,7 @@ public:
   char *ReadLine() override;
   long GetSize() const override;
   long Tell() const override;
+  bool Seek(long offset) override;
 };
 
 class ZipLineReader : public ConvertLineReader {
@@ -63,6 +63,13 @@ ZipReader::GetPosition() const
   return zzip_tell(file);
 }
 
+void
+ZipReader::Seek(uint64_t offset)
+{
+  if (zzip_seek(file, offset, SEEK_SET) < 0)
+    throw std::runtime_error("Failed to seek in ZIP file");
+}
+
 size_t
 ZipReader::Read(void *data, size_t size)
 {
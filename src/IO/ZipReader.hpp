@@ -48,6 +48,11 @@ public:
   gcc_pure
   uint64_t GetPosition() const;
 
+  /**
+   * Throws std::runtime_errror on error.
+   */
+  void Seek(uint64_t offset);
+
   /* virtual methods from class Reader */
   size_t Read(void *data, size_t size) override;
 };
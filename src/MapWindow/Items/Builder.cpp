@@ -113,8 +113,14 @@ MapItemListBuilder::AddSelfIfNear(const GeoPoint &self, Angle bearing)
 void
 MapItemListBuilder::AddWaypoints(const Waypoints &waypoints)
 {
+  if (list.full())
+    return;
+
+  /* the list has room for only a few items; fill it with the
+     nearest waypoints, not with arbitrary ones within range */
   WaypointListBuilderVisitor waypoint_list_builder(list);
-  waypoints.VisitWithinRange(location, range, waypoint_list_builder);
+  waypoints.VisitNearest(location, range, list.capacity() - list.size(),
+                         waypoint_list_builder);
 }
 
 void
@@ -94,6 +94,20 @@ MapCanvas::PreparePolygon(const SearchPointVector &points)
   return true;
 }
 
+bool
+MapCanvas::PrepareClippedPolygon(const GeoPoint *points, unsigned num_points)
+{
+  if (num_points < 3)
+    return false;
+
+  num_raster_points = num_points;
+  raster_points.GrowDiscard(num_raster_points);
+  for (unsigned i = 0; i < num_raster_points; ++i)
+    raster_points[i] = projection.GeoToScreen(points[i]);
+
+  return true;
+}
+
 void
 MapCanvas::DrawPrepared()
 {
@@ -86,6 +86,13 @@ public:
   }
 
   bool PreparePolygon(const SearchPointVector &points);
+
+  /**
+   * Like PreparePolygon(), but the points have already been clipped
+   * by the caller.
+   */
+  bool PrepareClippedPolygon(const GeoPoint *points, unsigned num_points);
+
   void DrawPrepared();
 };
 
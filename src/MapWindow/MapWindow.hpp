@@ -37,6 +37,7 @@ Copyright_License {
 #include "Renderer/BackgroundRenderer.hpp"
 #include "Renderer/WaypointRenderer.hpp"
 #include "Renderer/TrailRenderer.hpp"
+#include "Engine/Task/Shapes/FAITriangleSector.hpp"
 #include "Compiler.h"
 #include "Weather/Features.hpp"
 #include "Tracking/SkyLines/Features.hpp"
@@ -54,6 +55,7 @@ class MapOverlay;
 class Waypoints;
 class Airspaces;
 class ProtectedTaskManager;
+class ProtectedRoutePlanner;
 class GlideComputer;
 class ContainerWindow;
 class NOAAStore;
@@ -146,6 +148,12 @@ protected:
 
   TrailRenderer trail_renderer;
 
+  /**
+   * The FAI triangle areas (left and right) over the contest leg,
+   * kept across frames.
+   */
+  FAITriangleSector fai_sectors[2];
+
   ProtectedTaskManager *task = nullptr;
   const ProtectedRoutePlanner *route_planner = nullptr;
   GlideComputer *glide_computer = nullptr;
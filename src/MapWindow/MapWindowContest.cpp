@@ -33,11 +33,10 @@ Copyright_License {
 
 static void
 RenderFAISectors(Canvas &canvas, const WindowProjection &projection,
-                 const GeoPoint &a, const GeoPoint &b,
-                 const FAITriangleSettings &settings)
+                 const FAITriangleSector (&sectors)[2])
 {
-  RenderFAISector(canvas, projection, a, b, false, settings);
-  RenderFAISector(canvas, projection, a, b, true, settings);
+  RenderFAISector(canvas, projection, sectors[0]);
+  RenderFAISector(canvas, projection, sectors[1]);
 }
 
 void
@@ -50,6 +49,11 @@ MapWindow::DrawContest(Canvas &canvas)
     const FAITriangleSettings &settings =
       GetMapSettings().fai_triangle_settings;
 
+    fai_sectors[0].Update(flying.release_location, flying.far_location,
+                          false, settings);
+    fai_sectors[1].Update(flying.release_location, flying.far_location,
+                          true, settings);
+
     /* draw FAI triangle areas */
     static constexpr Color fill_color = COLOR_YELLOW;
 #if defined(ENABLE_OPENGL) || defined(USE_MEMORY_CANVAS)
@@ -59,9 +63,7 @@ MapWindow::DrawContest(Canvas &canvas)
     canvas.Select(Brush(fill_color.WithAlpha(60)));
     canvas.Select(Pen(1, COLOR_BLACK.WithAlpha(90)));
 
-    RenderFAISectors(canvas, render_projection,
-                     flying.release_location, flying.far_location,
-                     settings);
+    RenderFAISectors(canvas, render_projection, fai_sectors);
 #else
     BufferCanvas buffer_canvas;
     buffer_canvas.Create(canvas);
@@ -74,9 +76,7 @@ MapWindow::DrawContest(Canvas &canvas)
     buffer_canvas.Select(Brush(fill_color));
 #endif
     buffer_canvas.SelectBlackPen();
-    RenderFAISectors(buffer_canvas, render_projection,
-                     flying.release_location, flying.far_location,
-                     settings);
+    RenderFAISectors(buffer_canvas, render_projection, fai_sectors);
     canvas.CopyAnd(buffer_canvas);
 #endif
   }
@@ -22,14 +22,15 @@ Copyright_License {
 */
 
 #include "MapWindow.hpp"
+#include "Computer/GlideComputer.hpp"
 
 void
 MapWindow::DrawWaypoints(Canvas &canvas)
 {
   waypoint_renderer.render(canvas, label_block,
                             render_projection, GetMapSettings().waypoint,
-                           GetComputerSettings().polar,
                             GetComputerSettings().task,
-                           Basic(), Calculated(),
-                            task, route_planner);
+                            Basic(), task,
+                            glide_computer != nullptr
+                            ? &glide_computer->GetReachability() : nullptr);
 }
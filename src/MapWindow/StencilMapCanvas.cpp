@@ -71,10 +71,19 @@ StencilMapCanvas::DrawSearchPointVector(const SearchPointVector &points)
     /* it's completely outside the screen */
     return;
 
+  DrawClippedPolygon(geo_points.begin(), size);
+}
+
+void
+StencilMapCanvas::DrawClippedPolygon(const GeoPoint *points, unsigned size)
+{
+  if (size < 3)
+    return;
+
   /* draw it all */
   BulkPixelPoint screen[size];
   for (unsigned i = 0; i < size; ++i)
-    screen[i] = proj.GeoToScreen(geo_points[i]);
+    screen[i] = proj.GeoToScreen(points[i]);
 
   buffer.DrawPolygon(&screen[0], size);
   if (use_stencil)
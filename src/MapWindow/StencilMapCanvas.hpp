@@ -67,6 +67,12 @@ public:
 
   void DrawSearchPointVector(const SearchPointVector &points);
 
+  /**
+   * Draw a polygon whose points have already been clipped by the
+   * caller.
+   */
+  void DrawClippedPolygon(const GeoPoint *points, unsigned size);
+
   void DrawCircle(const PixelPoint &center, unsigned radius);
 
   void Begin();
@@ -173,10 +173,10 @@ TargetMapWindow::DrawWaypoints(Canvas &canvas)
 
   way_point_renderer.render(canvas, label_block,
                             projection, settings,
-                            GetComputerSettings().polar,
                             GetComputerSettings().task,
-                            Basic(), Calculated(),
-                            task, nullptr);
+                            Basic(), task,
+                            glide_computer != nullptr
+                            ? &glide_computer->GetReachability() : nullptr);
 }
 
 void
@@ -0,0 +1,146 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceGeometryCache.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AbstractAirspace.hpp"
+#include "Geo/GeoClip.hpp"
+#include "Geo/DouglasPeucker.hpp"
+#include "Geo/SearchPointVector.hpp"
+
+#include <algorithm>
+
+inline bool
+AirspaceGeometryCache::IsValid(const WindowProjection &projection) const
+{
+  /* the two bounds checks also limit how far the map may be zoomed
+     in before the simplified polygons become too coarse */
+  return bounds.IsValid() &&
+    bounds.IsInside(projection.GetScreenBounds()) &&
+    projection.GetScreenBounds().Scale(2).IsInside(bounds);
+}
+
+const float *
+AirspaceGeometryCache::GetRanks(const AbstractAirspace &airspace)
+{
+  auto i = rank_offsets.find(&airspace);
+  if (i == rank_offsets.end()) {
+    const SearchPointVector &src = airspace.GetPoints();
+    const unsigned n = src.size();
+
+    clip_buffer.GrowDiscard(n);
+    for (unsigned j = 0; j < n; ++j)
+      clip_buffer[j] = src[j].GetLocation();
+
+    const unsigned offset = ranks.size();
+    ranks.resize(offset + n);
+    CalculateDouglasPeuckerRanks(clip_buffer.begin(), n, true,
+                                 ranks.data() + offset);
+
+    i = rank_offsets.emplace(&airspace, offset).first;
+  }
+
+  return ranks.data() + i->second;
+}
+
+inline void
+AirspaceGeometryCache::AddPolygon(Item &item, const AbstractAirspace &airspace,
+                                  Angle tolerance)
+{
+  const SearchPointVector &src = airspace.GetPoints();
+  const unsigned n_src = src.size();
+  if (n_src < 3)
+    return;
+
+  /* pick the level of detail: drop all vertices which would move the
+     outline by less than the tolerance */
+  const float *r = GetRanks(airspace);
+  const float min_rank = tolerance.Native();
+
+  clip_buffer.GrowDiscard(n_src * 3);
+  unsigned n = 0;
+  for (unsigned i = 0; i < n_src; ++i)
+    if (r[i] >= min_rank)
+      clip_buffer[n++] = src[i].GetLocation();
+
+  const GeoClip clip(bounds);
+  n = clip.ClipPolygon(clip_buffer.begin(), clip_buffer.begin(), n);
+  if (n < 3)
+    /* completely outside of the cached area */
+    return;
+
+  item.first_point = points.size();
+  item.n_points = n;
+  points.insert(points.end(), clip_buffer.begin(), clip_buffer.begin() + n);
+
+  GeoBounds b(clip_buffer[0]);
+  for (unsigned i = 1; i < n; ++i)
+    b.Extend(clip_buffer[i]);
+  item.bounds = b;
+}
+
+void
+AirspaceGeometryCache::Update(const Airspaces &_airspaces,
+                              const WindowProjection &projection)
+{
+  if (&_airspaces != airspaces || _airspaces.GetSerial() != serial) {
+    /* the airspaces have changed: flush everything, including the
+       ranks */
+    Invalidate();
+    airspaces = &_airspaces;
+    serial = _airspaces.GetSerial();
+  } else if (IsValid(projection))
+    /* cache is clean */
+    return;
+
+  bounds = projection.GetScreenBounds().Scale(1.5);
+  items.clear();
+  points.clear();
+
+  const Angle tolerance = projection.PixelsToAngle(1);
+
+  const GeoPoint center = bounds.GetCenter();
+  const double range = std::max(center.Distance(bounds.GetNorthWest()),
+                                center.Distance(bounds.GetSouthEast()));
+
+  for (const auto &i : _airspaces.QueryWithinRange(center, range)) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+
+    Item item;
+    item.airspace = &airspace;
+    item.first_point = item.n_points = 0;
+
+    if (airspace.GetShape() == AbstractAirspace::Shape::POLYGON) {
+      AddPolygon(item, airspace, tolerance);
+      if (item.n_points == 0)
+        continue;
+    } else {
+      item.bounds = airspace.GetGeoBounds();
+      if (!item.bounds.Overlaps(bounds))
+        continue;
+    }
+
+    items.push_back(item);
+  }
+}
@@ -0,0 +1,149 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_GEOMETRY_CACHE_HPP
+#define XCSOAR_AIRSPACE_GEOMETRY_CACHE_HPP
+
+#include "Geo/GeoBounds.hpp"
+#include "Util/Serial.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#include <vector>
+#include <unordered_map>
+
+class Airspaces;
+class AbstractAirspace;
+class WindowProjection;
+
+/**
+ * Caches the airspaces near the visible map area, with polygon
+ * outlines already clipped and simplified for the current map scale.
+ * The level of detail is picked from Douglas-Peucker ranks which are
+ * calculated only once per polygon.
+ * This avoids querying the airspace tree and clipping each polygon
+ * in every frame; the cache is rebuilt only when the airspace
+ * database changes, when the map is zoomed, or when the map was moved
+ * too far away.
+ */
+class AirspaceGeometryCache {
+public:
+  struct Item {
+    const AbstractAirspace *airspace;
+
+    /**
+     * The bounds of the cached outline (or of the whole airspace,
+     * if it is not a polygon).
+     */
+    GeoBounds bounds;
+
+    /**
+     * The range of this item's vertices in #points.  This is empty
+     * if the airspace is not a polygon or if it is completely outside
+     * of the cached area.
+     */
+    unsigned first_point, n_points;
+  };
+
+private:
+  const Airspaces *airspaces;
+  Serial serial;
+
+  /**
+   * The area covered by this cache; polygons are clipped at these
+   * bounds.
+   */
+  GeoBounds bounds;
+
+  std::vector<Item> items;
+  std::vector<GeoPoint> points;
+
+  /**
+   * The Douglas-Peucker ranks of the vertices of all polygons seen
+   * so far, see CalculateDouglasPeuckerRanks().  They do not depend
+   * on the projection and are kept until the airspaces change.
+   */
+  std::vector<float> ranks;
+
+  /**
+   * Maps each ranked polygon to the position of its first vertex
+   * rank in #ranks.
+   */
+  std::unordered_map<const AbstractAirspace *, unsigned> rank_offsets;
+
+  /**
+   * A variable-length buffer for clipping polygons.
+   */
+  AllocatedArray<GeoPoint> clip_buffer;
+
+public:
+  AirspaceGeometryCache()
+    :airspaces(nullptr), bounds(GeoBounds::Invalid()) {}
+
+  void Invalidate() {
+    airspaces = nullptr;
+    bounds.SetInvalid();
+    items.clear();
+    points.clear();
+    ranks.clear();
+    rank_offsets.clear();
+  }
+
+  /**
+   * Make sure the cache covers the visible area of the given
+   * projection, and rebuild it if necessary.
+   */
+  void Update(const Airspaces &airspaces, const WindowProjection &projection);
+
+  const std::vector<Item> &GetItems() const {
+    return items;
+  }
+
+  const GeoPoint *GetPoints(const Item &item) const {
+    return points.data() + item.first_point;
+  }
+
+  /**
+   * Invoke the visitor for each cached airspace which overlaps the
+   * given area.  Its parameters are the #AbstractAirspace and the
+   * cached (clipped) polygon vertices; the latter are empty for
+   * airspaces which are not polygons.
+   */
+  template<typename V>
+  void VisitWithin(const GeoBounds &area, V &&visitor) const {
+    for (const auto &item : items)
+      if (item.bounds.Overlaps(area))
+        visitor(*item.airspace, GetPoints(item), item.n_points);
+  }
+
+private:
+  gcc_pure
+  bool IsValid(const WindowProjection &projection) const;
+
+  const float *GetRanks(const AbstractAirspace &airspace);
+
+  void AddPolygon(Item &item, const AbstractAirspace &airspace,
+                  Angle tolerance);
+};
+
+#endif
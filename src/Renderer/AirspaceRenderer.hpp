@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_AIRSPACE_RENDERER_HPP
 #define XCSOAR_AIRSPACE_RENDERER_HPP
 
+#include "AirspaceGeometryCache.hpp"
 #include "Util/StaticArray.hxx"
 #include "Geo/GeoPoint.hpp"
 
@@ -52,6 +53,12 @@ class AirspaceRenderer
 
   StaticArray<GeoPoint,32> intersections;
 
+  /**
+   * The airspaces near the visible area, with pre-clipped and
+   * simplified polygons.
+   */
+  AirspaceGeometryCache geometry_cache;
+
 #ifndef ENABLE_OPENGL
   /**
    * This object caches the airspace fill.  This avoids drawing it
@@ -84,6 +91,7 @@ public:
 
   void SetAirspaces(const Airspaces *_airspaces) {
     airspaces = _airspaces;
+    geometry_cache.Invalidate();
   }
 
   void SetAirspaceWarnings(const ProtectedAirspaceWarningManager *_warning_manager) {
@@ -93,9 +101,12 @@ public:
   void Clear() {
     airspaces = nullptr;
     warning_manager = nullptr;
+    geometry_cache.Invalidate();
   }
 
   void Flush() {
+    geometry_cache.Invalidate();
+
 #ifndef ENABLE_OPENGL
     fill_cache.Invalidate();
 #endif
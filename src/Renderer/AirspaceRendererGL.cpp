@@ -30,7 +30,6 @@ Copyright_License {
 #include "MapWindow/MapCanvas.hpp"
 #include "Look/AirspaceLook.hpp"
 #include "Airspace/Airspaces.hpp"
-#include "Airspace/AirspacePolygon.hpp"
 #include "Airspace/AirspaceCircle.hpp"
 #include "Airspace/AirspaceWarningCopy.hpp"
 #include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
@@ -99,8 +98,9 @@ private:
       canvas.DrawCircle(screen_center.x, screen_center.y, screen_radius);
   }
 
-  void VisitPolygon(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
+  void VisitPolygon(const AbstractAirspace &airspace,
+                    const GeoPoint *points, unsigned n_points) {
+    if (!PrepareClippedPolygon(points, n_points))
       return;
 
     const AirspaceClassRendererSettings &class_settings =
@@ -144,14 +144,15 @@ private:
   }
 
 public:
-  void Visit(const AbstractAirspace &airspace) {
+  void Visit(const AbstractAirspace &airspace,
+             const GeoPoint *points, unsigned n_points) {
     switch (airspace.GetShape()) {
     case AbstractAirspace::Shape::CIRCLE:
       VisitCircle((const AirspaceCircle &)airspace);
       break;
 
     case AbstractAirspace::Shape::POLYGON:
-      VisitPolygon((const AirspacePolygon &)airspace);
+      VisitPolygon(airspace, points, n_points);
       break;
     }
   }
@@ -248,8 +249,9 @@ private:
       canvas.DrawCircle(screen_center.x, screen_center.y, screen_radius);
   }
 
-  void VisitPolygon(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
+  void VisitPolygon(const AbstractAirspace &airspace,
+                    const GeoPoint *points, unsigned n_points) {
+    if (!PrepareClippedPolygon(points, n_points))
       return;
 
     if (!warning_manager.IsAcked(airspace) && SetupInterior(airspace)) {
@@ -264,14 +266,15 @@ private:
   }
 
 public:
-  void Visit(const AbstractAirspace &airspace) {
+  void Visit(const AbstractAirspace &airspace,
+             const GeoPoint *points, unsigned n_points) {
     switch (airspace.GetShape()) {
     case AbstractAirspace::Shape::CIRCLE:
       VisitCircle((const AirspaceCircle &)airspace);
       break;
 
     case AbstractAirspace::Shape::POLYGON:
-      VisitPolygon((const AirspacePolygon &)airspace);
+      VisitPolygon(airspace, points, n_points);
       break;
     }
   }
@@ -313,25 +316,25 @@ AirspaceRenderer::DrawInternal(Canvas &canvas,
                                const AirspaceWarningCopy &awc,
                                const AirspacePredicate &visible)
 {
-  const auto range =
-    airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
-                                projection.GetScreenDistanceMeters());
+  const GeoBounds &screen_bounds = projection.GetScreenBounds();
 
   if (settings.fill_mode == AirspaceRendererSettings::FillMode::ALL ||
       settings.fill_mode == AirspaceRendererSettings::FillMode::NONE) {
     AirspaceFillRenderer renderer(canvas, projection, look, awc, settings);
-    for (const auto &i : range) {
-      const AbstractAirspace &airspace = i.GetAirspace();
-      if (visible(airspace))
-        renderer.Visit(airspace);
-    }
+    geometry_cache.VisitWithin(screen_bounds,
+                               [&](const AbstractAirspace &airspace,
+                                   const GeoPoint *points, unsigned n_points){
+                                 if (visible(airspace))
+                                   renderer.Visit(airspace, points, n_points);
+                               });
   } else {
     AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings);
-    for (const auto &i : range) {
-      const AbstractAirspace &airspace = i.GetAirspace();
-      if (visible(airspace))
-        renderer.Visit(airspace);
-    }
+    geometry_cache.VisitWithin(screen_bounds,
+                               [&](const AbstractAirspace &airspace,
+                                   const GeoPoint *points, unsigned n_points){
+                                 if (visible(airspace))
+                                   renderer.Visit(airspace, points, n_points);
+                               });
   }
 }
 
@@ -31,7 +31,6 @@ Copyright_License {
 #include "MapWindow/MapCanvas.hpp"
 #include "Look/AirspaceLook.hpp"
 #include "Airspace/Airspaces.hpp"
-#include "Airspace/AirspacePolygon.hpp"
 #include "Airspace/AirspaceCircle.hpp"
 #include "Airspace/AirspaceWarningCopy.hpp"
 #include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
@@ -79,12 +78,13 @@ private:
     DrawCircle(center, radius);
   }
 
-  void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawSearchPointVector(airspace.GetPoints());
+  void VisitPolygon(const GeoPoint *points, unsigned n_points) {
+    DrawClippedPolygon(points, n_points);
   }
 
 public:
-  void Visit(const AbstractAirspace &airspace) {
+  void Visit(const AbstractAirspace &airspace,
+             const GeoPoint *points, unsigned n_points) {
     if (warnings.IsAcked(airspace))
       return;
 
@@ -103,7 +103,7 @@ public:
       break;
 
     case AbstractAirspace::Shape::POLYGON:
-      VisitPolygon((const AirspacePolygon &)airspace);
+      VisitPolygon(points, n_points);
       break;
     }
   }
@@ -189,12 +189,14 @@ private:
     DrawCircle(airspace.GetReferenceLocation(), airspace.GetRadius());
   }
 
-  void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawPolygon(airspace.GetPoints());
+  void VisitPolygon(const GeoPoint *points, unsigned n_points) {
+    if (PrepareClippedPolygon(points, n_points))
+      DrawPrepared();
   }
 
 public:
-  void Visit(const AbstractAirspace &airspace) {
+  void Visit(const AbstractAirspace &airspace,
+             const GeoPoint *points, unsigned n_points) {
     if (!SetupCanvas(airspace))
       return;
 
@@ -204,7 +206,7 @@ public:
       break;
 
     case AbstractAirspace::Shape::POLYGON:
-      VisitPolygon((const AirspacePolygon &)airspace);
+      VisitPolygon(points, n_points);
       break;
     }
   }
@@ -225,14 +227,12 @@ AirspaceRenderer::DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
   // JMW TODO wasteful to draw twice, can't it be drawn once?
   // we are using two draws so borders go on top of everything
 
-  const auto range =
-    airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
-                                projection.GetScreenDistanceMeters());
-  for (const auto &i : range) {
-    const AbstractAirspace &airspace = i.GetAirspace();
-    if (visible(airspace))
-      v.Visit(airspace);
-  }
+  geometry_cache.VisitWithin(projection.GetScreenBounds(),
+                             [&](const AbstractAirspace &airspace,
+                                 const GeoPoint *points, unsigned n_points){
+                               if (visible(airspace))
+                                 v.Visit(airspace, points, n_points);
+                             });
 
   return v.Commit();
 }
@@ -276,16 +276,14 @@ AirspaceRenderer::DrawOutline(Canvas &canvas,
                               const AirspaceRendererSettings &settings,
                               const AirspacePredicate &visible) const
 {
-  const auto range =
-    airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
-                                projection.GetScreenDistanceMeters());
-
   AirspaceOutlineRenderer outline_renderer(canvas, projection, look, settings);
-  for (const auto &i : range) {
-    const AbstractAirspace &airspace = i.GetAirspace();
-    if (visible(airspace))
-      outline_renderer.Visit(airspace);
-  }
+  geometry_cache.VisitWithin(projection.GetScreenBounds(),
+                             [&](const AbstractAirspace &airspace,
+                                 const GeoPoint *points, unsigned n_points){
+                               if (visible(airspace))
+                                 outline_renderer.Visit(airspace, points,
+                                                        n_points);
+                             });
 }
 
 void
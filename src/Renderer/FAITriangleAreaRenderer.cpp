@@ -22,29 +22,57 @@ Copyright_License {
 */
 
 #include "FAITriangleAreaRenderer.hpp"
-#include "Engine/Task/Shapes/FAITriangleArea.hpp"
+#include "Engine/Task/Shapes/FAITriangleSector.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "Geo/GeoClip.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Screen/Canvas.hpp"
 
+/**
+ * Choose the number of vertices per edge for the given map scale.
+ * Only powers of two are used, so zooming in refines the previous
+ * vertices instead of replacing them.
+ */
+gcc_pure
+static unsigned
+GetSteps(const WindowProjection &projection, const FAITriangleSector &sector)
+{
+  const unsigned leg_pixels =
+    projection.GeoToScreenDistance(sector.GetLeg().distance);
+
+  unsigned steps = 2;
+  while (steps * 2 <= FAITriangleSector::MAX_STEPS && leg_pixels > steps * 32)
+    steps *= 2;
+
+  return steps;
+}
+
 void
 RenderFAISector(Canvas &canvas, const WindowProjection &projection,
-                const GeoPoint &pt1, const GeoPoint &pt2,
-                bool reverse, const FAITriangleSettings &settings)
+                const FAITriangleSector &sector)
 {
-  GeoPoint geo_points[FAI_TRIANGLE_SECTOR_MAX];
-  GeoPoint *geo_end = GenerateFAITriangleArea(geo_points, pt1, pt2,
-                                              reverse, settings);
+  const auto geo_points = sector.GetBoundary(GetSteps(projection, sector));
+  if (geo_points.size < 3)
+    return;
 
   GeoPoint clipped[FAI_TRIANGLE_SECTOR_MAX * 3],
     *clipped_end = clipped +
     GeoClip(projection.GetScreenBounds().Scale(1.1))
-    .ClipPolygon(clipped, geo_points, geo_end - geo_points);
+    .ClipPolygon(clipped, geo_points.data, geo_points.size);
 
-  BulkPixelPoint points[FAI_TRIANGLE_SECTOR_MAX], *p = points;
+  BulkPixelPoint points[FAI_TRIANGLE_SECTOR_MAX * 3], *p = points;
   for (GeoPoint *geo_i = clipped; geo_i != clipped_end;)
     *p++ = projection.GeoToScreen(*geo_i++);
 
   canvas.DrawPolygon(points, p - points);
 }
+
+void
+RenderFAISector(Canvas &canvas, const WindowProjection &projection,
+                const GeoPoint &pt1, const GeoPoint &pt2,
+                bool reverse, const FAITriangleSettings &settings)
+{
+  FAITriangleSector sector;
+  sector.Update(pt1, pt2, reverse, settings);
+  RenderFAISector(canvas, projection, sector);
+}
@@ -28,10 +28,20 @@ struct GeoPoint;
 class Canvas;
 class WindowProjection;
 struct FAITriangleSettings;
+class FAITriangleSector;
 
 void
 RenderFAISector(Canvas &canvas, const WindowProjection &projection,
                 const GeoPoint &pt1, const GeoPoint &pt2,
                 bool reverse, const FAITriangleSettings &settings);
 
+/**
+ * Render an area which was set up by the caller, with a resolution
+ * depending on the map scale.  Keeping the #FAITriangleSector across
+ * frames allows reusing its vertices.
+ */
+void
+RenderFAISector(Canvas &canvas, const WindowProjection &projection,
+                const FAITriangleSector &sector);
+
 #endif
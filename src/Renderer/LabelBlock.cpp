@@ -22,46 +22,72 @@ Copyright_License {
 */
 
 #include "LabelBlock.hpp"
+#include "Util/Clamp.hpp"
+
+#include <algorithm>
 
 void
-LabelBlock::Bucket::Clear()
+LabelBlock::reset()
 {
-  blocks.clear();
+  rects.clear();
+  entries.clear();
+  std::fill_n(&cells[0][0], GRID_ROWS * GRID_COLUMNS, uint16_t(END));
 }
 
 bool
-LabelBlock::Bucket::Check(const PixelRect rc) const
+LabelBlock::Check(const PixelRect rc, int x0, int y0, int x1, int y1) const
 {
-  for (auto i = blocks.begin(), end = blocks.end(); i != end; ++i)
-    if (i->OverlapsWith(rc))
-      return false;
+  for (int y = y0; y <= y1; ++y) {
+    const auto &row = cells[unsigned(y) % GRID_ROWS];
+
+    for (int x = x0; x <= x1; ++x)
+      for (unsigned i = row[unsigned(x) % GRID_COLUMNS]; i != END;
+           i = entries[i].next)
+        if (rects[entries[i].rect].OverlapsWith(rc))
+          return false;
+  }
 
   return true;
 }
 
-void LabelBlock::reset()
+void
+LabelBlock::Add(const PixelRect rc, int x0, int y0, int x1, int y1)
 {
-  for (unsigned i = 0; i < BUCKET_COUNT; ++i)
-    buckets[i].Clear();
-}
+  const unsigned n_cells = (x1 - x0 + 1) * (y1 - y0 + 1);
+  if (rects.full() || entries.size() + n_cells > MAX_ENTRIES)
+    /* out of memory; accept the label, but don't remember it */
+    return;
 
-bool LabelBlock::check(const PixelRect rc)
-{
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
+  const uint16_t index = rects.size();
+  rects.append(rc);
 
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
+  for (int y = y0; y <= y1; ++y) {
+    auto &row = cells[unsigned(y) % GRID_ROWS];
 
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
+    for (int x = x0; x <= x1; ++x) {
+      uint16_t &head = row[unsigned(x) % GRID_COLUMNS];
 
-  if (top < bottom && !buckets[top].Check(rc))
-    return false;
+      Entry &entry = entries.append();
+      entry.rect = index;
+      entry.next = head;
+      head = entries.size() - 1;
+    }
+  }
+}
+
+bool
+LabelBlock::check(const PixelRect rc)
+{
+  /* both edges are inclusive, see PixelRect::OverlapsWith() */
+  const int x0 = rc.left >> CELL_SHIFT, y0 = rc.top >> CELL_SHIFT;
+  const int x1 = Clamp(rc.right >> CELL_SHIFT,
+                       x0, x0 + int(GRID_COLUMNS) - 1);
+  const int y1 = Clamp(rc.bottom >> CELL_SHIFT,
+                       y0, y0 + int(GRID_ROWS) - 1);
 
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
+  if (!Check(rc, x0, y0, x1, y1))
+    return false;
 
+  Add(rc, x0, y0, x1, y1);
   return true;
 }
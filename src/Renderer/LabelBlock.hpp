@@ -28,48 +28,75 @@ Copyright_License {
 #include "Util/StaticArray.hxx"
 #include "Compiler.h"
 
+#include <stdint.h>
+
 /**
  * Simple code to prevent text writing over map city names.
+ *
+ * The occupied rectangles are registered in a uniform grid of cells.
+ * The grid is folded into a fixed table (cells which are
+ * #GRID_COLUMNS or #GRID_ROWS apart share a slot), so a check only
+ * needs to look at the rectangles in the cells it covers, no matter
+ * how many labels have been placed on the screen.
  */
 class LabelBlock {
 #if defined(HAVE_GLES)
   /* embedded (Android or Windows CE) */
-  static constexpr unsigned SCREEN_HEIGHT = 2048;
-  static constexpr unsigned BUCKET_SIZE = 64;
+  static constexpr unsigned MAX_RECTS = 512;
 #else
   /* desktop, screen may be huge, lots of memory */
-  static constexpr unsigned SCREEN_HEIGHT = 4096;
-  static constexpr unsigned BUCKET_SIZE = 64;
+  static constexpr unsigned MAX_RECTS = 1024;
 #endif
-  static constexpr unsigned BUCKET_SHIFT = 7;
-  static constexpr unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static constexpr unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
 
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * The number of cell references; a typical label covers up to
+   * four cells.
    */
-  class Bucket {
-    typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
-    BlockArray blocks;
+  static constexpr unsigned MAX_ENTRIES = 4 * MAX_RECTS;
+
+  static constexpr unsigned CELL_SHIFT = 6;
+  static constexpr unsigned GRID_COLUMNS = 32;
+  static constexpr unsigned GRID_ROWS = 32;
 
-  public:
-    void Clear();
+  static constexpr uint16_t END = 0xffff;
 
-    gcc_pure
-    bool Check(const PixelRect rc) const;
+  static_assert(MAX_ENTRIES < END, "Too many entries");
 
-    void Add(const PixelRect rc) {
-      if (!blocks.full())
-        blocks.append(rc);
-    }
+  /**
+   * A reference to a rectangle from one cell, linked to the other
+   * references in the same cell.
+   */
+  struct Entry {
+    uint16_t rect, next;
   };
 
-  Bucket buckets[BUCKET_COUNT];
+  StaticArray<PixelRect, MAX_RECTS> rects;
+  StaticArray<Entry, MAX_ENTRIES> entries;
+
+  /**
+   * The first #Entry of each cell, or #END.
+   */
+  uint16_t cells[GRID_ROWS][GRID_COLUMNS];
 
 public:
+  LabelBlock() {
+    reset();
+  }
+
+  /**
+   * Check if the specified rectangle is still free, and if yes,
+   * mark it as occupied.
+   *
+   * @return true if the label may be drawn
+   */
   bool check(const PixelRect rc);
   void reset();
+
+private:
+  gcc_pure
+  bool Check(const PixelRect rc, int x0, int y0, int x1, int y1) const;
+
+  void Add(const PixelRect rc, int x0, int y0, int x1, int y1);
 };
 
 #endif
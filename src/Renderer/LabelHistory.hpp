@@ -0,0 +1,78 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_LABEL_HISTORY_HPP
+#define XCSOAR_LABEL_HISTORY_HPP
+
+#include "Util/StaticArray.hxx"
+#include "Compiler.h"
+
+/**
+ * Remembers which labels were placed in the previous frame.  A
+ * renderer which tries those first (among labels of the same
+ * priority) keeps its layout stable while the map moves, instead of
+ * letting two overlapping labels take turns.
+ *
+ * Labels are identified by an opaque pointer, usually the address of
+ * the object being labelled.  It is never dereferenced.
+ */
+class LabelHistory {
+  typedef StaticArray<const void *, 512> KeyArray;
+
+  /**
+   * The labels placed in the previous frame, sorted.
+   */
+  KeyArray previous;
+
+  /**
+   * The labels placed in the current frame so far.
+   */
+  KeyArray current;
+
+public:
+  gcc_pure
+  bool WasPlaced(const void *key) const;
+
+  /**
+   * Record that this label has been placed in the current frame.
+   */
+  void Placed(const void *key) {
+    if (!current.full())
+      current.append(key);
+  }
+
+  /**
+   * Finish the current frame.
+   */
+  void Commit();
+
+  /**
+   * Forget everything, e.g. because the labelled objects have been
+   * replaced.
+   */
+  void Clear() {
+    previous.clear();
+    current.clear();
+  }
+};
+
+#endif
@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "WaypointLabelList.hpp"
+#include "LabelHistory.hpp"
 #include "Util/StringUtil.hpp"
 #include "Util/Macros.hpp"
 
@@ -58,6 +59,12 @@ MapWaypointLabelListCompare(const WaypointLabelList::Label &e1,
   if (!e1.isWatchedWaypoint && e2.isWatchedWaypoint)
     return false;
 
+  if (e1.was_placed && !e2.was_placed)
+    return true;
+
+  if (!e1.was_placed && e2.was_placed)
+    return false;
+
   if (e1.AltArivalAGL > e2.AltArivalAGL)
     return true;
 
@@ -68,7 +75,7 @@ MapWaypointLabelListCompare(const WaypointLabelList::Label &e1,
 }
 
 void
-WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
+WaypointLabelList::Add(const void *key, const TCHAR *Name, int X, int Y,
                        TextInBoxMode Mode, bool bold,
                        int AltArivalAGL, bool inTask,
                        bool isLandable, bool isAirport, bool isWatchedWaypoint)
@@ -82,6 +89,7 @@ WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
 
   auto &l = labels.append();
 
+  l.key = key;
   CopyString(l.Name, Name, ARRAY_SIZE(l.Name));
   l.Pos.x = X;
   l.Pos.y = Y;
@@ -95,8 +103,11 @@ WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
 }
 
 void
-WaypointLabelList::Sort()
+WaypointLabelList::Sort(const LabelHistory &history)
 {
+  for (auto &l : labels)
+    l.was_placed = history.WasPlaced(l.key);
+
   std::sort(labels.begin(), labels.end(),
             MapWaypointLabelListCompare);
 }
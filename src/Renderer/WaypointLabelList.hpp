@@ -32,9 +32,16 @@ Copyright_License {
 
 #include <tchar.h>
 
+class LabelHistory;
+
 class WaypointLabelList : private NonCopyable {
 public:
   struct Label{
+    /**
+     * Identifies the label across frames, see #LabelHistory.
+     */
+    const void *key;
+
     TCHAR Name[NAME_SIZE+1];
     PixelPoint Pos;
     TextInBoxMode Mode;
@@ -44,6 +51,11 @@ public:
     bool isAirport;
     bool isWatchedWaypoint;
     bool bold;
+
+    /**
+     * Was this label placed in the previous frame?  Set by Sort().
+     */
+    bool was_placed;
   };
 
 protected:
@@ -55,12 +67,17 @@ public:
   WaypointLabelList(unsigned _width, unsigned _height)
     :width(_width), height(_height) {}
 
-  void Add(const TCHAR *name, int x, int y,
+  void Add(const void *key, const TCHAR *name, int x, int y,
            TextInBoxMode Mode, bool bold,
            int AltArivalAGL,
            bool inTask, bool isLandable, bool isAirport,
            bool isWatchedWaypoint);
-  void Sort();
+  /**
+   * Sort the labels by priority, most important first.  Among labels
+   * of equal priority, those placed in the previous frame come
+   * first.
+   */
+  void Sort(const LabelHistory &history);
 
   const Label *begin() const {
     return labels.begin();
@@ -27,33 +27,34 @@ Copyright_License {
 #include "WaypointLabelList.hpp"
 #include "Projection/MapWindowProjection.hpp"
 #include "Computer/Settings.hpp"
-#include "Task/Visitors/TaskPointVisitor.hpp"
 #include "Engine/Util/Gradient.hpp"
 #include "Engine/Waypoint/Waypoint.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
-#include "Engine/GlideSolvers/GlideState.hpp"
-#include "Engine/GlideSolvers/GlideResult.hpp"
-#include "Engine/GlideSolvers/MacCready.hpp"
-#include "Engine/Task/TaskManager.hpp"
-#include "Engine/Task/AbstractTask.hpp"
-#include "Engine/Task/Unordered/UnorderedTaskPoint.hpp"
-#include "Engine/Task/Ordered/Points/OrderedTaskPoint.hpp"
 #include "Task/ProtectedTaskManager.hpp"
-#include "Task/ProtectedRoutePlanner.hpp"
+#include "Computer/ReachabilityCache.hpp"
 #include "Screen/Canvas.hpp"
 #include "Units/Units.hpp"
 #include "Util/TruncateString.hpp"
 #include "Util/StaticArray.hxx"
 #include "Util/Macros.hpp"
 #include "NMEA/MoreData.hpp"
-#include "NMEA/Derived.hpp"
 #include "Engine/Route/ReachResult.hpp"
 #include "Look/WaypointLook.hpp"
 
 #include <assert.h>
 #include <stdio.h>
 
+static_assert(unsigned(ReachabilityCache::Reachability::INVALID) ==
+              WaypointRenderer::Invalid &&
+              unsigned(ReachabilityCache::Reachability::UNREACHABLE) ==
+              WaypointRenderer::Unreachable &&
+              unsigned(ReachabilityCache::Reachability::STRAIGHT) ==
+              WaypointRenderer::ReachableStraight &&
+              unsigned(ReachabilityCache::Reachability::TERRAIN) ==
+              WaypointRenderer::ReachableTerrain,
+              "Reachability mismatch");
+
 /**
  * Metadata for a Waypoint that is about to be drawn.
  */
@@ -82,52 +83,9 @@ struct VisibleWaypoint {
       reachable == WaypointRenderer::ReachableTerrain;
   }
 
-  void CalculateReachabilityDirect(const MoreData &basic,
-                                   const SpeedVector &wind,
-                                   const MacCready &mac_cready,
-                                   const TaskBehaviour &task_behaviour) {
-    assert(basic.location_available);
-    assert(basic.NavAltitudeAvailable());
-
-    const auto elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const GlideState state(GeoVector(basic.location, waypoint->location),
-                           elevation, basic.nav_altitude, wind);
-
-    const GlideResult result = mac_cready.SolveStraight(state);
-    if (!result.IsOk())
-      return;
-
-    reach.direct = result.pure_glide_altitude_difference;
-    if (result.pure_glide_altitude_difference > 0)
-      reachable = WaypointRenderer::ReachableTerrain;
-  }
-
-  bool CalculateRouteArrival(const RoutePlannerGlue &route_planner,
-                             const TaskBehaviour &task_behaviour) {
-    const double elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const AGeoPoint p_dest (waypoint->location, elevation);
-    if (!route_planner.FindPositiveArrival(p_dest, reach))
-      return false;
-
-    reach.Subtract(elevation);
-    return true;
-  }
-
-  void CalculateReachability(const RoutePlannerGlue &route_planner,
-                             const TaskBehaviour &task_behaviour)
-  {
-    if (!CalculateRouteArrival(route_planner, task_behaviour))
-      return;
-
-    if (!reach.IsReachableDirect())
-      reachable = WaypointRenderer::Unreachable;
-    else if (task_behaviour.route_planner.IsReachEnabled() &&
-             !reach.IsReachableTerrain())
-      reachable = WaypointRenderer::ReachableStraight;
-    else
-      reachable = WaypointRenderer::ReachableTerrain;
+  void SetReachability(const ReachabilityCache::Item &item) {
+    reach = item.reach;
+    reachable = static_cast<WaypointRenderer::Reachability>(item.reachable);
   }
 
   void DrawSymbol(const struct WaypointRendererSettings &settings,
@@ -140,8 +98,7 @@ struct VisibleWaypoint {
   }
 };
 
-class WaypointVisitorMap final
-  : public WaypointVisitor, public TaskPointConstVisitor
+class WaypointVisitorMap final : public WaypointVisitor
 {
   const MapWindowProjection &projection;
   const WaypointRendererSettings &settings;
@@ -155,7 +112,7 @@ class WaypointVisitorMap final
   /**
    * A list of waypoints that are going to be drawn.  This list is
    * filled in the Visitor methods.  In the second stage, their
-   * reachability is calculated, and the third stage draws them.  This
+   * reachability is looked up, and the third stage draws them.  This
    * should ensure that the drawing methods don't need to hold a
    * mutex.
    */
@@ -344,7 +301,7 @@ protected:
       // make space for the green circle
       sc.x += 5;
 
-    labels.Add(buffer, sc.x + 5, sc.y, text_mode, bold, vwp.reach.direct,
+    labels.Add(&way_point, buffer, sc.x + 5, sc.y, text_mode, bold, vwp.reach.direct,
                vwp.in_task, way_point.IsLandable(), way_point.IsAirport(),
                watchedWaypoint);
   }
@@ -369,19 +326,13 @@ public:
     AddWaypoint(way_point, false);
   }
 
-  void Visit(const TaskPoint &tp) override {
-    switch (tp.GetType()) {
-    case TaskPointType::UNORDERED:
-      AddWaypoint(((const UnorderedTaskPoint &)tp).GetWaypointPtr(), true);
-      break;
-
-    case TaskPointType::START:
-    case TaskPointType::AST:
-    case TaskPointType::AAT:
-    case TaskPointType::FINISH:
-      AddWaypoint(((const OrderedTaskPoint &)tp).GetWaypointPtr(), true);
-      break;
-    }
+  /**
+   * Add a task point.  Task points come first, this is the only way
+   * we know that an item is in task, and we won't add it if it is
+   * already there.
+   */
+  void AddTaskWaypoint(const WaypointPtr &way_point) {
+    AddWaypoint(way_point, true);
   }
 
 public:
@@ -389,48 +340,26 @@ public:
     task_valid = true;
   }
 
-  void CalculateRoute(const ProtectedRoutePlanner &route_planner) {
-    const ProtectedRoutePlanner::Lease lease(route_planner);
-
-    for (VisibleWaypoint &vwp : waypoints) {
-      const Waypoint &way_point = *vwp.waypoint;
-
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachability(lease, task_behaviour);
-    }
-  }
-
-  void CalculateDirect(const PolarSettings &polar_settings,
-                       const TaskBehaviour &task_behaviour,
-                       const DerivedInfo &calculated) {
-    if (!basic.location_available || !basic.NavAltitudeAvailable())
+  /**
+   * Look up the arrival altitudes which were calculated by the
+   * calculation thread.
+   */
+  void Calculate(const ProtectedReachabilityCache &reachability) {
+    const ProtectedReachabilityCache::Lease lease(reachability);
+    if (lease->IsEmpty())
       return;
 
-    const GlidePolar &glide_polar =
-      task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
-      ? polar_settings.glide_polar_task
-      : calculated.glide_polar_safety;
-    const MacCready mac_cready(task_behaviour.glide, glide_polar);
-
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
 
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachabilityDirect(basic, calculated.GetWindOrZero(),
-                                        mac_cready, task_behaviour);
+      if (way_point.IsLandable() || way_point.flags.watched) {
+        const auto *item = lease->Find(way_point.id);
+        if (item != nullptr)
+          vwp.SetReachability(*item);
+      }
     }
   }
 
-  void Calculate(const ProtectedRoutePlanner *route_planner,
-                 const PolarSettings &polar_settings,
-                 const TaskBehaviour &task_behaviour,
-                 const DerivedInfo &calculated) {
-    if (route_planner != nullptr && !route_planner->IsTerrainReachEmpty())
-      CalculateRoute(*route_planner);
-    else
-      CalculateDirect(polar_settings, task_behaviour, calculated);
-  }
-
   void Draw(Canvas &canvas) {
     for (const VisibleWaypoint &vwp : waypoints)
       DrawWaypoint(canvas, vwp);
@@ -441,27 +370,30 @@ static void
 MapWaypointLabelRender(Canvas &canvas, unsigned width, unsigned height,
                        LabelBlock &label_block,
                        WaypointLabelList &labels,
+                       LabelHistory &history,
                        const WaypointLook &look)
 {
-  labels.Sort();
+  labels.Sort(history);
 
   for (const auto &l : labels) {
     canvas.Select(l.bold ? *look.bold_font : *look.font);
 
-    TextInBox(canvas, l.Name, l.Pos.x, l.Pos.y, l.Mode,
-              width, height, &label_block);
+    if (TextInBox(canvas, l.Name, l.Pos.x, l.Pos.y, l.Mode,
+                  width, height, &label_block))
+      history.Placed(l.key);
   }
+
+  history.Commit();
 }
 
 void
 WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
                          const MapWindowProjection &projection,
                          const struct WaypointRendererSettings &settings,
-                         const PolarSettings &polar_settings,
                          const TaskBehaviour &task_behaviour,
-                         const MoreData &basic, const DerivedInfo &calculated,
+                         const MoreData &basic,
                          const ProtectedTaskManager *task,
-                         const ProtectedRoutePlanner *route_planner)
+                         const ProtectedReachabilityCache *reachability)
 {
   if (way_points == nullptr || way_points->IsEmpty())
     return;
@@ -469,29 +401,27 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
   WaypointVisitorMap v(projection, settings, look, task_behaviour, basic);
 
   if (task != nullptr) {
-    ProtectedTaskManager::Lease task_manager(*task);
-
-    const TaskStats &task_stats = task_manager->GetStats();
+    /* the snapshot avoids locking the task manager while the
+       calculation thread updates it */
+    const auto snapshot = task->GetSnapshot();
 
-    // task items come first, this is the only way we know that an item is in task,
-    // and we won't add it if it is already there
-    if (task_stats.task_valid)
+    if (snapshot->task_valid)
       v.SetTaskValid();
 
-    const AbstractTask *atask = task_manager->GetActiveTask();
-    if (atask != nullptr)
-      atask->AcceptTaskPointVisitor(v);
+    for (const auto &wp : snapshot->waypoints)
+      v.AddTaskWaypoint(wp);
   }
 
   way_points->VisitWithinRange(projection.GetGeoScreenCenter(),
                                  projection.GetScreenDistanceMeters(), v);
 
-  v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
+  if (reachability != nullptr)
+    v.Calculate(*reachability);
 
   v.Draw(canvas);
 
   MapWaypointLabelRender(canvas,
                          projection.GetScreenWidth(),
                          projection.GetScreenHeight(),
-                         label_block, v.labels, look);
+                         label_block, v.labels, label_history, look);
 }
@@ -24,6 +24,8 @@ Copyright_License {
 #ifndef XCSOAR_WAY_POINT_RENDERER_HPP
 #define XCSOAR_WAY_POINT_RENDERER_HPP
 
+#include "LabelHistory.hpp"
+#include "Computer/ReachabilityCache.hpp"
 #include "Util/NonCopyable.hpp"
 
 struct WaypointRendererSettings;
@@ -32,12 +34,9 @@ class Canvas;
 class LabelBlock;
 class MapWindowProjection;
 class Waypoints;
-struct PolarSettings;
 struct TaskBehaviour;
 struct MoreData;
-struct DerivedInfo;
 class ProtectedTaskManager;
-class ProtectedRoutePlanner;
 
 /**
  * Renders way point icons and labels into a #Canvas.
@@ -47,6 +46,12 @@ class WaypointRenderer : private NonCopyable {
 
   const WaypointLook &look;
 
+  /**
+   * The labels placed in the previous frame; they are preferred over
+   * labels of the same priority to avoid flickering.
+   */
+  LabelHistory label_history;
+
 public:
   enum Reachability
   {
@@ -62,16 +67,16 @@ public:
 
   void set_way_points(const Waypoints *_way_points) {
     way_points = _way_points;
+    label_history.Clear();
   }
 
   void render(Canvas &canvas, LabelBlock &label_block,
               const MapWindowProjection &projection,
               const WaypointRendererSettings &settings,
-              const PolarSettings &polar_settings,
               const TaskBehaviour &task_behaviour,
-              const MoreData &basic, const DerivedInfo &calculated,
+              const MoreData &basic,
               const ProtectedTaskManager *task,
-              const ProtectedRoutePlanner *route_planner);
+              const ProtectedReachabilityCache *reachability);
 
   const WaypointLook &GetLook() const {
     return look;
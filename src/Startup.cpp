@@ -322,12 +322,16 @@ Startup()
                          CommonInterface::SetComputerSettings(), gp);
   task_manager->SetGlidePolar(gp);
 
+  // Parse the airspace files while the other files are being loaded
+  AirspaceLoader airspace_loader(airspace_database);
+  airspace_loader.Start();
+
   // Read the topography file(s)
   topography = new TopographyStore();
   LoadConfiguredTopography(*topography, operation);
 
   // Read the waypoint files
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
 
   // Read and parse the airfield info file
   WaypointDetails::ReadFileFromProfile(way_points, operation);
@@ -347,9 +351,8 @@ Startup()
   auto rasp = std::make_shared<RaspStore>(LocalPath(_T(RASP_FILENAME)));
   rasp->ScanAll();
 
-  // Reads the airspace files
-  ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-               operation);
+  // Wait for the airspace files
+  airspace_loader.Finish(terrain, computer_settings.pressure, operation);
 
   {
     const AircraftState aircraft_state =
@@ -609,6 +612,10 @@ Shutdown()
   device_blackboard = nullptr;
 
   if (protected_task_manager != nullptr) {
+    LogFormat("Task manager leases: %u shared waits, %u exclusive waits",
+              protected_task_manager->GetSharedWaits(),
+              protected_task_manager->GetExclusiveWaits());
+
     protected_task_manager->SetRoutePlanner(nullptr);
     delete protected_task_manager;
     protected_task_manager = nullptr;
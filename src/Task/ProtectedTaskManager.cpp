@@ -31,7 +31,8 @@ Copyright_License {
 ProtectedTaskManager::ProtectedTaskManager(TaskManager &_task_manager,
                                            const TaskBehaviour &tb)
   :Guard<TaskManager>(_task_manager),
-   task_behaviour(tb)
+   task_behaviour(tb),
+   snapshot(std::make_shared<TaskSnapshot>(_task_manager))
 {
 }
 
@@ -40,6 +41,14 @@ ProtectedTaskManager::~ProtectedTaskManager() {
   lease->SetIntersectionTest(nullptr); // de-register
 }
 
+void
+ProtectedTaskManager::PublishSnapshot(const TaskManager &task_manager)
+{
+  std::shared_ptr<const TaskSnapshot> new_snapshot =
+    std::make_shared<TaskSnapshot>(task_manager);
+  std::atomic_store(&snapshot, std::move(new_snapshot));
+}
+
 void 
 ProtectedTaskManager::SetGlidePolar(const GlidePolar &glide_polar)
 {
@@ -23,11 +23,14 @@
 #ifndef XCSOAR_PROTECTED_TASK_MANAGER_HPP
 #define XCSOAR_PROTECTED_TASK_MANAGER_HPP
 
+#include "TaskSnapshot.hpp"
 #include "Thread/Guard.hpp"
 #include "Engine/Task/Unordered/AbortIntersectionTest.hpp"
 #include "Engine/Waypoint/Ptr.hpp"
 #include "Compiler.h"
 
+#include <memory>
+
 struct AGeoPoint;
 struct TaskBehaviour;
 struct OrderedTaskSettings;
@@ -60,11 +63,51 @@ protected:
   const TaskBehaviour &task_behaviour;
   ReachIntersectionTest intersection_test;
 
+  /**
+   * The most recently published #TaskSnapshot.  It is replaced as a
+   * whole with std::atomic_store(), and never modified after that.
+   */
+  std::shared_ptr<const TaskSnapshot> snapshot;
+
 public:
+  /**
+   * A writable lease which publishes a new #TaskSnapshot before it
+   * releases the lock, so the snapshot follows all changes to the
+   * task, no matter which thread made them.
+   */
+  class ExclusiveLease : public Guard<TaskManager>::ExclusiveLease {
+    ProtectedTaskManager &protected_task_manager;
+
+  public:
+    explicit ExclusiveLease(ProtectedTaskManager &_protected_task_manager)
+      :Guard<TaskManager>::ExclusiveLease(_protected_task_manager),
+       protected_task_manager(_protected_task_manager) {}
+
+    ~ExclusiveLease() {
+      protected_task_manager.PublishSnapshot(*this);
+    }
+  };
+
   ProtectedTaskManager(TaskManager &_task_manager, const TaskBehaviour &tb);
 
   ~ProtectedTaskManager();
 
+private:
+  /**
+   * Publish a #TaskSnapshot of the active task.  The caller must hold
+   * an #ExclusiveLease, which serialises the writers.
+   */
+  void PublishSnapshot(const TaskManager &task_manager);
+
+public:
+  /**
+   * Obtain the most recently published #TaskSnapshot.  This does not
+   * lock the task manager.
+   */
+  std::shared_ptr<const TaskSnapshot> GetSnapshot() const {
+    return std::atomic_load(&snapshot);
+  }
+
   // common accessors for ui and calc clients
   void SetGlidePolar(const GlidePolar &glide_polar);
 
@@ -0,0 +1,55 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "TaskSnapshot.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/AbstractTask.hpp"
+#include "Engine/Task/Points/TaskWaypoint.hpp"
+#include "Engine/Task/Visitors/TaskPointVisitor.hpp"
+
+class TaskSnapshotVisitor final : public TaskPointConstVisitor {
+  TaskSnapshot &snapshot;
+
+public:
+  explicit TaskSnapshotVisitor(TaskSnapshot &_snapshot)
+    :snapshot(_snapshot) {}
+
+  void Visit(const TaskPoint &tp) override {
+    /* all task point types are waypoints */
+    const auto &waypoint = static_cast<const TaskWaypoint &>(tp);
+    snapshot.waypoints.push_back(waypoint.GetWaypointPtr());
+  }
+};
+
+TaskSnapshot::TaskSnapshot(const TaskManager &task_manager)
+{
+  const AbstractTask *task = task_manager.GetActiveTask();
+  if (task == nullptr)
+    return;
+
+  task_valid = task_manager.GetStats().task_valid;
+  active_index = task->GetActiveTaskPointIndex();
+
+  waypoints.reserve(task->TaskSize());
+  TaskSnapshotVisitor visitor(*this);
+  task->AcceptTaskPointVisitor(visitor);
+}
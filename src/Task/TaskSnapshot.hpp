@@ -0,0 +1,65 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_TASK_SNAPSHOT_HPP
+#define XCSOAR_TASK_SNAPSHOT_HPP
+
+#include "Engine/Waypoint/Ptr.hpp"
+
+#include <vector>
+
+class TaskManager;
+
+/**
+ * A copy of the parts of the active task which the map renderer
+ * needs on every frame.  It is published by #ProtectedTaskManager
+ * whenever an #ExclusiveLease is released, so readers do not need a
+ * lease on the task manager.  A published snapshot is never modified.
+ *
+ * The statistics are not part of it; they are published through
+ * #DerivedInfo already.  Neither is the geometry drawn by
+ * #TaskRenderer (observation zones, AAT targets and isolines): it is
+ * owned by polymorphic task point objects which the renderers visit,
+ * so the task and target map windows still read it with a lease.
+ */
+struct TaskSnapshot {
+  /**
+   * The waypoints of the task points, in task order.  This includes
+   * waypoints which are not in the database, e.g. the takeoff point
+   * of a "goto" task.
+   */
+  std::vector<WaypointPtr> waypoints;
+
+  unsigned active_index = 0;
+
+  bool task_valid = false;
+
+  /**
+   * Copy the active task of the given #TaskManager.  The caller must
+   * hold a lease on it.
+   */
+  explicit TaskSnapshot(const TaskManager &task_manager);
+
+  TaskSnapshot() = default;
+};
+
+#endif
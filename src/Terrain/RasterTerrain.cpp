@@ -88,7 +88,7 @@ try {
   if (path.IsNull())
     return nullptr;
 
-  RasterTerrain *rt = new RasterTerrain(ZipArchive(path));
+  RasterTerrain *rt = new RasterTerrain(path, ZipArchive(path));
   if (!rt->Load(path, cache, operation)) {
     delete rt;
     return nullptr;
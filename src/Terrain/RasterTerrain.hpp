@@ -45,6 +45,11 @@ public:
   friend class WaypointVisitorMap; // for intersection rendering
 
 private:
+  /**
+   * The path of the map file the terrain was loaded from.
+   */
+  AllocatedPath path;
+
   ZipArchive archive;
 
   RasterMap map;
@@ -53,10 +58,14 @@ private:
   /**
    * Constructor.  Returns uninitialised object.
    */
-  explicit RasterTerrain(ZipArchive &&_archive)
-    :Guard<RasterMap>(map), archive(std::move(_archive)) {}
+  RasterTerrain(Path _path, ZipArchive &&_archive)
+    :Guard<RasterMap>(map), path(_path), archive(std::move(_archive)) {}
 
 public:
+  Path GetPath() const {
+    return path;
+  }
+
   const Serial &GetSerial() const {
     return map.GetSerial();
   }
@@ -25,6 +25,8 @@
 
 #include "SharedMutex.hpp"
 
+#include <atomic>
+
 /**
  * This class protects its value with a mutex.  A user may get a lease
  * on the value, and the Lease objects locks the mutex during the
@@ -36,6 +38,27 @@ protected:
   T &value;
   mutable SharedMutex mutex;
 
+  /**
+   * The number of leases which could not be obtained immediately,
+   * because another thread was holding a conflicting one.
+   */
+  mutable std::atomic<unsigned> n_shared_waits, n_exclusive_waits;
+
+private:
+  void LockShared() const {
+    if (!mutex.try_lock_shared()) {
+      n_shared_waits.fetch_add(1, std::memory_order_relaxed);
+      mutex.lock_shared();
+    }
+  }
+
+  void LockExclusive() {
+    if (!mutex.try_lock()) {
+      n_exclusive_waits.fetch_add(1, std::memory_order_relaxed);
+      mutex.lock();
+    }
+  }
+
 public:
   /**
    * A read-only lease on the guarded value.
@@ -45,7 +68,7 @@ public:
 
   public:
     explicit Lease(const Guard &_guard):guard(_guard) {
-      guard.mutex.lock_shared();
+      guard.LockShared();
     }
 
     ~Lease() {
@@ -69,7 +92,7 @@ public:
 
   public:
     explicit ExclusiveLease(Guard &_guard):guard(_guard) {
-      guard.mutex.lock();
+      guard.LockExclusive();
     }
 
     ~ExclusiveLease() {
@@ -123,7 +146,24 @@ public:
   };
 
 public:
-  explicit Guard(T &_value):value(_value) {}
+  explicit Guard(T &_value)
+    :value(_value), n_shared_waits(0), n_exclusive_waits(0) {}
+
+  /**
+   * Returns the number of read-only leases which had to wait for a
+   * writer.
+   */
+  unsigned GetSharedWaits() const {
+    return n_shared_waits.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the number of writable leases which had to wait for
+   * another lease to be released.
+   */
+  unsigned GetExclusiveWaits() const {
+    return n_exclusive_waits.load(std::memory_order_relaxed);
+  }
 };
 
 #endif
@@ -249,7 +249,9 @@ TopographyFileRenderer::Paint(Canvas &canvas,
   const GeoClip clip(projection.GetScreenBounds().Scale(1.1));
   AllocatedArray<GeoPoint> geo_points;
 
-  int iskip = file.GetSkipSteps(map_scale);
+  /* level of detail: skip points which would move the shape by less
+     than one pixel */
+  const float min_rank = projection.PixelsToAngle(1).Native();
 #endif
 
 #ifdef ENABLE_OPENGL
@@ -311,15 +313,19 @@ TopographyFileRenderer::Paint(Canvas &canvas,
           }
         }
 #else // !ENABLE_OPENGL
+        const float *ranks = shape.GetRanks();
         for (unsigned msize : lines) {
         shape_renderer.Begin(msize);
 
         const GeoPoint *end = points + msize - 1;
-        for (; points < end; ++points)
-          shape_renderer.AddPointIfDistant(projection.GeoToScreen(*points));
+        for (; points < end; ++points, ++ranks)
+          if (*ranks >= min_rank)
+            shape_renderer.AddPointIfDistant(projection.GeoToScreen(*points));
 
         // make sure we always draw the last point
         shape_renderer.AddPoint(projection.GeoToScreen(*points));
+        ++points;
+        ++ranks;
 
         shape_renderer.FinishPolyline(canvas);
       }
@@ -356,16 +362,21 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #else // !ENABLE_OPENGL
       {
         const GeoPoint *src = &points[0];
+        const float *src_ranks = shape.GetRanks();
         for (const unsigned n : lines) {
-          unsigned msize = n / iskip;
+          /* copy the polygon points of the current level of detail
+             into the geo_points array and clip them, to avoid integer
+             overflows (as PixelPoint may store only 16 bit integers
+             on some platforms) */
 
-          /* copy all polygon points into the geo_points array and
-             clip them, to avoid integer overflows (as PixelPoint may
-             store only 16 bit integers on some platforms) */
+          geo_points.GrowDiscard(n * 3);
+          unsigned msize = 0;
+          for (unsigned i = 0; i < n; ++i)
+            if (src_ranks[i] >= min_rank)
+              geo_points[msize++] = src[i];
 
-          geo_points.GrowDiscard(msize * 3);
-          for (unsigned i = 0; i < msize; ++i)
-            geo_points[i] = src[i * iskip];
+          src += n;
+          src_ranks += n;
 
           msize = clip.ClipPolygon(geo_points.begin(),
                                    geo_points.begin(), msize);
@@ -380,8 +391,6 @@ TopographyFileRenderer::Paint(Canvas &canvas,
           }
 
           shape_renderer.FinishPolygon(canvas);
-
-          src += n;
         }
       }
 #endif
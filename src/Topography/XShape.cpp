@@ -31,6 +31,8 @@ Copyright_License {
 #ifdef ENABLE_OPENGL
 #include "Projection/Projection.hpp"
 #include "Screen/OpenGL/Triangulate.hpp"
+#else
+#include "Geo/DouglasPeucker.hpp"
 #endif
 
 #ifdef _UNICODE
@@ -39,6 +41,8 @@ Copyright_License {
 
 #include <algorithm>
 
+#include <assert.h>
+
 #include <tchar.h>
 
 static AllocatedString<TCHAR>
@@ -94,6 +98,8 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
 #ifdef ENABLE_OPENGL
   std::fill_n(index_count, THINNING_LEVELS, nullptr);
   std::fill_n(indices, THINNING_LEVELS, nullptr);
+#else
+  ranks = nullptr;
 #endif
 
   shapeObj shape;
@@ -174,9 +180,41 @@ XShape::~XShape()
   // Note: index_count and indices share one buffer
   for (unsigned i = 0; i < THINNING_LEVELS; i++)
     delete[] index_count[i];
+#else
+  delete[] ranks;
 #endif
 }
 
+#ifndef ENABLE_OPENGL
+
+const float *
+XShape::GetRanks() const
+{
+  if (ranks != nullptr)
+    return ranks;
+
+  assert(type == MS_SHAPE_LINE || type == MS_SHAPE_POLYGON);
+
+  unsigned num_points = 0;
+  for (unsigned l = 0; l < num_lines; ++l)
+    num_points += lines[l];
+
+  ranks = new float[num_points];
+  const GeoPoint *line_points = points;
+  float *line_ranks = ranks;
+  for (unsigned l = 0; l < num_lines; ++l) {
+    CalculateDouglasPeuckerRanks(line_points, lines[l],
+                                 type == MS_SHAPE_POLYGON,
+                                 line_ranks);
+    line_points += lines[l];
+    line_ranks += lines[l];
+  }
+
+  return ranks;
+}
+
+#endif
+
 #ifdef ENABLE_OPENGL
 
 bool
@@ -87,6 +87,14 @@ class XShape {
   mutable unsigned offset;
 #else // !ENABLE_OPENGL
   GeoPoint *points;
+
+  /**
+   * The Douglas-Peucker rank of each point (see
+   * CalculateDouglasPeuckerRanks()), used to pick a level of detail
+   * for the current map scale.  This is nullptr until GetRanks() is
+   * called for the first time.
+   */
+  mutable float *ranks;
 #endif
 
   AllocatedString<TCHAR> label;
@@ -137,6 +145,15 @@ public:
     return points;
   }
 
+#ifndef ENABLE_OPENGL
+  /**
+   * Returns the Douglas-Peucker rank of each point of a line or
+   * polygon shape.  They are calculated on the first call, so shapes
+   * which are never drawn do not pay for them.
+   */
+  const float *GetRanks() const;
+#endif
+
   const TCHAR *GetLabel() const {
     return label.c_str();
   }
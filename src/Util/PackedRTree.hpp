@@ -0,0 +1,581 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_PACKED_RTREE_HPP
+#define XCSOAR_PACKED_RTREE_HPP
+
+#include "Compiler.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A static R-tree for points, built in one pass from a fixed set of
+ * values.  The values are sorted along a Hilbert curve and packed
+ * into nodes of #NODE_SIZE entries; each tree level is an array of
+ * bounding boxes, and the children of node i are the entries
+ * [i*NODE_SIZE, (i+1)*NODE_SIZE) of the level below.  There are no
+ * pointers: a query walks a few small contiguous arrays, and only
+ * touches a value when its position matches.
+ *
+ * Unlike QuadTree, no values can be added after Build().  It is meant
+ * for data which is loaded once and queried often.  Remove() only
+ * marks a value as removed; its slot stays in the tree until the next
+ * Build().
+ *
+ * The #Accessor class provides GetX() and GetY() for a value, just
+ * like the QuadTree accessor.
+ *
+ * @see https://en.wikipedia.org/wiki/Hilbert_R-tree
+ */
+template<typename T, typename Accessor>
+class PackedRTree {
+  /**
+   * The number of children of each node.
+   */
+  static constexpr unsigned NODE_SIZE = 16;
+
+public:
+  typedef int position_type;
+  typedef uint64_t square_distance_type;
+
+  struct Point {
+    position_type x, y;
+
+    constexpr
+    Point(position_type _x, position_type _y):x(_x), y(_y) {}
+
+    constexpr
+    square_distance_type SquareDistanceTo(const Point &other) const {
+      return Square(int64_t(other.x) - x) + Square(int64_t(other.y) - y);
+    }
+  };
+
+  /**
+   * An axis-aligned rectangle; "top" is the smaller y coordinate.
+   */
+  struct Box {
+    position_type left, top, right, bottom;
+
+    Box() = default;
+
+    constexpr
+    Box(position_type _left, position_type _top,
+        position_type _right, position_type _bottom)
+      :left(_left), top(_top), right(_right), bottom(_bottom) {}
+
+    constexpr
+    bool IsInside(const Point &p) const {
+      return p.x >= left && p.x <= right && p.y >= top && p.y <= bottom;
+    }
+
+    constexpr
+    bool Overlaps(const Box &other) const {
+      return left <= other.right && right >= other.left &&
+        top <= other.bottom && bottom >= other.top;
+    }
+
+    /**
+     * Calculate the square distance from the point to the nearest
+     * point of this box (0 if it is inside).
+     */
+    constexpr
+    square_distance_type SquareDistanceTo(const Point &p) const {
+      return Square(p.x < left ? int64_t(left) - p.x
+                    : (p.x > right ? int64_t(p.x) - right : 0)) +
+        Square(p.y < top ? int64_t(top) - p.y
+               : (p.y > bottom ? int64_t(p.y) - bottom : 0));
+    }
+
+    void Extend(const Point &p) {
+      left = std::min(left, p.x);
+      right = std::max(right, p.x);
+      top = std::min(top, p.y);
+      bottom = std::max(bottom, p.y);
+    }
+
+    void Extend(const Box &other) {
+      left = std::min(left, other.left);
+      right = std::max(right, other.right);
+      top = std::min(top, other.top);
+      bottom = std::max(bottom, other.bottom);
+    }
+  };
+
+  typedef typename std::vector<T>::const_iterator const_iterator;
+
+private:
+  /**
+   * The positions of the values, in the same order as #values.
+   */
+  std::vector<Point> points;
+
+  std::vector<T> values;
+
+  /**
+   * Which of #values have been removed by Remove()?  Queries skip
+   * them.
+   */
+  std::vector<bool> removed;
+
+  /**
+   * The bounding boxes of all levels, the leaf nodes first, the root
+   * last.
+   */
+  std::vector<Box> boxes;
+
+  /**
+   * The index of the first box of each level in #boxes, followed by
+   * the size of #boxes.
+   */
+  std::vector<unsigned> level_offsets;
+
+  Accessor accessor;
+
+public:
+  PackedRTree() = default;
+
+  explicit PackedRTree(const Accessor &_accessor):accessor(_accessor) {}
+
+  constexpr
+  static square_distance_type Square(int64_t x) {
+    return square_distance_type(x * x);
+  }
+
+  gcc_pure
+  bool IsEmpty() const {
+    return values.empty();
+  }
+
+  /**
+   * Returns the number of slots, including removed values.
+   */
+  gcc_pure
+  unsigned size() const {
+    return values.size();
+  }
+
+  /**
+   * Returns the box which contains all values.  The tree must not
+   * be empty.
+   */
+  gcc_pure
+  const Box &GetBounds() const {
+    assert(!IsEmpty());
+
+    return boxes.back();
+  }
+
+  const_iterator begin() const {
+    return values.begin();
+  }
+
+  const_iterator end() const {
+    return values.end();
+  }
+
+  void Clear() {
+    points.clear();
+    values.clear();
+    removed.clear();
+    boxes.clear();
+    level_offsets.clear();
+  }
+
+  /**
+   * Replace the contents with a copy of the given range.
+   */
+  template<typename I>
+  void Build(I first, I last) {
+    Clear();
+
+    std::vector<T> unsorted(first, last);
+    if (unsorted.empty())
+      return;
+
+    Box bounds = GetPointBox(GetPosition(unsorted.front()));
+    for (const auto &i : unsorted)
+      bounds.Extend(GetPosition(i));
+
+    /* sort by Hilbert index on a 65536x65536 grid over the bounds */
+    const int64_t width = int64_t(bounds.right) - bounds.left + 1;
+    const int64_t height = int64_t(bounds.bottom) - bounds.top + 1;
+
+    std::vector<std::pair<uint32_t, unsigned>> order;
+    order.reserve(unsorted.size());
+    for (unsigned i = 0; i < unsorted.size(); ++i) {
+      const Point p = GetPosition(unsorted[i]);
+      const uint32_t x = ((int64_t(p.x) - bounds.left) << 16) / width;
+      const uint32_t y = ((int64_t(p.y) - bounds.top) << 16) / height;
+      order.emplace_back(HilbertIndex(x, y), i);
+    }
+
+    std::sort(order.begin(), order.end());
+
+    points.reserve(order.size());
+    values.reserve(order.size());
+    for (const auto &i : order) {
+      points.push_back(GetPosition(unsorted[i.second]));
+      values.push_back(std::move(unsorted[i.second]));
+    }
+
+    removed.assign(values.size(), false);
+
+    /* the leaf nodes */
+    level_offsets.push_back(0);
+    for (unsigned i = 0; i < points.size(); i += NODE_SIZE) {
+      const unsigned end = std::min<unsigned>(i + NODE_SIZE, points.size());
+      Box box = GetPointBox(points[i]);
+      for (unsigned j = i + 1; j < end; ++j)
+        box.Extend(points[j]);
+      boxes.push_back(box);
+    }
+
+    /* the inner nodes, up to the root */
+    unsigned begin = 0, end = boxes.size();
+    while (end - begin > 1) {
+      level_offsets.push_back(end);
+
+      for (unsigned i = begin; i < end; i += NODE_SIZE) {
+        const unsigned child_end = std::min(i + NODE_SIZE, end);
+        Box box = boxes[i];
+        for (unsigned j = i + 1; j < child_end; ++j)
+          box.Extend(boxes[j]);
+        boxes.push_back(box);
+      }
+
+      begin = end;
+      end = boxes.size();
+    }
+
+    level_offsets.push_back(end);
+  }
+
+  /**
+   * Remove a value from all further query results, and release it.
+   * The tree is not restructured; the value's position (according
+   * to the accessor) must not have changed since Build().
+   *
+   * @return false if the value was not found
+   */
+  bool Remove(const T &value) {
+    if (IsEmpty())
+      return false;
+
+    const Point p = GetPosition(value);
+    unsigned found = values.size();
+    auto visitor = [this, &value, &found](const T &other){
+      if (other == value)
+        found = &other - values.data();
+    };
+
+    Visit(GetRootLevel(), 0,
+          [p](const Box &box){
+            return box.IsInside(p);
+          },
+          [p](const Point &other){
+            return other.x == p.x && other.y == p.y;
+          },
+          visitor);
+
+    if (found == values.size())
+      return false;
+
+    removed[found] = true;
+    values[found] = T();
+    return true;
+  }
+
+  /**
+   * Call the visitor for each value within the given distance.
+   */
+  template<class V>
+  void VisitWithinRange(const Point location, unsigned range,
+                        V &visitor) const {
+    if (IsEmpty())
+      return;
+
+    const square_distance_type square_range = Square(range);
+    Visit(GetRootLevel(), 0,
+          [location, square_range](const Box &box){
+            return box.SquareDistanceTo(location) <= square_range;
+          },
+          [location, square_range](const Point &p){
+            return p.SquareDistanceTo(location) <= square_range;
+          },
+          visitor);
+  }
+
+  /**
+   * Call the visitor for each value inside the given box.
+   */
+  template<class V>
+  void VisitWithinBox(const Box &box, V &visitor) const {
+    if (IsEmpty())
+      return;
+
+    Visit(GetRootLevel(), 0,
+          [&box](const Box &other){
+            return box.Overlaps(other);
+          },
+          [&box](const Point &p){
+            return box.IsInside(p);
+          },
+          visitor);
+  }
+
+  /**
+   * Find the nearest value within the given distance which matches
+   * the predicate.
+   *
+   * @return end() if there is none
+   */
+  template<class P>
+  gcc_pure
+  const_iterator FindNearestIf(const Point location, unsigned range,
+                               const P &predicate) const {
+    if (IsEmpty() ||
+        boxes.back().SquareDistanceTo(location) > Square(range))
+      return end();
+
+    /* only values closer than this are accepted */
+    square_distance_type best_distance = Square(range) + 1;
+    unsigned best = values.size();
+    FindNearestIf(GetRootLevel(), 0, location, predicate,
+                  best_distance, best);
+    return values.begin() + best;
+  }
+
+  gcc_pure
+  const_iterator FindNearest(const Point location, unsigned range) const {
+    return FindNearestIf(location, range, [](const T &){ return true; });
+  }
+
+  /**
+   * Call the visitor for the nearest values within the given
+   * distance which match the predicate, ordered by increasing
+   * distance.  This is a best-first search: nodes are expanded in
+   * the order of their distance, and the search stops as soon as
+   * enough values have been visited.
+   *
+   * @param max_results the maximum number of values to visit
+   * @return the number of values visited
+   */
+  template<class P, class V>
+  unsigned VisitNearestIf(const Point location, unsigned range,
+                          unsigned max_results, const P &predicate,
+                          V &visitor) const {
+    if (IsEmpty() || max_results == 0)
+      return 0;
+
+    const square_distance_type square_range = Square(range);
+
+    std::vector<QueueEntry> queue;
+    queue.reserve(64);
+
+    const auto push = [&queue, square_range](square_distance_type distance,
+                                             unsigned level, unsigned index){
+      if (distance <= square_range) {
+        queue.push_back({distance, level, index});
+        std::push_heap(queue.begin(), queue.end());
+      }
+    };
+
+    push(boxes.back().SquareDistanceTo(location), GetRootLevel() + 1, 0);
+
+    unsigned n = 0;
+    while (!queue.empty()) {
+      std::pop_heap(queue.begin(), queue.end());
+      const QueueEntry entry = queue.back();
+      queue.pop_back();
+
+      if (entry.level == 0) {
+        /* a value; nothing left in the queue can be closer */
+        const T &value = values[entry.index];
+        if (predicate(value)) {
+          visitor(value);
+          if (++n >= max_results)
+            break;
+        }
+
+        continue;
+      }
+
+      /* a node: queue its children */
+      const unsigned level = entry.level - 1;
+      const auto children = GetChildren(level, entry.index);
+      if (level == 0) {
+        for (unsigned i = children.first; i < children.second; ++i)
+          if (!removed[i])
+            push(points[i].SquareDistanceTo(location), 0, i);
+      } else {
+        const Box *const level_boxes = &boxes[level_offsets[level - 1]];
+        for (unsigned i = children.first; i < children.second; ++i)
+          push(level_boxes[i].SquareDistanceTo(location), level, i);
+      }
+    }
+
+    return n;
+  }
+
+private:
+  /**
+   * An entry in the queue of VisitNearestIf().  #level is the tree
+   * level plus one, or 0 for a value.
+   */
+  struct QueueEntry {
+    square_distance_type distance;
+    unsigned level, index;
+
+    /**
+     * Reversed, so std::push_heap() puts the nearest entry on top;
+     * values go before nodes at the same distance.
+     */
+    bool operator<(const QueueEntry &other) const {
+      return distance != other.distance
+        ? distance > other.distance
+        : level > other.level;
+    }
+  };
+
+  static constexpr Box GetPointBox(const Point &p) {
+    return Box(p.x, p.y, p.x, p.y);
+  }
+
+  Point GetPosition(const T &value) const {
+    return Point(accessor.GetX(value), accessor.GetY(value));
+  }
+
+  unsigned GetRootLevel() const {
+    assert(level_offsets.size() >= 2);
+
+    return level_offsets.size() - 2;
+  }
+
+  /**
+   * Returns the index range of the children of the given node: boxes
+   * of the level below, or values if this is a leaf node.
+   */
+  std::pair<unsigned, unsigned> GetChildren(unsigned level,
+                                            unsigned node) const {
+    const unsigned size = level == 0
+      ? values.size()
+      : level_offsets[level] - level_offsets[level - 1];
+    const unsigned first = node * NODE_SIZE;
+    return std::make_pair(first, std::min(first + NODE_SIZE, size));
+  }
+
+  /**
+   * Map a point on a 65536x65536 grid to its position on the Hilbert
+   * curve.
+   */
+  gcc_const
+  static uint32_t HilbertIndex(uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+      const uint32_t rx = (x & s) != 0;
+      const uint32_t ry = (y & s) != 0;
+      d += s * s * ((3 * rx) ^ ry);
+
+      /* rotate the quadrant */
+      if (ry == 0) {
+        if (rx == 1) {
+          x = 0xffff - x;
+          y = 0xffff - y;
+        }
+
+        std::swap(x, y);
+      }
+    }
+
+    return d;
+  }
+
+  template<class B, class M, class V>
+  void Visit(unsigned level, unsigned node,
+             const B &box_predicate, const M &point_predicate,
+             V &visitor) const {
+    const auto children = GetChildren(level, node);
+
+    if (level == 0) {
+      for (unsigned i = children.first; i < children.second; ++i)
+        if (!removed[i] && point_predicate(points[i]))
+          visitor(values[i]);
+    } else {
+      const Box *const level_boxes = &boxes[level_offsets[level - 1]];
+      for (unsigned i = children.first; i < children.second; ++i)
+        if (box_predicate(level_boxes[i]))
+          Visit(level - 1, i, box_predicate, point_predicate, visitor);
+    }
+  }
+
+  template<class P>
+  void FindNearestIf(unsigned level, unsigned node, const Point location,
+                     const P &predicate,
+                     square_distance_type &best_distance,
+                     unsigned &best) const {
+    const auto children = GetChildren(level, node);
+
+    if (level == 0) {
+      for (unsigned i = children.first; i < children.second; ++i) {
+        const square_distance_type distance =
+          points[i].SquareDistanceTo(location);
+        if (distance < best_distance && !removed[i] &&
+            predicate(values[i])) {
+          best_distance = distance;
+          best = i;
+        }
+      }
+
+      return;
+    }
+
+    /* descend into the closest child nodes first, so the others can
+       be skipped once a close value has been found */
+    const Box *const level_boxes = &boxes[level_offsets[level - 1]];
+    std::pair<square_distance_type, unsigned> sorted[NODE_SIZE];
+    unsigned n = 0;
+    for (unsigned i = children.first; i < children.second; ++i) {
+      const square_distance_type distance =
+        level_boxes[i].SquareDistanceTo(location);
+      if (distance >= best_distance)
+        continue;
+
+      /* insertion sort; there are only a few children */
+      unsigned j = n++;
+      for (; j > 0 && sorted[j - 1].first > distance; --j)
+        sorted[j] = sorted[j - 1];
+      sorted[j] = std::make_pair(distance, i);
+    }
+
+    for (unsigned i = 0; i < n && sorted[i].first < best_distance; ++i)
+      FindNearestIf(level - 1, sorted[i].second, location, predicate,
+                    best_distance, best);
+  }
+};
+
+#endif
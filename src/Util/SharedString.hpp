@@ -0,0 +1,238 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_SHARED_STRING_HPP
+#define XCSOAR_SHARED_STRING_HPP
+
+#include "tstring.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <unordered_set>
+#include <utility>
+
+#include <string.h>
+#include <tchar.h>
+
+/**
+ * An immutable string whose buffer may be shared with other
+ * instances.  Copying it only copies a pointer; assigning a new
+ * value allocates a new buffer, and does not affect the copies.  The
+ * reference counter and the characters are in one heap block, and
+ * the empty string does not allocate anything.
+ *
+ * Together with #SharedStringPool, this allows many objects to share
+ * one copy of a string which is duplicated often, e.g. a waypoint
+ * comment.
+ */
+class SharedString {
+  struct Buffer {
+    std::atomic<unsigned> references;
+    unsigned length;
+
+    /**
+     * The null-terminated characters; the allocation is extended
+     * by the length of the string.
+     */
+    TCHAR data[1];
+  };
+
+  Buffer *buffer = nullptr;
+
+public:
+  SharedString() = default;
+
+  explicit SharedString(const TCHAR *value) {
+    assign(value);
+  }
+
+  explicit SharedString(const tstring &value) {
+    assign(value);
+  }
+
+  SharedString(const SharedString &other):buffer(other.buffer) {
+    if (buffer != nullptr)
+      ++buffer->references;
+  }
+
+  SharedString(SharedString &&other):buffer(other.buffer) {
+    other.buffer = nullptr;
+  }
+
+  ~SharedString() {
+    Release();
+  }
+
+  SharedString &operator=(const SharedString &other) {
+    SharedString copy(other);
+    std::swap(buffer, copy.buffer);
+    return *this;
+  }
+
+  SharedString &operator=(SharedString &&other) {
+    std::swap(buffer, other.buffer);
+    return *this;
+  }
+
+  SharedString &operator=(const TCHAR *value) {
+    assign(value);
+    return *this;
+  }
+
+  SharedString &operator=(const tstring &value) {
+    assign(value);
+    return *this;
+  }
+
+  void assign(const TCHAR *value, size_t length) {
+    Release();
+
+    if (length == 0)
+      return;
+
+    void *p = ::operator new(sizeof(Buffer) + length * sizeof(TCHAR));
+    buffer = new(p) Buffer;
+    buffer->references = 1;
+    buffer->length = length;
+    std::copy_n(value, length, buffer->data);
+    buffer->data[length] = _T('\0');
+  }
+
+  void assign(const TCHAR *value) {
+    assign(value, _tcslen(value));
+  }
+
+  void assign(const tstring &value) {
+    assign(value.data(), value.length());
+  }
+
+  void clear() {
+    Release();
+  }
+
+  gcc_pure
+  const TCHAR *c_str() const {
+    return buffer != nullptr ? buffer->data : _T("");
+  }
+
+  gcc_pure
+  bool empty() const {
+    return buffer == nullptr;
+  }
+
+  gcc_pure
+  size_t length() const {
+    return buffer != nullptr ? buffer->length : 0;
+  }
+
+  /**
+   * Does this instance share its buffer with the other one?
+   */
+  gcc_pure
+  bool IsSharedWith(const SharedString &other) const {
+    return buffer == other.buffer;
+  }
+
+  gcc_pure
+  bool operator==(const SharedString &other) const {
+    return buffer == other.buffer ||
+      (length() == other.length() &&
+       std::equal(c_str(), c_str() + length(), other.c_str()));
+  }
+
+  gcc_pure
+  bool operator!=(const SharedString &other) const {
+    return !(*this == other);
+  }
+
+  gcc_pure
+  bool operator==(const tstring &other) const {
+    return other.compare(c_str()) == 0;
+  }
+
+  gcc_pure
+  bool operator!=(const tstring &other) const {
+    return !(*this == other);
+  }
+
+  gcc_pure
+  bool operator==(const TCHAR *other) const {
+    return _tcscmp(c_str(), other) == 0;
+  }
+
+  gcc_pure
+  bool operator!=(const TCHAR *other) const {
+    return !(*this == other);
+  }
+
+  gcc_pure
+  bool operator<(const SharedString &other) const {
+    return _tcscmp(c_str(), other.c_str()) < 0;
+  }
+
+private:
+  void Release() {
+    if (buffer != nullptr && --buffer->references == 0) {
+      buffer->~Buffer();
+      ::operator delete(buffer);
+    }
+
+    buffer = nullptr;
+  }
+};
+
+/**
+ * Finds the #SharedString instance with the same contents, so all
+ * copies of a string share one buffer.  The pool holds a reference
+ * to each string; it is meant to be used while loading a batch of
+ * objects, and to be destructed afterwards.
+ */
+class SharedStringPool {
+  struct Hash {
+    gcc_pure
+    size_t operator()(const SharedString &s) const {
+      /* code copied from libstdc++ backward/hash_fun.h */
+      size_t h = 0;
+      for (const TCHAR *p = s.c_str(); *p != _T('\0'); ++p)
+        h = 5 * h + *p;
+      return h;
+    }
+  };
+
+  std::unordered_set<SharedString, Hash> strings;
+
+public:
+  /**
+   * Returns the pooled instance with the same contents, after
+   * adding this one if there is none.
+   */
+  SharedString Intern(const SharedString &s) {
+    if (s.empty())
+      return s;
+
+    return *strings.insert(s).first;
+  }
+};
+
+#endif
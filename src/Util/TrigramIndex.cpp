@@ -0,0 +1,346 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "TrigramIndex.hpp"
+#include "StringUtil.hpp"
+#include "StringAPI.hxx"
+
+#include <algorithm>
+#include <iterator>
+
+#include <assert.h>
+
+/**
+ * Map a character of a normalised string (a digit or an upper case
+ * ASCII letter) to the range 0..35.
+ */
+static constexpr unsigned
+GetSymbol(TCHAR ch)
+{
+  return ch <= _T('9')
+    ? unsigned(ch - _T('0'))
+    : unsigned(ch - _T('A')) + 10;
+}
+
+static constexpr unsigned
+GetTrigram(const TCHAR *p)
+{
+  return (GetSymbol(p[0]) * 36 + GetSymbol(p[1])) * 36 + GetSymbol(p[2]);
+}
+
+template<typename F>
+static void
+ForEachTrigram(const TCHAR *p, F &&f)
+{
+  for (; p[0] != 0 && p[1] != 0 && p[2] != 0; ++p)
+    f(GetTrigram(p));
+}
+
+static constexpr unsigned
+VarIntSize(unsigned value)
+{
+  return value < (1u << 7)
+    ? 1
+    : (value < (1u << 14)
+       ? 2
+       : (value < (1u << 21) ? 3 : (value < (1u << 28) ? 4 : 5)));
+}
+
+static uint8_t *
+WriteVarInt(uint8_t *p, unsigned value)
+{
+  while (value >= 0x80) {
+    *p++ = uint8_t(value | 0x80);
+    value >>= 7;
+  }
+
+  *p++ = uint8_t(value);
+  return p;
+}
+
+/**
+ * Invoke the function on each id of a posting list.  Each entry is
+ * the difference to the previous id plus one, so the first one is
+ * encoded like the others.
+ */
+template<typename F>
+static void
+ForEachPosting(const uint8_t *p, const uint8_t *end, F &&f)
+{
+  unsigned id_plus_one = 0;
+  while (p != end) {
+    unsigned delta = 0, shift = 0;
+    uint8_t byte;
+    do {
+      byte = *p++;
+      delta |= unsigned(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+
+    id_plus_one += delta;
+    f(id_plus_one - 1);
+  }
+}
+
+/**
+ * Checks whether a normalised string contains the normalised query,
+ * allowing the specified number of errors.
+ */
+class TrigramMatcher {
+  std::vector<TCHAR> query;
+  unsigned length;
+  unsigned max_errors;
+
+  /**
+   * The query split into max_errors+1 pieces, each null-terminated.
+   * Each error affects at most one of them, so a match contains at
+   * least one piece unmodified.
+   */
+  std::vector<TCHAR> pieces;
+
+  /**
+   * One column of the edit distance matrix.
+   */
+  std::vector<unsigned> column;
+
+public:
+  TrigramMatcher(const TCHAR *_query, unsigned _max_errors)
+    :query(StringLength(_query) + 1) {
+    NormalizeSearchString(query.data(), _query);
+    length = StringLength(query.data());
+    max_errors = length > 0 ? std::min(_max_errors, length - 1) : 0;
+    column.resize(length + 1);
+
+    for (unsigned i = 0, start = 0; i <= max_errors; ++i) {
+      const unsigned end = length * (i + 1) / (max_errors + 1);
+      pieces.insert(pieces.end(),
+                    query.begin() + start, query.begin() + end);
+      pieces.push_back(0);
+      start = end;
+    }
+  }
+
+  const TCHAR *GetQuery() const {
+    return query.data();
+  }
+
+  unsigned GetLength() const {
+    return length;
+  }
+
+  unsigned GetMaxErrors() const {
+    return max_errors;
+  }
+
+  bool Check(const TCHAR *s, unsigned &errors_r) {
+    if (max_errors == 0) {
+      errors_r = 0;
+      return StringFind(s, query.data()) != nullptr;
+    }
+
+    if (!ContainsPiece(s))
+      return false;
+
+    const unsigned errors = SubstringDistance(s);
+    if (errors > max_errors)
+      return false;
+
+    errors_r = errors;
+    return true;
+  }
+
+private:
+  gcc_pure
+  bool ContainsPiece(const TCHAR *s) const {
+    const TCHAR *const end = pieces.data() + pieces.size();
+    for (const TCHAR *piece = pieces.data(); piece != end;
+         piece += StringLength(piece) + 1)
+      if (StringFind(s, piece) != nullptr)
+        return true;
+
+    return false;
+  }
+
+  /**
+   * Determine the smallest edit distance between the query and any
+   * substring of the specified string (Sellers' algorithm: like
+   * Levenshtein, but the match may begin and end anywhere).
+   */
+  unsigned SubstringDistance(const TCHAR *s) {
+    for (unsigned i = 0; i <= length; ++i)
+      column[i] = i;
+
+    unsigned best = length;
+    for (; *s != 0 && best > 0; ++s) {
+      /* column[0] remains 0: the match may begin anywhere */
+      unsigned diagonal = 0;
+      for (unsigned i = 1; i <= length; ++i) {
+        const unsigned left = column[i];
+        column[i] = std::min({diagonal + (query[i - 1] != *s),
+                              left + 1, column[i - 1] + 1});
+        diagonal = left;
+      }
+
+      best = std::min(best, column[length]);
+    }
+
+    return best;
+  }
+};
+
+void
+TrigramIndex::Clear()
+{
+  text.clear();
+  offsets.clear();
+  posting_offsets.clear();
+  postings.clear();
+}
+
+void
+TrigramIndex::Add(const TCHAR *s)
+{
+  assert(!IsBuilt());
+
+  const size_t offset = text.size();
+  offsets.push_back(offset);
+
+  text.resize(offset + StringLength(s) + 1);
+  TCHAR *dest = text.data() + offset;
+  NormalizeSearchString(dest, s);
+  text.resize(offset + StringLength(dest) + 1);
+}
+
+void
+TrigramIndex::Build()
+{
+  assert(!IsBuilt());
+
+  posting_offsets.assign(N_TRIGRAMS + 1, 0);
+
+  /* the id plus one of the last string in each posting list */
+  std::vector<unsigned> last(N_TRIGRAMS, 0);
+
+  /* pass 1: determine the size of each posting list */
+  for (unsigned id = 0; id < size(); ++id)
+    ForEachTrigram(GetNormalised(id), [this, &last, id](unsigned t){
+        if (last[t] != id + 1) {
+          posting_offsets[t + 1] += VarIntSize(id + 1 - last[t]);
+          last[t] = id + 1;
+        }
+      });
+
+  for (unsigned t = 0; t < N_TRIGRAMS; ++t)
+    posting_offsets[t + 1] += posting_offsets[t];
+
+  postings.resize(posting_offsets.back());
+
+  /* pass 2: fill them */
+  std::vector<unsigned> position(posting_offsets.begin(),
+                                 std::prev(posting_offsets.end()));
+  std::fill(last.begin(), last.end(), 0);
+
+  for (unsigned id = 0; id < size(); ++id)
+    ForEachTrigram(GetNormalised(id), [this, &last, &position, id](unsigned t){
+        if (last[t] != id + 1) {
+          uint8_t *p = postings.data() + position[t];
+          position[t] = WriteVarInt(p, id + 1 - last[t]) - postings.data();
+          last[t] = id + 1;
+        }
+      });
+
+  text.shrink_to_fit();
+  offsets.shrink_to_fit();
+}
+
+size_t
+TrigramIndex::GetMemoryUsage() const
+{
+  return text.capacity() * sizeof(text.front()) +
+    offsets.capacity() * sizeof(offsets.front()) +
+    posting_offsets.capacity() * sizeof(posting_offsets.front()) +
+    postings.capacity() * sizeof(postings.front());
+}
+
+void
+TrigramIndex::Search(const TCHAR *query, unsigned max_errors,
+                     std::vector<Match> &matches) const
+{
+  assert(IsBuilt());
+
+  TrigramMatcher matcher(query, max_errors);
+
+  std::vector<unsigned> trigrams;
+  ForEachTrigram(matcher.GetQuery(), [&trigrams](unsigned t){
+      trigrams.push_back(t);
+    });
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+
+  const unsigned lost = 3 * matcher.GetMaxErrors();
+  if (trigrams.size() <= lost) {
+    /* no trigram is guaranteed to survive the errors */
+    Scan(query, max_errors, matches);
+    return;
+  }
+
+  /* the counters saturate at 255; a lower threshold only admits
+     more candidates */
+  const unsigned threshold = std::min<unsigned>(trigrams.size() - lost, 255);
+
+  std::vector<uint8_t> counts(size(), 0);
+  std::vector<unsigned> candidates;
+  for (const unsigned t : trigrams)
+    ForEachPosting(postings.data() + posting_offsets[t],
+                   postings.data() + posting_offsets[t + 1],
+                   [&counts, &candidates, threshold](unsigned id){
+                     if (counts[id] < 255 && ++counts[id] == threshold)
+                       candidates.push_back(id);
+                   });
+
+  std::sort(candidates.begin(), candidates.end());
+
+  matches.clear();
+  for (const unsigned id : candidates) {
+    unsigned errors;
+    if (matcher.Check(GetNormalised(id), errors))
+      matches.push_back({id, errors});
+  }
+}
+
+void
+TrigramIndex::Scan(const TCHAR *query, unsigned max_errors,
+                   std::vector<Match> &matches) const
+{
+  TrigramMatcher matcher(query, max_errors);
+
+  matches.clear();
+  if (matcher.GetLength() == 0)
+    return;
+
+  for (unsigned id = 0; id < size(); ++id) {
+    unsigned errors;
+    if (matcher.Check(GetNormalised(id), errors))
+      matches.push_back({id, errors});
+  }
+}
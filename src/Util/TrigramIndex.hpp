@@ -0,0 +1,137 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_TRIGRAM_INDEX_HPP
+#define XCSOAR_TRIGRAM_INDEX_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tchar.h>
+
+/**
+ * An inverted index of the three-character substrings ("trigrams")
+ * of a list of strings, for substring and typo-tolerant search.
+ *
+ * Strings are normalised with NormalizeSearchString(), i.e. only
+ * letters and digits are indexed and case is ignored.  This leaves
+ * 36 symbols, so the posting list of each of the 36^3 trigrams can
+ * be addressed directly.  A posting list contains the ascending ids
+ * of all strings containing the trigram, delta-encoded as
+ * variable-length integers; most deltas fit in one byte.
+ *
+ * Usage: call Add() for each string, then Build() once.  The id of a
+ * string is the number of Add() calls before it.
+ */
+class TrigramIndex {
+  static constexpr unsigned ALPHABET_SIZE = 10 + 26;
+  static constexpr unsigned N_TRIGRAMS =
+    ALPHABET_SIZE * ALPHABET_SIZE * ALPHABET_SIZE;
+
+  /**
+   * The normalised strings, each with a null terminator.
+   */
+  std::vector<TCHAR> text;
+
+  /**
+   * The position of each string in #text.
+   */
+  std::vector<unsigned> offsets;
+
+  /**
+   * The position of each posting list in #postings, plus the end of
+   * the last one.  Empty until Build() is called.
+   */
+  std::vector<unsigned> posting_offsets;
+
+  std::vector<uint8_t> postings;
+
+public:
+  struct Match {
+    unsigned id;
+
+    /**
+     * The number of inserted, deleted or replaced characters.
+     */
+    unsigned errors;
+  };
+
+  unsigned size() const {
+    return offsets.size();
+  }
+
+  bool IsBuilt() const {
+    return !posting_offsets.empty();
+  }
+
+  void Clear();
+
+  void Add(const TCHAR *s);
+
+  /**
+   * Generate the posting lists.  No more strings may be added
+   * afterwards.
+   */
+  void Build();
+
+  /**
+   * Returns the normalised string with the specified id.
+   */
+  const TCHAR *GetNormalised(unsigned id) const {
+    return text.data() + offsets[id];
+  }
+
+  /**
+   * Returns the number of bytes allocated for the normalised
+   * strings, the posting lists and their offsets.
+   */
+  gcc_pure
+  size_t GetMemoryUsage() const;
+
+  /**
+   * Find all strings which contain the (normalised) query with at
+   * most the specified number of errors.  Candidates are determined
+   * from the posting lists: each error destroys at most three
+   * trigrams of the query, so a match must contain all but
+   * 3*max_errors of them.  Short queries which leave no trigram to
+   * filter with fall back to Scan().
+   *
+   * @param max_errors the maximum number of typos (inserted, deleted
+   * or replaced characters); it is limited to the query length minus
+   * one
+   * @param matches receives the matches, ordered by id
+   */
+  void Search(const TCHAR *query, unsigned max_errors,
+              std::vector<Match> &matches) const;
+
+  /**
+   * Like Search(), but checks every string instead of consulting the
+   * posting lists.  Does not require Build().
+   */
+  void Scan(const TCHAR *query, unsigned max_errors,
+            std::vector<Match> &matches) const;
+};
+
+#endif
@@ -143,7 +143,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
-    WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+    WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
     WaypointDetails::ReadFileFromProfile(way_points, operation);
   }
 
@@ -26,6 +26,39 @@ Copyright_License {
 #include "IO/BufferedOutputStream.hxx"
 #include "Engine/Waypoint/Runway.hpp"
 
+#include <algorithm>
+#include <vector>
+
+/**
+ * Format an unsigned integer with at least the given number of
+ * digits, padded with zeroes.  This is a lot cheaper than printf(),
+ * which matters when exporting large waypoint files.
+ *
+ * @return the end of the string (not null-terminated)
+ */
+static char *
+FormatDigits(char *p, unsigned value, unsigned width=1)
+{
+  char buffer[16];
+  char *q = buffer + sizeof(buffer);
+  do {
+    *--q = '0' + value % 10;
+    value /= 10;
+  } while (value > 0);
+
+  while (buffer + sizeof(buffer) - q < (ptrdiff_t)width)
+    *--q = '0';
+
+  return std::copy(q, buffer + sizeof(buffer), p);
+}
+
+static void
+WriteDigits(BufferedOutputStream &writer, unsigned value, unsigned width=1)
+{
+  char buffer[16];
+  writer.Write(buffer, FormatDigits(buffer, value, width) - buffer);
+}
+
 static void
 WriteAngleDMM(BufferedOutputStream &writer, const Angle angle, bool is_latitude)
 {
@@ -34,21 +67,33 @@ WriteAngleDMM(BufferedOutputStream &writer, const Angle angle, bool is_latitude)
   bool is_positive;
   angle.ToDMM(deg, min, mmm, is_positive);
 
-  // Save them into the buffer string
-  writer.Format(is_latitude ? "%02u%02u.%03u" : "%03u%02u.%03u",
-                deg, min, mmm);
+  // Format "DDMM.mmmN" or "DDDMM.mmmE"
+  char buffer[16], *p = buffer;
+  p = FormatDigits(p, deg, is_latitude ? 2 : 3);
+  p = FormatDigits(p, min, 2);
+  *p++ = '.';
+  p = FormatDigits(p, mmm, 3);
 
-  // Attach the buffer string to the output
   if (is_latitude)
-    writer.Write(is_positive ? "N" : "S");
+    *p++ = is_positive ? 'N' : 'S';
   else
-    writer.Write(is_positive ? "E" : "W");
+    *p++ = is_positive ? 'E' : 'W';
+
+  writer.Write(buffer, p - buffer);
 }
 
 static void
 WriteAltitude(BufferedOutputStream &writer, double altitude)
 {
-  writer.Format("%dM", (int)altitude);
+  const int value = (int)altitude;
+
+  char buffer[16], *p = buffer;
+  if (value < 0)
+    *p++ = '-';
+  p = FormatDigits(p, value < 0 ? -value : value);
+  *p++ = 'M';
+
+  writer.Write(buffer, p - buffer);
 }
 
 static void
@@ -140,22 +185,28 @@ WriteCup(BufferedOutputStream &writer, const Waypoint &wp)
   if ((wp.type == Waypoint::Type::AIRFIELD ||
        wp.type == Waypoint::Type::OUTLANDING) &&
       wp.runway.IsDirectionDefined())
-    writer.Format("%03u", wp.runway.GetDirectionDegrees());
+    WriteDigits(writer, wp.runway.GetDirectionDegrees(), 3);
 
   writer.Write(',');
 
   // Write Runway Length
   if ((wp.type == Waypoint::Type::AIRFIELD ||
        wp.type == Waypoint::Type::OUTLANDING) &&
-      wp.runway.IsLengthDefined())
-    writer.Format("%03uM", wp.runway.GetLength());
+      wp.runway.IsLengthDefined()) {
+    WriteDigits(writer, wp.runway.GetLength(), 3);
+    writer.Write('M');
+  }
 
   writer.Write(',');
 
   // Write Airport Frequency
   if (wp.radio_frequency.IsDefined()) {
     const unsigned freq = wp.radio_frequency.GetKiloHertz();
-    writer.Format("\"%u.%03u\"", freq / 1000, freq % 1000);
+    writer.Write('"');
+    WriteDigits(writer, freq / 1000);
+    writer.Write('.');
+    WriteDigits(writer, freq % 1000, 3);
+    writer.Write('"');
   }
 
   writer.Write(',');
@@ -171,12 +222,21 @@ void
 WriteCup(BufferedOutputStream &writer, const Waypoints &waypoints,
          WaypointOrigin origin)
 {
-  // Iterate through the waypoint list and save each waypoint with
-  // the right file number to the BufferedOutputStream
-  /// @todo JMW: iteration ordered by ID would be preferred
-  for (auto i : waypoints) {
+  /* write the waypoints ordered by id, i.e. in the order they were
+     loaded or created, which keeps the file stable across rewrites;
+     the Waypoints iterator follows the internal tree layout */
+  std::vector<const Waypoint *> list;
+  for (const auto &i : waypoints) {
     const Waypoint &wp = *i;
     if (wp.origin == origin)
-      WriteCup(writer, wp);
+      list.push_back(&wp);
   }
+
+  std::sort(list.begin(), list.end(),
+            [](const Waypoint *a, const Waypoint *b){
+              return a->id < b->id;
+            });
+
+  for (const Waypoint *wp : list)
+    WriteCup(writer, *wp);
 }
@@ -23,8 +23,11 @@ Copyright_License {
 
 #include "WaypointGlue.hpp"
 #include "CupWriter.hpp"
+#include "WaypointJournal.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
 #include "LogFile.hpp"
 #include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
 #include "IO/FileOutputStream.hxx"
 #include "IO/BufferedOutputStream.hxx"
 #include "LocalPath.hpp"
@@ -42,19 +45,42 @@ WaypointGlue::SaveWaypoints(const Waypoints &way_points)
   writer.Flush();
   file.Commit();
 
+  /* the file contains all changes now; if we get interrupted before
+     the journal is deleted, replaying it again is harmless */
+  File::Delete(LocalPath(_T("user.journal")));
+
   LogFormat(_T("Waypoint file '%s' saved"), path.c_str());
 }
 
-void
-WaypointGlue::SaveWaypoint(const Waypoint &wp)
+static void
+AppendJournal(const Waypoint *removed, const Waypoint *added)
 {
-  const auto path = LocalPath(_T("user.cup"));
+  const auto path = LocalPath(_T("user.journal"));
 
   FileOutputStream file(path, FileOutputStream::Mode::APPEND_OR_CREATE);
   BufferedOutputStream writer(file);
 
-  WriteCup(writer, wp);
+  if (removed != nullptr)
+    WriteJournalRecord(writer, WaypointJournalRecord::REMOVE, *removed);
+
+  if (added != nullptr)
+    WriteJournalRecord(writer, WaypointJournalRecord::ADD, *added);
 
   writer.Flush();
   file.Commit();
 }
+
+void
+WaypointGlue::SaveWaypoint(const Waypoint &wp)
+{
+  AppendJournal(nullptr, &wp);
+}
+
+void
+WaypointGlue::SaveReplacedWaypoint(const Waypoint &old_wp,
+                                   const Waypoint &new_wp)
+{
+  /* only user waypoints are saved; others stay in their files */
+  AppendJournal(old_wp.origin == WaypointOrigin::USER ? &old_wp : nullptr,
+                &new_wp);
+}
@@ -0,0 +1,348 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WaypointCache.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+struct WaypointCacheHeader {
+  static constexpr uint32_t VERSION = 2;
+
+  uint32_t version;
+  uint32_t tchar_size;
+  uint32_t n_waypoints;
+
+  /**
+   * The identity of the terrain file which provided missing
+   * elevations (see TerrainIdentity), followed by its path after the
+   * path of the waypoint file.
+   */
+  uint64_t terrain_size, terrain_mtime;
+};
+
+/**
+ * Identifies the version of the terrain file, so elevations taken
+ * from another terrain are not used.
+ */
+struct TerrainIdentity {
+  tstring path;
+  uint64_t size = 0, mtime = 0;
+
+  explicit TerrainIdentity(Path _path) {
+    if (!_path.IsNull()) {
+      path = _path.c_str();
+      size = File::GetSize(_path);
+      mtime = File::GetLastModification(_path);
+    }
+  }
+};
+
+/**
+ * The fixed-size attributes of a #Waypoint, as stored in the cache.
+ */
+struct WaypointCacheRecord {
+  uint32_t original_id;
+  double latitude, longitude;
+  double elevation;
+  Runway runway;
+  RadioFrequency radio_frequency;
+  Waypoint::Type type;
+  Waypoint::Flags flags;
+};
+
+static bool
+WriteString(FILE *file, const TCHAR *value, uint32_t length)
+{
+  return fwrite(&length, sizeof(length), 1, file) == 1 &&
+    fwrite(value, sizeof(TCHAR), length, file) == length;
+}
+
+static bool
+WriteString(FILE *file, const tstring &value)
+{
+  return WriteString(file, value.data(), value.length());
+}
+
+static bool
+WriteString(FILE *file, const SharedString &value)
+{
+  return WriteString(file, value.c_str(), value.length());
+}
+
+static bool
+WriteStringList(FILE *file, const std::forward_list<tstring> &list)
+{
+  const uint32_t n = std::distance(list.begin(), list.end());
+  if (fwrite(&n, sizeof(n), 1, file) != 1)
+    return false;
+
+  for (const auto &i : list)
+    if (!WriteString(file, i))
+      return false;
+
+  return true;
+}
+
+static bool
+WriteWaypoint(FILE *file, const Waypoint &waypoint)
+{
+  WaypointCacheRecord record;
+  /* clear the padding, to make the file reproducible */
+  memset(&record, 0, sizeof(record));
+  record.original_id = waypoint.original_id;
+  record.latitude = waypoint.location.latitude.Native();
+  record.longitude = waypoint.location.longitude.Native();
+  record.elevation = waypoint.elevation;
+  record.runway = waypoint.runway;
+  record.radio_frequency = waypoint.radio_frequency;
+  record.type = waypoint.type;
+  record.flags = waypoint.flags;
+
+  return fwrite(&record, sizeof(record), 1, file) == 1 &&
+    WriteString(file, waypoint.name) &&
+    WriteString(file, waypoint.comment) &&
+    WriteString(file, waypoint.details) &&
+    WriteStringList(file, waypoint.files_embed)
+#ifdef HAVE_RUN_FILE
+    && WriteStringList(file, waypoint.files_external)
+#endif
+    ;
+}
+
+/**
+ * Decodes the cache from a memory buffer; this is a lot faster than
+ * many small fread() calls.
+ */
+class CacheReader {
+  const uint8_t *position;
+  const uint8_t *const end;
+
+public:
+  CacheReader(const void *data, size_t size)
+    :position((const uint8_t *)data), end(position + size) {}
+
+  bool Read(void *dest, size_t size) {
+    if (size > size_t(end - position))
+      return false;
+
+    memcpy(dest, position, size);
+    position += size;
+    return true;
+  }
+
+  template<typename T>
+  bool Read(T &dest) {
+    return Read(&dest, sizeof(dest));
+  }
+
+  /**
+   * Read a #tstring or a #SharedString.
+   */
+  template<typename S>
+  bool ReadString(S &value) {
+    uint32_t length;
+    if (!Read(length) ||
+        length > size_t(end - position) / sizeof(TCHAR))
+      return false;
+
+    value.assign((const TCHAR *)(const void *)position, length);
+    position += length * sizeof(TCHAR);
+    return true;
+  }
+
+  bool ReadStringList(std::forward_list<tstring> &list) {
+    uint32_t n;
+    if (!Read(n) || n > 1024)
+      return false;
+
+    auto i = list.before_begin();
+    for (uint32_t j = 0; j < n; ++j) {
+      i = list.emplace_after(i);
+      if (!ReadString(*i))
+        return false;
+    }
+
+    return true;
+  }
+
+  bool ReadWaypoint(Waypoint &waypoint) {
+    WaypointCacheRecord record;
+    if (!Read(record))
+      return false;
+
+    waypoint.original_id = record.original_id;
+    waypoint.location = GeoPoint(Angle::Native(record.longitude),
+                                 Angle::Native(record.latitude));
+    if (!waypoint.location.Check())
+      return false;
+
+    waypoint.elevation = record.elevation;
+    waypoint.runway = record.runway;
+    waypoint.radio_frequency = record.radio_frequency;
+    waypoint.type = record.type;
+    waypoint.flags = record.flags;
+
+    return ReadString(waypoint.name) &&
+      ReadString(waypoint.comment) &&
+      ReadString(waypoint.details) &&
+      ReadStringList(waypoint.files_embed)
+#ifdef HAVE_RUN_FILE
+      && ReadStringList(waypoint.files_external)
+#endif
+      ;
+  }
+};
+
+static bool
+LoadWaypointCache(FILE *file, Path original_path,
+                  const TerrainIdentity &terrain,
+                  WaypointOrigin origin, std::vector<Waypoint> &waypoints)
+{
+  /* read the rest of the file at once */
+  const long offset = ftell(file);
+  if (offset < 0 || fseek(file, 0, SEEK_END) != 0)
+    return false;
+
+  const long size = ftell(file) - offset;
+  if (size <= 0 || fseek(file, offset, SEEK_SET) != 0)
+    return false;
+
+  std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+  if (fread(data.get(), 1, size, file) != size_t(size))
+    return false;
+
+  CacheReader reader(data.get(), size);
+
+  WaypointCacheHeader header;
+  if (!reader.Read(header) ||
+      header.version != WaypointCacheHeader::VERSION ||
+      header.tchar_size != sizeof(TCHAR) ||
+      header.terrain_size != terrain.size ||
+      header.terrain_mtime != terrain.mtime)
+    return false;
+
+  /* the cache file name does not identify the waypoint file; compare
+     the path it was created from */
+  tstring path;
+  if (!reader.ReadString(path) || path != original_path.c_str() ||
+      !reader.ReadString(path) || path != terrain.path)
+    return false;
+
+  /* each waypoint needs at least one record */
+  if (header.n_waypoints > size / sizeof(WaypointCacheRecord))
+    return false;
+
+  waypoints.resize(header.n_waypoints);
+  for (auto &waypoint : waypoints) {
+    waypoint.origin = origin;
+    if (!reader.ReadWaypoint(waypoint))
+      return false;
+  }
+
+  return true;
+}
+
+bool
+LoadWaypointCache(FileCache &cache, const TCHAR *name, Path original_path,
+                  Path terrain_path, WaypointOrigin origin,
+                  Waypoints &way_points)
+{
+  FILE *file = cache.Load(name, original_path);
+  if (file == nullptr)
+    return false;
+
+  std::vector<Waypoint> waypoints;
+  const bool success = LoadWaypointCache(file, original_path,
+                                         TerrainIdentity(terrain_path),
+                                         origin, waypoints);
+  fclose(file);
+
+  if (success)
+    way_points.Append(std::move(waypoints));
+
+  return success;
+}
+
+static bool
+SaveWaypointCache(FILE *file, Path original_path,
+                  const TerrainIdentity &terrain,
+                  const std::vector<const Waypoint *> &waypoints)
+{
+  WaypointCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = WaypointCacheHeader::VERSION;
+  header.tchar_size = sizeof(TCHAR);
+  header.n_waypoints = waypoints.size();
+  header.terrain_size = terrain.size;
+  header.terrain_mtime = terrain.mtime;
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      !WriteString(file, original_path.c_str()) ||
+      !WriteString(file, terrain.path))
+    return false;
+
+  for (const Waypoint *waypoint : waypoints)
+    if (!WriteWaypoint(file, *waypoint))
+      return false;
+
+  return true;
+}
+
+bool
+SaveWaypointCache(FileCache &cache, const TCHAR *name, Path original_path,
+                  Path terrain_path, WaypointOrigin origin,
+                  const Waypoints &way_points)
+{
+  std::vector<const Waypoint *> waypoints;
+  for (const auto &i : way_points)
+    if (i->origin == origin)
+      waypoints.push_back(i.get());
+
+  /* the QuadTree does not preserve the order; the ids do */
+  std::sort(waypoints.begin(), waypoints.end(),
+            [](const Waypoint *a, const Waypoint *b){
+              return a->id < b->id;
+            });
+
+  FILE *file = cache.Save(name, original_path);
+  if (file == nullptr)
+    return false;
+
+  if (!SaveWaypointCache(file, original_path, TerrainIdentity(terrain_path),
+                         waypoints)) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
@@ -0,0 +1,62 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_WAYPOINT_CACHE_HPP
+#define XCSOAR_WAYPOINT_CACHE_HPP
+
+#include "Engine/Waypoint/Origin.hpp"
+
+#include <tchar.h>
+
+class Path;
+class FileCache;
+class Waypoints;
+
+/**
+ * Load the waypoints of one file from the binary cache instead of
+ * parsing the file.  Nothing is added unless the whole cache could
+ * be read.
+ *
+ * @param name the name of the cache file
+ * @param terrain_path the terrain file which provides elevations
+ * missing in the file, or nullptr if there is none.  Its path,
+ * modification time and size must match the cache, because the cache
+ * contains those elevations.
+ * @return true on success, false if the cache is missing, stale or
+ * corrupt
+ */
+bool
+LoadWaypointCache(FileCache &cache, const TCHAR *name, Path original_path,
+                  Path terrain_path, WaypointOrigin origin,
+                  Waypoints &way_points);
+
+/**
+ * Store all waypoints with the given origin in the binary cache, in
+ * the order in which they were added.
+ */
+bool
+SaveWaypointCache(FileCache &cache, const TCHAR *name, Path original_path,
+                  Path terrain_path, WaypointOrigin origin,
+                  const Waypoints &way_points);
+
+#endif
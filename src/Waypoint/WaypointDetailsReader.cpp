@@ -30,9 +30,35 @@ Copyright_License {
 #include "IO/ConfiguredFile.hpp"
 #include "IO/LineReader.hpp"
 #include "Operation/Operation.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringUtil.hpp"
+#include "LogFile.hpp"
 
+#include <stdexcept>
 #include <vector>
 
+AirfieldDetails::AirfieldDetails(const Waypoint &wp)
+  :details(wp.details),
+#ifdef HAVE_RUN_FILE
+   files_external(wp.files_external.begin(), wp.files_external.end()),
+#endif
+   files_embed(wp.files_embed.begin(), wp.files_embed.end())
+{
+}
+
+void
+AirfieldDetails::Apply(const Waypoint &wp) const
+{
+  // TODO: eliminate this const_cast hack
+  Waypoint &new_wp = const_cast<Waypoint &>(wp);
+  new_wp.details = details.c_str();
+  new_wp.files_embed.assign(files_embed.begin(), files_embed.end());
+#ifdef HAVE_RUN_FILE
+  new_wp.files_external.assign(files_external.begin(),
+                               files_external.end());
+#endif
+}
+
 static WaypointPtr
 FindWaypoint(Waypoints &way_points, const TCHAR *name)
 {
@@ -57,87 +83,113 @@ FindWaypoint(Waypoints &way_points, const TCHAR *name)
   return nullptr;
 }
 
-static void
-SetAirfieldDetails(Waypoints &way_points, const TCHAR *name,
-                   const tstring &Details,
-                   const std::vector<tstring> &files_external,
-                   const std::vector<tstring> &files_embed)
+/**
+ * Normalise a name for the #WaypointDetails::Index, the way
+ * Waypoints::LookupName() does it: case and punctuation are ignored.
+ */
+static tstring
+NormalizeName(const TCHAR *name)
 {
-  auto wp = FindWaypoint(way_points, name);
-  if (wp == nullptr)
-    return;
-
-  // TODO: eliminate this const_cast hack
-  Waypoint &new_wp = const_cast<Waypoint &>(*wp);
-  new_wp.details = Details.c_str();
-  new_wp.files_embed.assign(files_embed.begin(), files_embed.end());
-#ifdef HAVE_RUN_FILE
-  new_wp.files_external.assign(files_external.begin(), files_external.end());
-#endif
+  TCHAR buffer[_tcslen(name) + 1];
+  return NormalizeSearchString(buffer, name);
 }
 
 /**
- * Parses the data provided by the airfield details file handle
+ * The reverse of FindWaypoint(): find the section of a waypoint.
  */
-static void
-ParseAirfieldDetails(Waypoints &way_points, TLineReader &reader,
-                     OperationEnvironment &operation)
+static WaypointDetails::Index::const_iterator
+FindSection(const WaypointDetails::Index &index, const tstring &name)
 {
-  tstring details;
-  std::vector<tstring> files_external, files_embed;
-  TCHAR name[201];
-  const TCHAR *filename;
+  auto i = index.find(NormalizeName(name.c_str()));
+  if (i != index.end())
+    return i;
 
-  name[0] = 0;
+  /* FindWaypoint() appends " AF" and " AD" to the section name */
+  if (name.length() > 3 &&
+      (StringEndsWithIgnoreCase(name.c_str(), _T(" AF")) ||
+       StringEndsWithIgnoreCase(name.c_str(), _T(" AD"))))
+    return index.find(NormalizeName(name.substr(0, name.length() - 3).c_str()));
 
-  bool in_details = false;
+  return index.end();
+}
+
+/**
+ * Extract the name from a section header line ("[name]").
+ */
+static void
+ParseSectionName(const TCHAR *line, TCHAR name[201])
+{
   int i;
+  for (i = 1; i < 201; i++) {
+    if (line[i] == _T(']'))
+      break;
 
-  const long filesize = std::max(reader.GetSize(), 1l);
-  operation.SetProgressRange(100);
+    name[i - 1] = line[i];
+  }
+  name[i - 1] = 0;
+}
 
+/**
+ * Parse the lines of one section.
+ *
+ * @return the header line of the next section, or nullptr at the end
+ * of the file
+ */
+static TCHAR *
+ParseSection(TLineReader &reader, AirfieldDetails &section)
+{
   TCHAR *line;
-  while ((line = reader.ReadLine()) != nullptr) {
-    if (line[0] == _T('[')) { // Look for start
-      if (in_details)
-        SetAirfieldDetails(way_points, name, details, files_external,
-                           files_embed);
-
-      details.clear();
-      files_external.clear();
-      files_embed.clear();
-
-      // extract name
-      for (i = 1; i < 201; i++) {
-        if (line[i] == _T(']'))
-          break;
-
-        name[i - 1] = line[i];
-      }
-      name[i - 1] = 0;
-
-      in_details = true;
-
-      operation.SetProgressPosition(reader.Tell() * 100 / filesize);
-    } else if ((filename =
-                StringAfterPrefixCI(line, _T("image="))) != nullptr) {
-      files_embed.emplace_back(filename);
+  const TCHAR *filename;
+  while ((line = reader.ReadLine()) != nullptr && line[0] != _T('[')) {
+    if ((filename = StringAfterPrefixCI(line, _T("image="))) != nullptr) {
+      section.files_embed.emplace_back(filename);
     } else if ((filename =
                 StringAfterPrefixCI(line, _T("file="))) != nullptr) {
 #ifdef HAVE_RUN_FILE
-      files_external.emplace_back(filename);
+      section.files_external.emplace_back(filename);
 #endif
     } else {
       // append text to details string
       if (!StringIsEmpty(line)) {
-        details += line;
-        details += _T('\n');
+        section.details += line;
+        section.details += _T('\n');
       }
     }
   }
 
-  if (in_details)
-    SetAirfieldDetails(way_points, name, details, files_external, files_embed);
+  return line;
+}
+
+/**
+ * Parses the data provided by the airfield details file handle
+ */
+static void
+ParseAirfieldDetails(Waypoints &way_points, TLineReader &reader,
+                     OperationEnvironment &operation)
+{
+  TCHAR name[201];
+
+  const long filesize = std::max(reader.GetSize(), 1l);
+  operation.SetProgressRange(100);
+
+  /* text before the first section is ignored */
+  TCHAR *line = reader.ReadLine();
+  while (line != nullptr) {
+    if (line[0] != _T('[')) {
+      line = reader.ReadLine();
+      continue;
+    }
+
+    ParseSectionName(line, name);
+    operation.SetProgressPosition(reader.Tell() * 100 / filesize);
+
+    AirfieldDetails section;
+    line = ParseSection(reader, section);
+
+    auto wp = FindWaypoint(way_points, name);
+    if (wp != nullptr)
+      section.Apply(*wp);
+  }
 }
 
 /**
@@ -151,13 +203,87 @@ WaypointDetails::ReadFile(TLineReader &reader, Waypoints &way_points,
   ParseAirfieldDetails(way_points, reader, operation);
 }
 
+void
+WaypointDetails::IndexFile(TLineReader &reader, Index &index,
+                           OperationEnvironment &operation)
+{
+  TCHAR name[201];
+
+  const long filesize = std::max(reader.GetSize(), 1l);
+  operation.SetProgressRange(100);
+
+  index.clear();
+
+  TCHAR *line;
+  for (unsigned i = 0; (line = reader.ReadLine()) != nullptr; ++i) {
+    if (line[0] == _T('[')) {
+      ParseSectionName(line, name);
+
+      /* the section begins after its header line; a later section
+         with the same name replaces it, like in ReadFile() */
+      index[NormalizeName(name)] = reader.Tell();
+    }
+
+    if ((i & 0xff) == 0)
+      operation.SetProgressPosition(reader.Tell() * 100 / filesize);
+  }
+}
+
+bool
+WaypointDetails::LoadIndexed(TLineReader &reader, const Index &index,
+                             const Waypoint &waypoint,
+                             AirfieldDetails &details)
+{
+  const auto i = FindSection(index, waypoint.name);
+  if (i == index.end() || !reader.Seek(i->second))
+    return false;
+
+  details = AirfieldDetails();
+  ParseSection(reader, details);
+  return true;
+}
+
+/**
+ * The index of the file configured in the profile, filled by
+ * ReadFileFromProfile() and used by LoadFromProfile().
+ */
+static WaypointDetails::Index profile_index;
+
+static std::unique_ptr<TLineReader>
+OpenProfileFile()
+{
+  return OpenConfiguredTextFile(ProfileKeys::AirfieldFile,
+                                "airfields.txt",
+                                Charset::AUTO);
+}
+
 void
 WaypointDetails::ReadFileFromProfile(Waypoints &way_points,
                                      OperationEnvironment &operation)
 {
-  auto reader = OpenConfiguredTextFile(ProfileKeys::AirfieldFile,
-                                       "airfields.txt",
-                                       Charset::AUTO);
-  if (reader)
+  profile_index.clear();
+
+  auto reader = OpenProfileFile();
+  if (!reader)
+    return;
+
+  if (reader->Seek(0)) {
+    operation.SetText(_("Loading Airfield Details File..."));
+    IndexFile(*reader, profile_index, operation);
+  } else
     ReadFile(*reader, way_points, operation);
 }
+
+bool
+WaypointDetails::LoadFromProfile(const Waypoint &waypoint,
+                                 AirfieldDetails &details)
+try {
+  if (profile_index.empty())
+    return false;
+
+  auto reader = OpenProfileFile();
+  return reader && LoadIndexed(*reader, profile_index, waypoint, details);
+} catch (const std::runtime_error &e) {
+  LogError(e);
+  return false;
+}
@@ -24,16 +24,86 @@ Copyright_License {
 #ifndef WAYPOINT_DETAILS_READER_HPP
 #define WAYPOINT_DETAILS_READER_HPP
 
+#include "Util/tstring.hpp"
+
+#include <map>
+#include <vector>
+
+struct Waypoint;
 class Waypoints;
 class OperationEnvironment;
 class TLineReader;
 
+/**
+ * The contents of one section of the airfield details file.
+ */
+struct AirfieldDetails {
+  tstring details;
+  std::vector<tstring> files_external, files_embed;
+
+  AirfieldDetails() = default;
+
+  /**
+   * Copy the details which are stored in the waypoint.
+   */
+  explicit AirfieldDetails(const Waypoint &wp);
+
+  /**
+   * Store the details in the waypoint.  This modifies the waypoint
+   * in the database, so it may only be done while loading.
+   */
+  void Apply(const Waypoint &wp) const;
+};
+
 namespace WaypointDetails
 {
+  /**
+   * Maps the section names of an airfield details file, normalised
+   * with NormalizeSearchString(), to the position of their first
+   * line.
+   */
+  typedef std::map<tstring, long> Index;
+
+  /**
+   * Read the whole file and attach the details to the waypoints.
+   */
   void ReadFile(TLineReader &reader, Waypoints &way_points,
                 OperationEnvironment &operation);
+
+  /**
+   * Scan the file and remember where each section begins, without
+   * loading the details.
+   */
+  void IndexFile(TLineReader &reader, Index &index,
+                 OperationEnvironment &operation);
+
+  /**
+   * Load the details of one waypoint from a file which was scanned
+   * by IndexFile().  The waypoint is not modified.
+   *
+   * @return false if the file has no details for this waypoint, or
+   * if the reader cannot seek
+   */
+  bool LoadIndexed(TLineReader &reader, const Index &index,
+                   const Waypoint &waypoint, AirfieldDetails &details);
+
+  /**
+   * Index the airfield details file configured in the profile.  The
+   * details are loaded by LoadFromProfile() when they are needed.
+   * If the file cannot seek, it is read completely instead.
+   */
   void ReadFileFromProfile(Waypoints &way_points,
                            OperationEnvironment &operation);
+
+  /**
+   * Load the details of the waypoint from the file indexed by
+   * ReadFileFromProfile().
+   *
+   * @return false if the file has no details for this waypoint, or
+   * if it was not indexed; the waypoint may then have details of its
+   * own
+   */
+  bool LoadFromProfile(const Waypoint &waypoint, AirfieldDetails &details);
 }
 
 #endif
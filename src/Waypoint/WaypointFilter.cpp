@@ -121,3 +121,14 @@ WaypointFilter::Matches(const Waypoint &waypoint, GeoPoint location,
          (distance <= 0 || CompareName(waypoint)) &&
          CompareDirection(waypoint, location);
 }
+
+bool
+WaypointFilter::IsSubsetOf(const WaypointFilter &other) const
+{
+  return distance == other.distance &&
+         direction == other.direction &&
+         type_index == other.type_index &&
+         IsTextSearch() == other.IsTextSearch() &&
+         name.length() >= other.name.length() &&
+         StringIsEqualIgnoreCase(name, other.name, other.name.length());
+}
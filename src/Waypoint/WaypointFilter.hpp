@@ -54,6 +54,12 @@ struct WaypointFilter
 {
   static constexpr size_t NAME_LENGTH = 10;
 
+  /**
+   * From this length on, the name is also searched in the middle of
+   * waypoint names and in comments (see Waypoints::VisitText()).
+   */
+  static constexpr size_t TEXT_SEARCH_LENGTH = 3;
+
   StaticString<NAME_LENGTH + 1> name;
 
   double distance;
@@ -67,10 +73,23 @@ struct WaypointFilter
     type_index = TypeFilter::ALL;
   }
 
+  bool IsTextSearch() const {
+    return distance <= 0 && name.length() >= TEXT_SEARCH_LENGTH;
+  }
+
   gcc_pure
   bool Matches(const Waypoint &waypoint, GeoPoint location,
                const FAITrianglePointValidator &triangle_validator) const;
 
+  /**
+   * Does this filter match a subset of the waypoints matched by the
+   * other one?  This detects only the common case of a longer name
+   * prefix with all other criteria unchanged, as long as this does
+   * not enable the text search.
+   */
+  gcc_pure
+  bool IsSubsetOf(const WaypointFilter &other) const;
+
 private:
   static bool CompareType(const Waypoint &waypoint, TypeFilter type,
                           const FAITrianglePointValidator &triangle_validator);
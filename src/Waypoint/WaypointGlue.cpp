@@ -27,11 +27,16 @@ Copyright_License {
 #include "Profile/Profile.hpp"
 #include "LogFile.hpp"
 #include "Waypoint/Waypoints.hpp"
+#include "Terrain/RasterTerrain.hpp"
 #include "WaypointReader.hpp"
+#include "WaypointCache.hpp"
+#include "WaypointJournal.hpp"
 #include "Language/Language.hpp"
 #include "LocalPath.hpp"
 #include "Operation/Operation.hpp"
 #include "OS/Path.hpp"
+#include "OS/FileUtil.hpp"
+#include "IO/FileLineReader.hpp"
 #include "IO/MapFile.hpp"
 #include "IO/ZipArchive.hpp"
 
@@ -51,11 +56,53 @@ LoadWaypointFile(Waypoints &waypoints, Path path,
   return true;
 }
 
+/**
+ * Returns the name of the cache file for waypoint files of the given
+ * origin, or nullptr if they are not cached.
+ */
+gcc_const
+static const TCHAR *
+GetCacheName(WaypointOrigin origin)
+{
+  switch (origin) {
+  case WaypointOrigin::PRIMARY:
+    return _T("waypoints-primary");
+
+  case WaypointOrigin::ADDITIONAL:
+    return _T("waypoints-additional");
+
+  case WaypointOrigin::WATCHED:
+    return _T("waypoints-watched");
+
+  case WaypointOrigin::NONE:
+  case WaypointOrigin::USER:
+  case WaypointOrigin::MAP:
+    break;
+  }
+
+  return nullptr;
+}
+
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointOrigin origin,
-                 const RasterTerrain *terrain, OperationEnvironment &operation)
+                 const RasterTerrain *terrain, FileCache *cache,
+                 OperationEnvironment &operation)
 {
+  const TCHAR *cache_name = cache != nullptr
+    ? GetCacheName(origin)
+    : nullptr;
+
+  /* the cache contains elevations looked up in the terrain */
+  const Path terrain_path = terrain != nullptr
+    ? terrain->GetPath()
+    : Path(nullptr);
+
+  if (cache_name != nullptr &&
+      LoadWaypointCache(*cache, cache_name, path, terrain_path,
+                        origin, waypoints))
+    return true;
+
   if (!ReadWaypointFile(path, waypoints,
                         WaypointFactory(origin, terrain),
                         operation)) {
@@ -63,9 +110,38 @@ LoadWaypointFile(Waypoints &waypoints, Path path,
     return false;
   }
 
+  if (cache_name != nullptr)
+    SaveWaypointCache(*cache, cache_name, path, terrain_path,
+                      origin, waypoints);
+
   return true;
 }
 
+/**
+ * Apply the changes recorded in "user.journal" to the user waypoints,
+ * and merge them into "user.cup".  This compacts the journal each
+ * time the waypoints are loaded.
+ */
+static void
+LoadWaypointJournal(Waypoints &waypoints, const RasterTerrain *terrain)
+{
+  const auto path = LocalPath(_T("user.journal"));
+  if (!File::Exists(path))
+    return;
+
+  try {
+    FileLineReader reader(path);
+    const unsigned n =
+      ReplayWaypointJournal(waypoints, reader,
+                            WaypointFactory(WaypointOrigin::USER, terrain));
+    LogFormat("Replayed %u waypoint journal records", n);
+
+    WaypointGlue::SaveWaypoints(waypoints);
+  } catch (const std::runtime_error &e) {
+    LogError("Failed to merge the waypoint journal", e);
+  }
+}
+
 static bool
 LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
                  WaypointFileType file_type,
@@ -85,6 +161,7 @@ LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
 bool
 WaypointGlue::LoadWaypoints(Waypoints &way_points,
                             const RasterTerrain *terrain,
+                            FileCache *cache,
                             OperationEnvironment &operation)
 {
   LogFormat("ReadWaypoints");
@@ -98,24 +175,25 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
   LoadWaypointFile(way_points, LocalPath(_T("user.cup")),
                    WaypointFileType::SEEYOU,
                    WaypointOrigin::USER, terrain, operation);
+  LoadWaypointJournal(way_points, terrain);
 
   // ### FIRST FILE ###
   auto path = Profile::GetPath(ProfileKeys::WaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::PRIMARY,
-                              terrain, operation);
+                              terrain, cache, operation);
 
   // ### SECOND FILE ###
   path = Profile::GetPath(ProfileKeys::AdditionalWaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::ADDITIONAL,
-                              terrain, operation);
+                              terrain, cache, operation);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   path = Profile::GetPath(ProfileKeys::WatchedWaypointFile);
   if (!path.IsNull())
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::WATCHED,
-                              terrain, operation);
+                              terrain, cache, operation);
 
   // ### MAP/FOURTH FILE ###
 
@@ -28,6 +28,7 @@ Copyright_License {
 
 class Waypoints;
 class RasterTerrain;
+class FileCache;
 class OperationEnvironment;
 struct PlacesOfInterestSettings;
 struct TeamCodeSettings;
@@ -101,24 +102,38 @@ namespace WaypointGlue {
    * specified waypoint list
    * @param way_points The waypoint list to fill
    * @param terrain RasterTerrain (for automatic waypoint height)
+   * @param cache an optional #FileCache which stores the parsed
+   * waypoint files
    */
   bool LoadWaypoints(Waypoints &way_points,
                      const RasterTerrain *terrain,
+                     FileCache *cache,
                      OperationEnvironment &operation);
 
   /**
-   * Append one waypoint to the file "user.cup".
+   * Write all user waypoints to the file "user.cup", and delete the
+   * journal "user.journal", which is merged into it now.
    *
    * Throws std::runtime_error on error;
    */
   void SaveWaypoints(const Waypoints &way_points);
 
   /**
-   * Append one waypoint to the file "user.cup".
+   * Record a new user waypoint in the journal "user.journal", without
+   * rewriting "user.cup".  The journal is merged into "user.cup" by
+   * the next LoadWaypoints() call.
    *
    * Throws std::runtime_error on error;
    */
   void SaveWaypoint(const Waypoint &wp);
+
+  /**
+   * Record in the journal "user.journal" that a waypoint has been
+   * replaced by the user waypoint #new_wp.
+   *
+   * Throws std::runtime_error on error;
+   */
+  void SaveReplacedWaypoint(const Waypoint &old_wp, const Waypoint &new_wp);
 };
 
 #endif
@@ -0,0 +1,144 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "WaypointJournal.hpp"
+#include "CupWriter.hpp"
+#include "WaypointReaderSeeYou.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "IO/BufferedOutputStream.hxx"
+#include "IO/LineReader.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Two waypoints with the same name closer than this [m] are
+ * considered the same.  WriteCup() rounds the location to 1/1000
+ * minute, i.e. less than 2 m.
+ */
+static constexpr double SAME_DISTANCE = 10;
+
+void
+WriteJournalRecord(BufferedOutputStream &writer, WaypointJournalRecord record,
+                   const Waypoint &wp)
+{
+  writer.Write(char(record));
+  WriteCup(writer, wp);
+}
+
+gcc_pure
+static bool
+IsSame(const Waypoint &a, const Waypoint &b)
+{
+  return a.origin == b.origin && a.name == b.name &&
+    a.location.DistanceS(b.location) < SAME_DISTANCE;
+}
+
+/**
+ * Finds a waypoint which is the same as the specified one (see
+ * IsSame()) and which is not in the "ignore" list.
+ */
+class FindSameVisitor final : public WaypointVisitor {
+  const Waypoint &wp;
+  const std::vector<WaypointPtr> &ignore;
+
+public:
+  WaypointPtr found;
+
+  FindSameVisitor(const Waypoint &_wp, const std::vector<WaypointPtr> &_ignore)
+    :wp(_wp), ignore(_ignore) {}
+
+  void Visit(const WaypointPtr &i) override {
+    if (found == nullptr && IsSame(*i, wp) &&
+        std::find(ignore.begin(), ignore.end(), i) == ignore.end())
+      found = i;
+  }
+};
+
+/**
+ * Look up the waypoint through the name index; this does not need an
+ * optimised tree.
+ */
+gcc_pure
+static WaypointPtr
+FindSame(const Waypoints &waypoints, const Waypoint &wp,
+         const std::vector<WaypointPtr> &ignore)
+{
+  FindSameVisitor visitor(wp, ignore);
+  waypoints.VisitNamePrefix(wp.name.c_str(), visitor);
+  return visitor.found;
+}
+
+gcc_pure
+static std::vector<Waypoint>::iterator
+FindSame(std::vector<Waypoint> &list, const Waypoint &wp)
+{
+  return std::find_if(list.begin(), list.end(), [&wp](const Waypoint &i){
+      return IsSame(i, wp);
+    });
+}
+
+unsigned
+ReplayWaypointJournal(Waypoints &waypoints, TLineReader &reader,
+                      WaypointFactory factory)
+{
+  const WaypointReaderSeeYou parser(factory);
+
+  /* collect the net changes first, and apply them in one pass at the
+     end */
+  std::vector<WaypointPtr> removed;
+  std::vector<Waypoint> added;
+
+  unsigned n = 0;
+  TCHAR *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    const auto record = WaypointJournalRecord(line[0]);
+    if (record != WaypointJournalRecord::ADD &&
+        record != WaypointJournalRecord::REMOVE)
+      continue;
+
+    Waypoint wp;
+    if (!parser.ParseCupLine(line + 1, wp))
+      continue;
+
+    const auto i = FindSame(added, wp);
+    if (record == WaypointJournalRecord::ADD) {
+      if (i == added.end() && FindSame(waypoints, wp, removed) == nullptr)
+        added.emplace_back(std::move(wp));
+    } else if (i != added.end()) {
+      added.erase(i);
+    } else {
+      auto existing = FindSame(waypoints, wp, removed);
+      if (existing != nullptr)
+        removed.emplace_back(std::move(existing));
+    }
+
+    ++n;
+  }
+
+  waypoints.Erase(removed);
+  waypoints.Append(std::move(added));
+
+  return n;
+}
@@ -0,0 +1,66 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_WAYPOINT_JOURNAL_HPP
+#define XCSOAR_WAYPOINT_JOURNAL_HPP
+
+struct Waypoint;
+class Waypoints;
+class WaypointFactory;
+class BufferedOutputStream;
+class TLineReader;
+
+/**
+ * The waypoint journal is an append-only log of changes to the user
+ * waypoints, which saves rewriting "user.cup" for each of them.
+ * Each line is one record: the #WaypointJournalRecord character
+ * followed by the waypoint in the format written by WriteCup().
+ * Replacing a waypoint is a removal followed by an addition.
+ */
+enum class WaypointJournalRecord : char {
+  ADD = '+',
+  REMOVE = '-',
+};
+
+void
+WriteJournalRecord(BufferedOutputStream &writer, WaypointJournalRecord record,
+                   const Waypoint &wp);
+
+/**
+ * Apply the journal records to the waypoints of the factory's origin.
+ * Waypoints are identified by name and location.
+ *
+ * Replaying is idempotent: removing a waypoint which doesn't exist
+ * and adding one which exists already are no-ops.  This allows
+ * replaying a journal again after the file it belongs to has been
+ * rewritten, but the journal has not been deleted yet.  Damaged
+ * records (e.g. a partial last line) are skipped.
+ *
+ * Waypoints::Optimise() must be called afterwards.
+ *
+ * @return the number of records which were applied
+ */
+unsigned
+ReplayWaypointJournal(Waypoints &waypoints, TLineReader &reader,
+                      WaypointFactory factory);
+
+#endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "WaypointList.hpp"
 #include "Waypoint/Waypoint.hpp"
+#include "Util/StringAPI.hxx"
 
 #include <algorithm>
 
@@ -30,6 +31,7 @@ void
 WaypointListItem::ResetVector()
 {
   vec.SetInvalid();
+  sort_distance = -1;
 }
 
 const GeoVector &
@@ -41,6 +43,15 @@ WaypointListItem::GetVector(const GeoPoint &location) const
   return vec;
 }
 
+double
+WaypointListItem::GetSortDistance(const GeoPoint &location) const
+{
+  if (sort_distance < 0)
+    sort_distance = location.DistanceS(waypoint->location);
+
+  return sort_distance;
+}
+
 class WaypointDistanceCompare
 {
   const GeoPoint &location;
@@ -50,10 +61,53 @@ public:
 
   bool operator()(const WaypointListItem &a,
                   const WaypointListItem &b) const {
-    return a.GetVector(location).distance < b.GetVector(location).distance;
+    return a.GetSortDistance(location) < b.GetSortDistance(location);
   }
 };
 
 void WaypointList::SortByDistance(const GeoPoint &location) {
   std::sort(begin(), end(), WaypointDistanceCompare(location));
+  sort_location.SetInvalid();
+  n_sorted = 0;
+}
+
+void
+WaypointList::PartialSortByDistance(const GeoPoint &location, size_type n)
+{
+  sort_location = location;
+  n_sorted = 0;
+  SortUpTo(n);
+}
+
+void
+WaypointList::SortUpTo(size_type n)
+{
+  if (!sort_location.IsValid() || n <= n_sorted)
+    return;
+
+  n = std::min(std::max(n, n_sorted + n_sorted / 2), size());
+
+  /* all items behind n_sorted are at least as far away as the ones
+     before, so sorting the rest of the list continues the order */
+  std::partial_sort(begin() + n_sorted, begin() + n, end(),
+                    WaypointDistanceCompare(sort_location));
+  n_sorted = n;
+
+  if (n_sorted == size())
+    /* completely sorted */
+    sort_location.SetInvalid();
+}
+
+static bool
+CompareName(const WaypointListItem &a, const WaypointListItem &b)
+{
+  return StringCompare(a.waypoint->name.c_str(), b.waypoint->name.c_str()) < 0;
+}
+
+void
+WaypointList::SortByName()
+{
+  std::sort(begin(), end(), CompareName);
+  sort_location.SetInvalid();
+  n_sorted = 0;
 }
@@ -25,7 +25,9 @@ Copyright_License {
 #define XCSOAR_WAYPOINT_LIST_HPP
 
 #include "Geo/GeoVector.hpp"
+#include "Geo/GeoPoint.hpp"
 #include "Engine/Waypoint/Ptr.hpp"
+#include "Compiler.h"
 
 #include <vector>
 
@@ -40,6 +42,12 @@ private:
   /** From observer to waypoint */
   mutable GeoVector vec = GeoVector::Invalid();
 
+  /**
+   * Distance from observer to waypoint calculated with the faster
+   * spherical formula, used for sorting.  Negative if not yet known.
+   */
+  mutable double sort_distance = -1;
+
 public:
   template<typename W>
   explicit WaypointListItem(W &&_waypoint):
@@ -47,12 +55,69 @@ public:
 
   void ResetVector();
   const GeoVector &GetVector(const GeoPoint &location) const;
+
+  gcc_pure
+  double GetSortDistance(const GeoPoint &location) const;
 };
 
 class WaypointList: public std::vector<WaypointListItem>
 {
+  /**
+   * If valid, the list is being sorted by the distance from this
+   * location, but only the first #n_sorted items are known to be at
+   * their final position.  The others are not closer than these.
+   */
+  GeoPoint sort_location = GeoPoint::Invalid();
+  size_type n_sorted = 0;
+
 public:
+  void clear() {
+    std::vector<WaypointListItem>::clear();
+    sort_location.SetInvalid();
+    n_sorted = 0;
+  }
+
   void SortByDistance(const GeoPoint &location);
+
+  /**
+   * Sort only the closest #n items by distance.  The rest of the list
+   * is sorted on demand by SortUpTo(), e.g. when it is scrolled into
+   * view.  Items must not be added until clear() is called.
+   */
+  void PartialSortByDistance(const GeoPoint &location, size_type n);
+
+  /**
+   * Ensure that the first #n items of a list passed to
+   * PartialSortByDistance() are sorted.  The sorted part grows at
+   * least by half, so walking through the whole list costs about as
+   * much as sorting it at once.
+   */
+  void SortUpTo(size_type n);
+
+  void SortByName();
+
+  /**
+   * Remove all items matching the predicate, keeping the order and
+   * the sorted part of the others.
+   */
+  template<typename P>
+  void EraseIf(const P &predicate) {
+    size_type n_kept = 0, n_sorted_kept = 0;
+    for (size_type i = 0, n = size(); i < n; ++i) {
+      if (predicate((*this)[i]))
+        continue;
+
+      if (i < n_sorted)
+        ++n_sorted_kept;
+
+      if (i != n_kept)
+        (*this)[n_kept] = std::move((*this)[i]);
+      ++n_kept;
+    }
+
+    erase(begin() + n_kept, end());
+    n_sorted = n_sorted_kept;
+  }
 };
 
 #endif
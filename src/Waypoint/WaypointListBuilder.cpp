@@ -25,12 +25,137 @@ Copyright_License {
 #include "WaypointList.hpp"
 #include "WaypointFilter.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Util/StringUtil.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringAPI.hxx"
+
+#include <limits>
+
+/**
+ * Returns the area which contains all candidates of a FAI triangle
+ * filter, or an invalid GeoBounds if the filter type is different or
+ * not restricted to an area.
+ */
+gcc_pure
+static GeoBounds
+GetFAITriangleBounds(const WaypointFilter &filter,
+                     const FAITrianglePointValidator &triangle_validator)
+{
+  switch (filter.type_index) {
+  case TypeFilter::FAI_TRIANGLE_LEFT:
+    return triangle_validator.GetSearchBounds(false);
+
+  case TypeFilter::FAI_TRIANGLE_RIGHT:
+    return triangle_validator.GetSearchBounds(true);
+
+  default:
+    return GeoBounds::Invalid();
+  }
+}
+
+/**
+ * Does the normalised name of the waypoint start with the normalised
+ * prefix?
+ */
+gcc_pure
+static bool
+HasNormalisedPrefix(const Waypoint &waypoint, const TCHAR *prefix)
+{
+  const tstring &name = waypoint.name;
+  TCHAR normalized[name.length() + 1];
+  NormalizeSearchString(normalized, name.c_str());
+  return StringStartsWith(normalized, prefix);
+}
+
+/**
+ * Does the normalised string contain the normalised text?
+ */
+gcc_pure
+static bool
+ContainsNormalised(const TCHAR *s, const TCHAR *text)
+{
+  TCHAR normalized[_tcslen(s) + 1];
+  NormalizeSearchString(normalized, s);
+  return StringFind(normalized, text) != nullptr;
+}
+
+/**
+ * Passes the results of Waypoints::VisitText() on, except for the
+ * waypoints whose name starts with the text: these have been visited
+ * by Waypoints::VisitNamePrefix() already.
+ */
+class TextSearchVisitor final : public WaypointVisitor {
+  WaypointVisitor &next;
+  const TCHAR *const prefix;
+
+public:
+  TextSearchVisitor(WaypointVisitor &_next, const TCHAR *_prefix)
+    :next(_next), prefix(_prefix) {}
+
+  void Visit(const WaypointPtr &waypoint) override {
+    if (!HasNormalisedPrefix(*waypoint, prefix))
+      next.Visit(waypoint);
+  }
+};
 
 void WaypointListBuilder::Visit(const Waypoints &waypoints) {
-  if (filter.distance > 0)
+  if (filter.distance > 0) {
     waypoints.VisitWithinRange(location, filter.distance, *this);
-  else
-    waypoints.VisitNamePrefix(filter.name, *this);
+    return;
+  }
+
+  if (filter.name.empty()) {
+    /* only look up the waypoints which may form a FAI triangle with
+       the task, instead of testing each one */
+    const GeoBounds bounds = GetFAITriangleBounds(filter, triangle_validator);
+    if (bounds.IsValid()) {
+      waypoints.VisitWithinBounds(bounds, *this);
+
+      /* same order as VisitNamePrefix() */
+      list.SortByName();
+      return;
+    }
+  }
+
+  waypoints.VisitNamePrefix(filter.name, *this);
+
+  if (filter.IsTextSearch()) {
+    /* then the waypoints which contain the name elsewhere, best
+       matches first */
+    TCHAR prefix[filter.name.length() + 1];
+    NormalizeSearchString(prefix, filter.name);
+
+    TextSearchVisitor visitor(*this, prefix);
+    waypoints.VisitText(filter.name, 0, std::numeric_limits<unsigned>::max(),
+                        visitor);
+  }
+}
+
+void
+WaypointListBuilder::Narrow(WaypointList &list) const
+{
+  if (filter.distance > 0) {
+    /* Visit() has compared the name in WaypointFilter::Matches() */
+    list.EraseIf([this](const WaypointListItem &item){
+        return !filter.Matches(*item.waypoint, location, triangle_validator);
+      });
+    return;
+  }
+
+  /* Visit() has looked up the normalised name prefix, and maybe the
+     text */
+  TCHAR prefix[filter.name.length() + 1];
+  NormalizeSearchString(prefix, filter.name);
+
+  const bool text_search = filter.IsTextSearch();
+  list.EraseIf([&prefix, text_search](const WaypointListItem &item){
+      const Waypoint &waypoint = *item.waypoint;
+      return !HasNormalisedPrefix(waypoint, prefix) &&
+        (!text_search ||
+         (!ContainsNormalised(waypoint.name.c_str(), prefix) &&
+          !ContainsNormalised(waypoint.comment.c_str(), prefix)));
+    });
 }
 
 void
@@ -47,6 +47,14 @@ public:
 
   void Visit(const Waypoints &waypoints);
 
+  /**
+   * Remove the items which do not match the filter from a list built
+   * by Visit() with a broader filter (see
+   * WaypointFilter::IsSubsetOf()), instead of visiting all waypoints
+   * again.  The order of the remaining items is preserved.
+   */
+  void Narrow(WaypointList &list) const;
+
   /* virtual methods from class WaypointVisitor */
   void Visit(const WaypointPtr &waypoint) override;
 };
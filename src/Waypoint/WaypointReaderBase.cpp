@@ -22,12 +22,87 @@ Copyright_License {
 */
 
 #include "WaypointReaderBase.hpp"
+#include "Waypoint/Waypoints.hpp"
 #include "Operation/Operation.hpp"
 #include "IO/LineReader.hpp"
+#include "Thread/Thread.hpp"
+
+#include <memory>
+#include <vector>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+/**
+ * Each thread gets at least this many lines; smaller files are
+ * parsed on fewer threads.
+ */
+static constexpr size_t MIN_CHUNK_LINES = 2048;
+
+static constexpr unsigned MAX_THREADS = 8;
+
+static unsigned
+CountProcessors()
+{
+#ifdef HAVE_POSIX
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? unsigned(n) : 1;
+#else
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#endif
+}
+
+/**
+ * Parses a range of lines with ParseWaypoint(), either on its own
+ * thread or inline.
+ */
+class WaypointReaderBase::ChunkParser final : public Thread {
+  const WaypointReaderBase *reader;
+  const TCHAR *text;
+  const size_t *begin, *end;
+
+public:
+  std::vector<Waypoint> waypoints;
+
+  ChunkParser():Thread("WaypointParser") {}
+
+  void Set(const WaypointReaderBase &_reader, const TCHAR *_text,
+           const size_t *_begin, const size_t *_end) {
+    reader = &_reader;
+    text = _text;
+    begin = _begin;
+    end = _end;
+  }
+
+  void Run() override {
+    waypoints.reserve(end - begin);
+
+    for (const size_t *i = begin; i != end; ++i) {
+      waypoints.emplace_back();
+      if (!reader->ParseWaypoint(text + *i, waypoints.back()))
+        waypoints.pop_back();
+    }
+  }
+};
 
 void
 WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
                           OperationEnvironment &operation)
+{
+  if (CanParseParallel())
+    ParseParallel(way_points, reader, operation);
+  else
+    ParseSerial(way_points, reader, operation);
+}
+
+void
+WaypointReaderBase::ParseSerial(Waypoints &way_points, TLineReader &reader,
+                                OperationEnvironment &operation)
 {
   const long filesize = std::max(reader.GetSize(), 1l);
   operation.SetProgressRange(100);
@@ -42,3 +117,67 @@ WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
       operation.SetProgressPosition(reader.Tell() * 100 / filesize);
   }
 }
+
+void
+WaypointReaderBase::ParseParallel(Waypoints &way_points, TLineReader &reader,
+                                  OperationEnvironment &operation)
+{
+  const long filesize = std::max(reader.GetSize(), 1l);
+  operation.SetProgressRange(100);
+
+  /* read the whole file into one buffer, keeping only the lines
+     which may contain waypoints; the header is evaluated here, in
+     file order */
+  std::vector<TCHAR> text;
+  std::vector<size_t> lines;
+  if (filesize > 1)
+    text.reserve(filesize);
+
+  TCHAR *line;
+  for (unsigned i = 0; (line = reader.ReadLine()) != nullptr; i++) {
+    if (PrepareLine(line)) {
+      lines.push_back(text.size());
+      text.insert(text.end(), line, line + _tcslen(line) + 1);
+    }
+
+    if ((i & 0x3f) == 0)
+      operation.SetProgressPosition(reader.Tell() * 50 / filesize);
+  }
+
+  if (lines.empty())
+    return;
+
+  /* split the lines into one contiguous chunk per thread */
+  const unsigned n_chunks =
+    std::max(std::min({CountProcessors(), MAX_THREADS,
+                       unsigned(lines.size() / MIN_CHUNK_LINES)}),
+             1u);
+  std::unique_ptr<ChunkParser[]> chunks(new ChunkParser[n_chunks]);
+
+  for (unsigned i = 0; i < n_chunks; ++i)
+    chunks[i].Set(*this, text.data(),
+                  lines.data() + lines.size() * i / n_chunks,
+                  lines.data() + lines.size() * (i + 1) / n_chunks);
+
+  /* the first chunk is parsed by this thread; if a thread cannot be
+     started, its chunk is parsed here, too */
+  bool started[MAX_THREADS];
+  for (unsigned i = 1; i < n_chunks; ++i)
+    started[i] = chunks[i].Start();
+
+  chunks[0].Run();
+
+  for (unsigned i = 1; i < n_chunks; ++i) {
+    if (started[i])
+      chunks[i].Join();
+    else
+      chunks[i].Run();
+  }
+
+  /* append in file order, so the waypoint ids are the same as with
+     ParseSerial() */
+  for (unsigned i = 0; i < n_chunks; ++i) {
+    way_points.Append(std::move(chunks[i].waypoints));
+    operation.SetProgressPosition(50 + 50 * (i + 1) / n_chunks);
+  }
+}
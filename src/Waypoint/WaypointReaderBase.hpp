@@ -29,12 +29,15 @@ Copyright_License {
 
 #include <tchar.h>
 
+struct Waypoint;
 class Waypoints;
 class TLineReader;
 class OperationEnvironment;
 
 class WaypointReaderBase 
 {
+  class ChunkParser;
+
 protected:
   const WaypointFactory factory;
 
@@ -63,6 +66,43 @@ protected:
    * parsing error occured
    */
   virtual bool ParseLine(const TCHAR* line, Waypoints &way_points) = 0;
+
+  /**
+   * Does this reader implement PrepareLine() and ParseWaypoint()?
+   * If yes, Parse() reads the whole file first and then parses the
+   * waypoints on several threads.
+   */
+  virtual bool CanParseParallel() const {
+    return false;
+  }
+
+  /**
+   * Inspect a line in file order and update the reader's state (file
+   * header, end markers) the way ParseLine() would.  This is called
+   * on the caller's thread only.
+   *
+   * @return true if the line shall be passed to ParseWaypoint()
+   */
+  virtual bool PrepareLine(const TCHAR *line) {
+    return false;
+  }
+
+  /**
+   * Parse a line accepted by PrepareLine().  This must not modify
+   * the reader, because it is called on several threads at a time.
+   *
+   * @return true if a waypoint was parsed
+   */
+  virtual bool ParseWaypoint(const TCHAR *line, Waypoint &dest) const {
+    return false;
+  }
+
+private:
+  void ParseSerial(Waypoints &way_points, TLineReader &reader,
+                   OperationEnvironment &operation);
+
+  void ParseParallel(Waypoints &way_points, TLineReader &reader,
+                     OperationEnvironment &operation);
 };
 
 #endif
@@ -192,8 +192,11 @@ WaypointReaderFS::ParseLine(const TCHAR *line, Waypoints &way_points)
     return false;
 
   // Description (Characters 35-44)
-  if (len > (is_utm ? 38 : 47))
-    ParseString(line + (is_utm ? 38 : 47), new_waypoint.comment);
+  if (len > (is_utm ? 38 : 47)) {
+    tstring comment;
+    ParseString(line + (is_utm ? 38 : 47), comment);
+    new_waypoint.comment = std::move(comment);
+  }
 
   way_points.Append(std::move(new_waypoint));
   return true;
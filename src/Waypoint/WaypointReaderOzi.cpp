@@ -119,7 +119,9 @@ WaypointReaderOzi::ParseLine(const TCHAR *line, Waypoints &way_points)
     return false;
 
   // Description
-  ParseString(params[10], new_waypoint.comment);
+  tstring comment;
+  ParseString(params[10], comment);
+  new_waypoint.comment = std::move(comment);
 
   way_points.Append(std::move(new_waypoint));
   return true;
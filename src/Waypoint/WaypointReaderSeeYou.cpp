@@ -160,23 +160,13 @@ ParseStyle(const TCHAR* src, Waypoint::Type &type)
 }
 
 bool
-WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
+WaypointReaderSeeYou::PrepareLine(const TCHAR *line)
 {
-  enum {
-    iName = 0,
-    iLatitude = 3,
-    iLongitude = 4,
-    iElevation = 5,
-    iStyle = 6,
-    iRWDir = 7,
-    iRWLen = 8,
-  };
-
   // If (end-of-file or comment)
   if (StringIsEmpty(line) ||
       StringStartsWith(line, _T("*")))
-    // -> return without error condition
-    return true;
+    // -> nothing to parse
+    return false;
 
   TCHAR ctemp[4096];
   if (_tcslen(line) >= ARRAY_SIZE(ctemp))
@@ -187,12 +177,7 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
   if (StringStartsWith(line, _T("-----Related Tasks-----")))
     ignore_following = true;
   if (ignore_following)
-    return true;
-
-  // Get fields
-  const TCHAR *params[20];
-  size_t n_params = ExtractParameters(line, ctemp, params,
-                                      ARRAY_SIZE(params), true, _T('"'));
+    return false;
 
   if (first) {
     first = false;
@@ -201,6 +186,10 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
        * If the first line doesn't begin with a quotation mark, it
        * doesn't describe a waypoint. It probably contains field names.
        */
+      const TCHAR *params[20];
+      ExtractParameters(line, ctemp, params, ARRAY_SIZE(params), true,
+                        _T('"'));
+
       if (StringIsEqual(params[9], _T("rwwidth"))) {
         /*
          * The name of the 10th field is "rwwidth" (runway width).
@@ -212,10 +201,37 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
         iFrequency = 10;
         iDescription = 11;
       }
-      return true;
+      return false;
     }
   }
 
+  return true;
+}
+
+bool
+WaypointReaderSeeYou::ParseWaypoint(const TCHAR *line,
+                                    Waypoint &new_waypoint) const
+{
+  enum {
+    iName = 0,
+    iLatitude = 3,
+    iLongitude = 4,
+    iElevation = 5,
+    iStyle = 6,
+    iRWDir = 7,
+    iRWLen = 8,
+  };
+
+  TCHAR ctemp[4096];
+  if (_tcslen(line) >= ARRAY_SIZE(ctemp))
+    /* line too long for buffer */
+    return false;
+
+  // Get fields
+  const TCHAR *params[20];
+  size_t n_params = ExtractParameters(line, ctemp, params,
+                                      ARRAY_SIZE(params), true, _T('"'));
+
   // Check if the basic fields are provided
   if (iName >= n_params ||
       iLatitude >= n_params ||
@@ -234,7 +250,7 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
 
   location.Normalize(); // ensure longitude is within -180:180
 
-  Waypoint new_waypoint = factory.Create(location);
+  new_waypoint = factory.Create(location);
 
   // Name (e.g. "Some Turnpoint")
   if (*params[iName] == _T('\0'))
@@ -291,6 +307,19 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
     new_waypoint.comment = params[iDescription];
   }
 
+  return true;
+}
+
+bool
+WaypointReaderSeeYou::ParseLine(const TCHAR* line, Waypoints &waypoints)
+{
+  if (!PrepareLine(line))
+    return true;
+
+  Waypoint new_waypoint;
+  if (!ParseWaypoint(line, new_waypoint))
+    return false;
+
   waypoints.Append(std::move(new_waypoint));
   return true;
 }
@@ -46,9 +46,24 @@ public:
   explicit WaypointReaderSeeYou(WaypointFactory _factory)
     :WaypointReaderBase(_factory) {}
 
+  /**
+   * Parse one waypoint line with the default field layout, as
+   * written by WriteCup().
+   */
+  bool ParseCupLine(const TCHAR *line, Waypoint &dest) const {
+    return ParseWaypoint(line, dest);
+  }
+
 protected:
   /* virtual methods from class WaypointReaderBase */
   bool ParseLine(const TCHAR* line, Waypoints &way_points) override;
+
+  bool CanParseParallel() const override {
+    return true;
+  }
+
+  bool PrepareLine(const TCHAR *line) override;
+  bool ParseWaypoint(const TCHAR *line, Waypoint &dest) const override;
 };
 
 #endif
@@ -185,8 +185,11 @@ WaypointReaderZander::ParseLine(const TCHAR* line, Waypoints &way_points)
     return false;
 
   // Description (Characters 35-44)
-  if (len > 35)
-    ParseString(line + 35, new_waypoint.comment, 9);
+  if (len > 35) {
+    tstring comment;
+    ParseString(line + 35, comment, 9);
+    new_waypoint.comment = std::move(comment);
+  }
 
   // Flags (Characters 45-49)
   if (len < 46 || !ParseFlags(line + 45, new_waypoint))
@@ -0,0 +1,225 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Compares the number of candidates and the query time of the 2D
+ * airspace queries with their altitude-filtered variants.
+ */
+
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Engine/Airspace/Predicate/AirspacePredicateHeightRange.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned NUM_AIRSPACES = 20000;
+static constexpr unsigned NUM_QUERIES = 2000;
+
+static const GeoPoint center(Angle::Degrees(7.7061111111111114),
+                             Angle::Degrees(51.051944444444445));
+
+static GeoPoint
+RandomLocation()
+{
+  return GeoPoint(center.longitude + Angle::Degrees((rand() % 4000 - 2000) / 1000.),
+                  center.latitude + Angle::Degrees((rand() % 4000 - 2000) / 1000.));
+}
+
+/**
+ * Generate a layered airspace structure similar to dense European
+ * airspace: many thin slices stacked on top of each other, some of
+ * them referenced to flight levels.
+ */
+static void
+SetupAirspaces(Airspaces &airspaces)
+{
+  for (unsigned i = 0; i < NUM_AIRSPACES; ++i) {
+    const GeoPoint c = RandomLocation();
+
+    AbstractAirspace *as;
+    if (rand() % 3 != 0) {
+      as = new AirspaceCircle(c, 3000 + rand() % 15000);
+    } else {
+      std::vector<GeoPoint> pts;
+      const unsigned num = 5 + rand() % 40;
+      for (unsigned j = 0; j < num; ++j)
+        pts.push_back(GeoVector(5000 + rand() % 10000,
+                                Angle::FullCircle() * j / num).EndPoint(c));
+      as = new AirspacePolygon(pts, false);
+    }
+
+    AirspaceAltitude base, top;
+    if (rand() % 4 == 0) {
+      base.reference = AltitudeReference::STD;
+      base.flight_level = 50 + rand() % 200;
+    } else {
+      base.reference = AltitudeReference::MSL;
+      base.altitude = rand() % 6000;
+    }
+
+    top.reference = AltitudeReference::MSL;
+    top.altitude = base.reference == AltitudeReference::STD
+      ? base.flight_level * 30.48 + 300 + rand() % 1500
+      : base.altitude + 300 + rand() % 1500;
+
+    as->SetProperties(_T("Benchmark"), AirspaceClass(rand() % 14),
+                      base, top);
+    airspaces.Add(as);
+  }
+
+  airspaces.Optimise();
+  airspaces.SetFlightLevels(AtmosphericPressure::Standard());
+}
+
+class CountingIntersectionVisitor final : public AirspaceIntersectionVisitor {
+public:
+  unsigned count = 0;
+
+  void Visit(const AbstractAirspace &) override {
+    ++count;
+  }
+};
+
+static void
+PrintResult(const char *name, unsigned candidates, unsigned matches,
+            uint64_t duration_us)
+{
+  printf("%-28s candidates=%-9u matches=%-9u time=%.3f ms\n",
+         name, candidates, matches, duration_us / 1000.);
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  Airspaces airspaces;
+  SetupAirspaces(airspaces);
+
+  std::vector<AircraftState> states(NUM_QUERIES);
+  std::vector<GeoPoint> targets(NUM_QUERIES);
+  for (unsigned i = 0; i < NUM_QUERIES; ++i) {
+    states[i].location = RandomLocation();
+    states[i].altitude = 500 + rand() % 6000;
+    targets[i] = GeoVector(5000, Angle::Degrees(rand() % 360))
+      .EndPoint(states[i].location);
+  }
+
+  static constexpr double range = 20000;
+  static constexpr double margin = 300;
+
+  {
+    unsigned candidates = 0, matches = 0;
+    const auto start = MonotonicClockUS();
+    for (const auto &state : states) {
+      const AirspacePredicateHeightRange predicate(state.altitude - margin,
+                                                   state.altitude + margin);
+      for (const auto &i : airspaces.QueryWithinRange(state.location, range)) {
+        ++candidates;
+        if (predicate(i.GetAirspace()))
+          ++matches;
+      }
+    }
+    PrintResult("QueryWithinRange 2D", candidates, matches,
+                MonotonicClockUS() - start);
+  }
+
+  {
+    unsigned candidates = 0, matches = 0;
+    const auto start = MonotonicClockUS();
+    for (const auto &state : states) {
+      const AirspacePredicateHeightRange predicate(state.altitude - margin,
+                                                   state.altitude + margin);
+      for (const auto &i : airspaces.QueryWithinRange(state.location, range,
+                                                      state.altitude - margin,
+                                                      state.altitude + margin)) {
+        ++candidates;
+        if (predicate(i.GetAirspace()))
+          ++matches;
+      }
+    }
+    PrintResult("QueryWithinRange altitude", candidates, matches,
+                MonotonicClockUS() - start);
+  }
+
+  {
+    unsigned candidates = 0, matches = 0;
+    const auto start = MonotonicClockUS();
+    for (const auto &state : states) {
+      for (const auto &i : airspaces.QueryInside(state.location)) {
+        ++candidates;
+        if (i.GetAirspace().Inside((const AltitudeState &)state))
+          ++matches;
+      }
+    }
+    PrintResult("QueryInside 2D", candidates, matches,
+                MonotonicClockUS() - start);
+  }
+
+  {
+    unsigned candidates = 0, matches = 0;
+    const auto start = MonotonicClockUS();
+    for (const auto &state : states) {
+      for (const auto &i : airspaces.QueryInside(state.location,
+                                                 state.altitude,
+                                                 state.altitude)) {
+        ++candidates;
+        if (i.GetAirspace().Inside((const AltitudeState &)state))
+          ++matches;
+      }
+    }
+    PrintResult("QueryInside altitude", candidates, matches,
+                MonotonicClockUS() - start);
+  }
+
+  {
+    CountingIntersectionVisitor visitor;
+    const auto start = MonotonicClockUS();
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+      airspaces.VisitIntersecting(states[i].location, targets[i], visitor);
+    PrintResult("VisitIntersecting 2D", visitor.count, visitor.count,
+                MonotonicClockUS() - start);
+  }
+
+  {
+    CountingIntersectionVisitor visitor;
+    const auto start = MonotonicClockUS();
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+      airspaces.VisitIntersecting(states[i].location, targets[i], false,
+                                  states[i].altitude - margin,
+                                  states[i].altitude + margin,
+                                  visitor);
+    PrintResult("VisitIntersecting altitude", visitor.count, visitor.count,
+                MonotonicClockUS() - start);
+  }
+
+  return 0;
+}
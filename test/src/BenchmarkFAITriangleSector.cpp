@@ -21,11 +21,29 @@ Copyright_License {
 }
 */
 
+/*
+ * Compares the classic GenerateFAITriangleArea() with the cached
+ * FAITriangleSector, and the point-in-area test with
+ * FAITriangleRules::TestDistances().  Prints the time per call.
+ */
+
 #include "Engine/Task/Shapes/FAITriangleArea.hpp"
+#include "Engine/Task/Shapes/FAITriangleSector.hpp"
+#include "Engine/Task/Shapes/FAITriangleRules.hpp"
 #include "Engine/Task/Shapes/FAITriangleSettings.hpp"
 #include "Geo/GeoPoint.hpp"
+#include "OS/Clock.hpp"
 #include "Compiler.h"
 
+#include <stdio.h>
+
+static void
+Report(const char *name, uint64_t start_us, unsigned n)
+{
+  printf("%-28s %8.3f us\n", name,
+         double(MonotonicClockUS() - start_us) / n);
+}
+
 int
 main(gcc_unused int argc, gcc_unused char **argv)
 {
@@ -36,11 +54,77 @@ main(gcc_unused int argc, gcc_unused char **argv)
                    Angle::Degrees(51.052));
   const GeoPoint b(Angle::Degrees(11.5228),
                    Angle::Degrees(50.3972));
+  const GeoPoint b2(Angle::Degrees(11.5229),
+                    Angle::Degrees(50.3972));
 
   GeoPoint buffer[FAI_TRIANGLE_SECTOR_MAX];
 
-  for (unsigned i = 256 * 1024; i-- > 0;)
-    GenerateFAITriangleArea(buffer, a, b, false, settings);
+  constexpr unsigned N = 256 * 1024;
+  unsigned n_vertices = 0;
+
+  auto start = MonotonicClockUS();
+  for (unsigned i = N; i-- > 0;)
+    n_vertices += GenerateFAITriangleArea(buffer, a, b, false, settings)
+      - buffer;
+  Report("GenerateFAITriangleArea", start, N);
+
+  /* a new leg in every iteration */
+  FAITriangleSector sector;
+  start = MonotonicClockUS();
+  for (unsigned i = N; i-- > 0;) {
+    sector.Update(a, (i & 1) ? b : b2, false, settings);
+    n_vertices += sector.GetBoundary().size;
+  }
+  Report("FAITriangleSector rebuild", start, N);
+
+  /* the same leg in every frame */
+  start = MonotonicClockUS();
+  for (unsigned i = N; i-- > 0;) {
+    sector.Update(a, b, false, settings);
+    n_vertices += sector.GetBoundary().size;
+  }
+  Report("FAITriangleSector cached", start, N);
+
+  /* zooming in: refine from the default resolution */
+  start = MonotonicClockUS();
+  for (unsigned i = N / 8; i-- > 0;) {
+    sector.Update(a, (i & 1) ? b : b2, false, settings);
+    n_vertices += sector.GetBoundary(FAITriangleSector::DEFAULT_STEPS).size;
+    n_vertices += sector.GetBoundary(FAITriangleSector::DEFAULT_STEPS * 2).size;
+  }
+  Report("FAITriangleSector refine", start, N / 8);
+
+  /* a grid of candidate third points around the leg */
+  constexpr unsigned GRID = 64;
+  const GeoPoint sw(Angle::Degrees(2.), Angle::Degrees(45.));
+  const Angle step = Angle::Degrees(15. / GRID);
+
+  unsigned n_inside = 0, n_rules = 0;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < GRID; ++i)
+    for (unsigned j = 0; j < GRID; ++j) {
+      const GeoPoint p(sw.longitude + step * i, sw.latitude + step * j);
+      n_rules += FAITriangleRules::TestDistances(a, b, p, settings);
+    }
+  Report("TestDistances", start, GRID * GRID);
+
+  sector.Update(a, b, true, settings);
+  FAITriangleSector other;
+  other.Update(a, b, false, settings);
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < GRID; ++i)
+    for (unsigned j = 0; j < GRID; ++j) {
+      const GeoPoint p(sw.longitude + step * i, sw.latitude + step * j);
+      n_inside += sector.IsInside(p) || other.IsInside(p);
+    }
+  Report("FAITriangleSector::IsInside", start, GRID * GRID);
+
+  if (n_inside != n_rules) {
+    fprintf(stderr, "Mismatch: %u points inside, %u valid\n",
+            n_inside, n_rules);
+    return 1;
+  }
 
-  return 0;
+  /* prevent gcc from optimizing the loops away */
+  return n_vertices == 0;
 }
@@ -0,0 +1,286 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Pans the map across a synthetic set of 20000 waypoints and places
+ * their labels the way the map renderers do, without drawing them.
+ * Reports the time per frame, the number of labels placed and the
+ * number of labels which were placed in the previous frame but got
+ * dropped although still on screen, as JSON on stdout.
+ */
+
+#include "Renderer/LabelBlock.hpp"
+#include "Renderer/LabelHistory.hpp"
+#include "Renderer/WaypointLabelList.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Clock.hpp"
+#include "Util/Macros.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned NUM_WAYPOINTS = 20000;
+static constexpr unsigned NUM_FRAMES = 500;
+
+static constexpr unsigned SCREEN_WIDTH = 1280, SCREEN_HEIGHT = 800;
+
+/** Approximation of the text metrics of the map label font */
+static constexpr int CHAR_WIDTH = 7, FONT_HEIGHT = 14, PADDING = 2;
+
+static const GeoPoint center(Angle::Degrees(7.7061111111111114),
+                             Angle::Degrees(51.051944444444445));
+
+static void
+GenerateWaypoints(Waypoints &waypoints)
+{
+  static const TCHAR *const syllables[] = {
+    _T("ka"), _T("ber"), _T("lin"), _T("ho"), _T("fen"), _T("stadt"),
+    _T("dorf"), _T("wald"), _T("en"), _T("burg"), _T("see"), _T("tal"),
+  };
+
+  for (unsigned i = 0; i < NUM_WAYPOINTS; ++i) {
+    Waypoint waypoint;
+    waypoint.location =
+      GeoPoint(center.longitude + Angle::Degrees((rand() % 6000 - 3000) / 1000.),
+               center.latitude + Angle::Degrees((rand() % 4000 - 2000) / 1000.));
+    waypoint.elevation = rand() % 1000;
+
+    if (i % 25 == 0)
+      waypoint.type = Waypoint::Type::AIRFIELD;
+    else if (i % 7 == 0)
+      waypoint.type = Waypoint::Type::OUTLANDING;
+
+    const unsigned n_syllables = 1 + rand() % 4;
+    for (unsigned j = 0; j < n_syllables; ++j)
+      waypoint.name += syllables[rand() % ARRAY_SIZE(syllables)];
+
+    waypoints.Append(std::move(waypoint));
+  }
+
+  waypoints.Optimise();
+}
+
+/**
+ * Calculate the rectangle of a label like TextInBox() does with the
+ * default #TextInBoxMode.
+ */
+static PixelRect
+LabelRect(const TCHAR *text, PixelPoint p)
+{
+  PixelRect rc;
+  rc.left = p.x - PADDING - 1;
+  rc.right = p.x + int(_tcslen(text)) * CHAR_WIDTH + PADDING;
+  rc.top = p.y;
+  rc.bottom = p.y + FONT_HEIGHT + 1;
+  return rc;
+}
+
+struct VisibleLabel {
+  const Waypoint *waypoint;
+  PixelPoint point;
+};
+
+class CollectVisible final : public WaypointVisitor {
+  const WindowProjection &projection;
+
+public:
+  std::vector<VisibleLabel> labels;
+
+  explicit CollectVisible(const WindowProjection &_projection)
+    :projection(_projection) {}
+
+  void Visit(const WaypointPtr &wp) override {
+    PixelPoint p;
+    if (projection.GeoToScreenIfVisible(wp->location, p))
+      labels.push_back({wp.get(), {p.x + 5, p.y}});
+  }
+};
+
+class Timing {
+  const char *const name;
+  std::vector<unsigned> samples;
+  unsigned long placed = 0, dropped = 0;
+
+  /** The labels placed in the previous frame, sorted */
+  std::vector<const void *> previous, current;
+
+public:
+  explicit Timing(const char *_name):name(_name) {}
+
+  void Add(uint64_t duration_us) {
+    samples.push_back(duration_us);
+  }
+
+  void Placed(const void *key) {
+    current.push_back(key);
+  }
+
+  /**
+   * Finish a frame.  Counts the candidates which were placed in the
+   * previous frame, but not in this one.
+   */
+  void Commit(const std::vector<const void *> &candidates) {
+    std::sort(current.begin(), current.end());
+    placed += current.size();
+
+    for (const void *key : candidates)
+      if (std::binary_search(previous.begin(), previous.end(), key) &&
+          !std::binary_search(current.begin(), current.end(), key))
+        ++dropped;
+
+    previous.swap(current);
+    current.clear();
+  }
+
+  void PrintJSON(bool last) {
+    double mean = 0;
+    unsigned p99 = 0;
+    if (!samples.empty()) {
+      for (const auto i : samples)
+        mean += i;
+      mean /= samples.size();
+
+      std::sort(samples.begin(), samples.end());
+      p99 = samples[samples.size() * 99 / 100];
+    }
+
+    const unsigned n = std::max<unsigned>(samples.size(), 1);
+    printf("    \"%s\": {\"frames\": %u, \"mean_us\": %.2f, \"p99_us\": %u, "
+           "\"placed\": %.1f, \"dropped\": %.2f}%s\n",
+           name, (unsigned)samples.size(), mean, p99,
+           double(placed) / n, double(dropped) / n, last ? "" : ",");
+  }
+};
+
+/**
+ * Check all visible labels in the order of the waypoint database,
+ * like TopographyFileRenderer::PaintLabels().
+ */
+static void
+PlaceAll(const std::vector<VisibleLabel> &visible, LabelBlock &label_block,
+         Timing &timing)
+{
+  const auto start = MonotonicClockUS();
+
+  label_block.reset();
+  for (const auto &i : visible)
+    if (label_block.check(LabelRect(i.waypoint->name.c_str(), i.point)))
+      timing.Placed(i.waypoint);
+
+  timing.Add(MonotonicClockUS() - start);
+
+  std::vector<const void *> candidates;
+  for (const auto &i : visible)
+    candidates.push_back(i.waypoint);
+  timing.Commit(candidates);
+}
+
+/**
+ * Collect, sort and place the labels like WaypointRenderer.
+ */
+static void
+PlaceWaypoints(const std::vector<VisibleLabel> &visible,
+               LabelBlock &label_block, LabelHistory &history,
+               Timing &timing)
+{
+  const auto start = MonotonicClockUS();
+
+  WaypointLabelList labels(SCREEN_WIDTH, SCREEN_HEIGHT);
+  for (const auto &i : visible) {
+    const Waypoint &wp = *i.waypoint;
+    labels.Add(&wp, wp.name.c_str(), i.point.x, i.point.y, TextInBoxMode(),
+               wp.IsLandable(), wp.elevation, false,
+               wp.IsLandable(), wp.IsAirport(), false);
+  }
+
+  labels.Sort(history);
+
+  label_block.reset();
+  for (const auto &l : labels) {
+    if (label_block.check(LabelRect(l.Name, l.Pos))) {
+      history.Placed(l.key);
+      timing.Placed(l.key);
+    }
+  }
+
+  history.Commit();
+
+  timing.Add(MonotonicClockUS() - start);
+
+  std::vector<const void *> candidates;
+  for (const auto &l : labels)
+    candidates.push_back(l.key);
+  timing.Commit(candidates);
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  Waypoints waypoints;
+  GenerateWaypoints(waypoints);
+
+  WindowProjection projection;
+  projection.SetScreenSize({SCREEN_WIDTH, SCREEN_HEIGHT});
+  projection.SetScreenOrigin(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+  projection.SetScreenAngle(Angle::Zero());
+  projection.SetScaleFromRadius(50000);
+
+  LabelBlock label_block;
+  LabelHistory history;
+
+  Timing all("all"), waypoint_list("waypoint_list");
+
+  unsigned long visible_count = 0;
+  for (unsigned frame = 0; frame < NUM_FRAMES; ++frame) {
+    /* fly east at 200 m per frame */
+    const GeoVector vector(frame * 200, Angle::Degrees(90));
+    projection.SetGeoLocation(vector.EndPoint(center));
+    projection.UpdateScreenBounds();
+
+    CollectVisible visitor(projection);
+    waypoints.VisitWithinRange(projection.GetGeoScreenCenter(),
+                               projection.GetScreenDistanceMeters(),
+                               visitor);
+    visible_count += visitor.labels.size();
+
+    PlaceAll(visitor.labels, label_block, all);
+    PlaceWaypoints(visitor.labels, label_block, history, waypoint_list);
+  }
+
+  printf("{\n");
+  printf("  \"waypoints\": %u,\n", NUM_WAYPOINTS);
+  printf("  \"visible\": %.1f,\n", double(visible_count) / NUM_FRAMES);
+  printf("  \"timings\": {\n");
+  all.PrintJSON(false);
+  waypoint_list.PrintJSON(true);
+  printf("  }\n");
+  printf("}\n");
+
+  return EXIT_SUCCESS;
+}
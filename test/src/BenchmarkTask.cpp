@@ -0,0 +1,286 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Flies a generated task of each factory type with the TaskAutoPilot
+ * and reports the time per TaskManager update as JSON on stdout.
+ *
+ * The "standalone_solvers" section times a separate run of each solver
+ * after every update.  These runs are made outside of
+ * TaskManager::Update(), on copies that see the same task state; the
+ * TaskDijkstra instances are kept between updates, so they are warm.
+ * They show the relative cost of the solvers, not their share of the
+ * "update" time.
+ */
+
+#include "harness_task.hpp"
+#include "harness_waypoints.hpp"
+#include "Replay/TaskAutoPilot.hpp"
+#include "Replay/AircraftSim.hpp"
+#include "Replay/TaskAccessor.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Task/Ordered/Points/AATPoint.hpp"
+#include "Engine/Task/Ordered/AATIsolineSegment.hpp"
+#include "Engine/Task/Factory/AbstractTaskFactory.hpp"
+#include "Engine/Task/Solvers/TaskBestMc.hpp"
+#include "Engine/Task/Solvers/TaskCruiseEfficiency.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMin.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMax.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Geo/SearchPoint.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Upper limit for the number of updates per flight */
+static constexpr unsigned MAX_UPDATES = 4000;
+
+/** Number of attempts to generate a valid task of one type */
+static constexpr unsigned MAX_ATTEMPTS = 500;
+
+class Timing {
+  const char *const name;
+  std::vector<unsigned> samples;
+
+public:
+  explicit Timing(const char *_name):name(_name) {}
+
+  void Add(uint64_t duration_us) {
+    samples.push_back(duration_us);
+  }
+
+  void PrintJSON(bool last) {
+    double mean = 0;
+    unsigned p99 = 0;
+    if (!samples.empty()) {
+      for (const auto i : samples)
+        mean += i;
+      mean /= samples.size();
+
+      std::sort(samples.begin(), samples.end());
+      p99 = samples[samples.size() * 99 / 100];
+    }
+
+    printf("        \"%s\": {\"count\": %u, \"mean_us\": %.2f, \"p99_us\": %u}%s\n",
+           name, (unsigned)samples.size(), mean, p99, last ? "" : ",");
+  }
+};
+
+struct TaskTimings {
+  Timing update{"update"}, update_idle{"update_idle"};
+  Timing best_mc{"best_mc"}, cruise_efficiency{"cruise_efficiency"};
+  Timing dijkstra_min{"dijkstra_min"}, dijkstra_max{"dijkstra_max"};
+  Timing aat_isolines{"aat_isolines"};
+
+  TaskDijkstraMin dijkstra_min_solver;
+  TaskDijkstraMax dijkstra_max_solver;
+
+  void PrintUpdateJSON() {
+    update.PrintJSON(false);
+    update_idle.PrintJSON(true);
+  }
+
+  void PrintSolverJSON() {
+    best_mc.PrintJSON(false);
+    cruise_efficiency.PrintJSON(false);
+    dijkstra_min.PrintJSON(false);
+    dijkstra_max.PrintJSON(false);
+    aat_isolines.PrintJSON(true);
+  }
+};
+
+/**
+ * Run a separate instance of each solver once on the current state of
+ * the task, the way OrderedTask does it, outside of
+ * TaskManager::Update().  None of them modifies the task.
+ */
+static void
+TimeSolvers(const TaskManager &task_manager, const AircraftState &state,
+            TaskTimings &timings)
+{
+  const OrderedTask &task = task_manager.GetOrderedTask();
+  const unsigned size = task.TaskSize();
+  const unsigned active = task.GetActiveIndex();
+  const GlideSettings &glide = task_manager.GetTaskBehaviour().glide;
+  const GlidePolar &polar = task_manager.GetGlidePolar();
+
+  /* the solvers want non-const task points, but only read them */
+  OrderedTask &mutable_task = const_cast<OrderedTask &>(task);
+  std::vector<OrderedTaskPoint *> points;
+  for (unsigned i = 0; i < size; ++i)
+    points.push_back(&mutable_task.GetPoint(i));
+
+  auto start = MonotonicClockUS();
+  {
+    TaskBestMc bmc(points, active, state, glide, polar);
+    double best;
+    bmc.search(polar.GetMC(), best);
+  }
+  timings.best_mc.Add(MonotonicClockUS() - start);
+
+  if (active > 0) {
+    start = MonotonicClockUS();
+    TaskCruiseEfficiency bce(points, active, state, glide, polar);
+    bce.search(1);
+    timings.cruise_efficiency.Add(MonotonicClockUS() - start);
+  }
+
+  start = MonotonicClockUS();
+  {
+    TaskDijkstraMin &dijkstra = timings.dijkstra_min_solver;
+    dijkstra.SetTaskSize(size - active);
+    for (unsigned i = active; i < size; ++i)
+      dijkstra.SetBoundary(i - active, task.GetPointSearchPoints(i));
+    dijkstra.DistanceMin(SearchPoint(state.location,
+                                     task.GetTaskProjection()));
+  }
+  timings.dijkstra_min.Add(MonotonicClockUS() - start);
+
+  start = MonotonicClockUS();
+  {
+    TaskDijkstraMax &dijkstra = timings.dijkstra_max_solver;
+    dijkstra.SetTaskSize(size);
+    for (unsigned i = 0; i < size; ++i)
+      dijkstra.SetBoundary(i, task.GetPointSearchPoints(i));
+    dijkstra.DistanceMax();
+  }
+  timings.dijkstra_max.Add(MonotonicClockUS() - start);
+
+  if (task.HasTargets()) {
+    start = MonotonicClockUS();
+    for (unsigned i = active; i < size; ++i) {
+      const OrderedTaskPoint &tp = task.GetPoint(i);
+      if (tp.GetType() == TaskPointType::AAT) {
+        const AATIsolineSegment iso((const AATPoint &)tp,
+                                    task.GetTaskProjection());
+        gcc_unused const bool valid = iso.IsValid();
+      }
+    }
+    timings.aat_isolines.Add(MonotonicClockUS() - start);
+  }
+}
+
+static unsigned
+FlyTask(TaskManager &task_manager, TaskTimings &timings)
+{
+  AutopilotParameters parms;
+  parms.goto_target = true;
+
+  TaskAccessor ta(task_manager, 300);
+  TaskAutoPilot autopilot(parms);
+  AircraftSim aircraft;
+
+  autopilot.SetDefaultLocation(GeoPoint(Angle::Degrees(1), Angle::Degrees(0)));
+  aircraft.SetWind(5, Angle::Degrees(240));
+
+  autopilot.Start(ta);
+  aircraft.Start(autopilot.location_start, autopilot.location_previous,
+                 parms.start_alt);
+
+  unsigned n_updates = 0;
+  do {
+    autopilot.UpdateState(ta, aircraft.GetState());
+    aircraft.Update(autopilot.heading);
+
+    const AircraftState state = aircraft.GetState();
+    const AircraftState state_last = aircraft.GetLastState();
+
+    auto start = MonotonicClockUS();
+    task_manager.Update(state, state_last);
+    timings.update.Add(MonotonicClockUS() - start);
+
+    start = MonotonicClockUS();
+    task_manager.UpdateIdle(state);
+    timings.update_idle.Add(MonotonicClockUS() - start);
+
+    task_manager.UpdateAutoMC(state, 0);
+
+    TimeSolvers(task_manager, state, timings);
+  } while (++n_updates < MAX_UPDATES &&
+           autopilot.UpdateAutopilot(ta, aircraft.GetState()));
+
+  return n_updates;
+}
+
+static bool
+BenchmarkFactory(TaskFactoryType type, const Waypoints &waypoints,
+                 bool first)
+{
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  const GlidePolar glide_polar(2);
+
+  for (unsigned attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+    TaskManager task_manager(task_behaviour, waypoints);
+    task_manager.SetGlidePolar(glide_polar);
+
+    if (!test_task_random_type(task_manager, waypoints, type,
+                               3 + rand() % 6))
+      continue;
+
+    TaskTimings timings;
+    const unsigned n_updates = FlyTask(task_manager, timings);
+
+    printf("%s    {\n", first ? "" : ",\n");
+    printf("      \"factory\": \"%s\",\n", factory_name(type));
+    printf("      \"size\": %u,\n", task_manager.TaskSize());
+    printf("      \"updates\": %u,\n", n_updates);
+    printf("      \"timings\": {\n");
+    timings.PrintUpdateJSON();
+    printf("      },\n");
+    printf("      \"standalone_solvers\": {\n");
+    timings.PrintSolverJSON();
+    printf("      }\n");
+    printf("    }");
+    return true;
+  }
+
+  fprintf(stderr, "Failed to generate a %s task\n", factory_name(type));
+  return false;
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  Waypoints waypoints;
+  SetupWaypoints(waypoints);
+
+  printf("{\n");
+  printf("  \"tasks\": [\n");
+
+  bool first = true;
+  for (unsigned i = 0; i < unsigned(TaskFactoryType::COUNT); ++i)
+    if (BenchmarkFactory(TaskFactoryType(i), waypoints, first))
+      first = false;
+
+  printf("\n  ]\n");
+  printf("}\n");
+
+  return EXIT_SUCCESS;
+}
@@ -25,12 +25,21 @@ Copyright_License {
 #include "Waypoint/Factory.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/Flat/TaskProjection.hpp"
+#include "Util/QuadTree.hpp"
+#include "Util/PackedRTree.hpp"
+#include "OS/Clock.hpp"
 #include "OS/ConvertPathName.hpp"
 #include "OS/Args.hpp"
 #include "Operation/Operation.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <tchar.h>
 
 static bool
@@ -127,10 +136,315 @@ PrintWaypoint(const Waypoint *waypoint)
               waypoint->name.c_str());
 }
 
+struct BenchmarkItem {
+  FlatGeoPoint location;
+  const Waypoint *waypoint;
+};
+
+struct BenchmarkAccessor {
+  gcc_pure
+  int GetX(const BenchmarkItem &item) const {
+    return item.location.x;
+  }
+
+  gcc_pure
+  int GetY(const BenchmarkItem &item) const {
+    return item.location.y;
+  }
+};
+
+struct BenchmarkQuery {
+  FlatGeoPoint location;
+  unsigned range;
+};
+
+struct CountVisitor {
+  unsigned n = 0;
+
+  void operator()(const BenchmarkItem &) {
+    ++n;
+  }
+};
+
+struct CountWaypointVisitor final : WaypointVisitor {
+  unsigned n = 0;
+
+  void Visit(const WaypointPtr &) override {
+    ++n;
+  }
+};
+
+static uint64_t
+SquareDistance(const FlatGeoPoint a, const FlatGeoPoint b)
+{
+  const int64_t dx = a.x - b.x, dy = a.y - b.y;
+  return dx * dx + dy * dy;
+}
+
+static void
+PrintTiming(const char *name, const char *container, uint64_t start_us,
+            unsigned n_queries, unsigned n_results)
+{
+  const uint64_t duration_us = MonotonicClockUS() - start_us;
+  printf("%-16s %-12s %8.1f ms %10.0f queries/s %10u results\n",
+         name, container, duration_us / 1000.,
+         duration_us > 0 ? n_queries * 1000000. / duration_us : 0.,
+         n_results);
+}
+
+static void
+PrintBuildTiming(const char *container, uint64_t start_us, unsigned size)
+{
+  printf("%-16s %-12s %8.1f ms %10u items\n", "build", container,
+         (MonotonicClockUS() - start_us) / 1000., size);
+}
+
+/**
+ * Compare the QuadTree which used to be the only spatial index of
+ * #Waypoints with the PackedRTree built by Waypoints::Optimise(), on
+ * random locations near the waypoints.
+ */
+template<typename P>
+static void
+BenchmarkNearest(const char *name,
+                 const QuadTree<BenchmarkItem, BenchmarkAccessor> &quad_tree,
+                 const PackedRTree<BenchmarkItem, BenchmarkAccessor> &packed,
+                 const std::vector<BenchmarkQuery> &queries,
+                 const P &predicate)
+{
+  typedef QuadTree<BenchmarkItem, BenchmarkAccessor> Quad;
+  typedef PackedRTree<BenchmarkItem, BenchmarkAccessor> Packed;
+
+  std::vector<uint64_t> distances;
+  distances.reserve(queries.size());
+
+  unsigned n_found = 0;
+  uint64_t start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    const auto found =
+      quad_tree.FindNearestIf(Quad::Point(q.location.x, q.location.y),
+                              q.range, predicate);
+    if (found.first != quad_tree.end()) {
+      ++n_found;
+      distances.push_back(SquareDistance(q.location, found.first->location));
+    } else
+      distances.push_back(UINT64_MAX);
+  }
+  PrintTiming(name, "QuadTree", start, queries.size(), n_found);
+
+  unsigned n_mismatches = 0;
+  n_found = 0;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < queries.size(); ++i) {
+    const auto &q = queries[i];
+    const auto found =
+      packed.FindNearestIf(Packed::Point(q.location.x, q.location.y),
+                           q.range, predicate);
+    uint64_t distance = UINT64_MAX;
+    if (found != packed.end()) {
+      ++n_found;
+      distance = SquareDistance(q.location, found->location);
+    }
+
+    if (distance != distances[i])
+      ++n_mismatches;
+  }
+  PrintTiming(name, "PackedRTree", start, queries.size(), n_found);
+
+  if (n_mismatches > 0)
+    printf("%s: %u mismatches\n", name, n_mismatches);
+}
+
+static void
+BenchmarkRange(const QuadTree<BenchmarkItem, BenchmarkAccessor> &quad_tree,
+               const PackedRTree<BenchmarkItem, BenchmarkAccessor> &packed,
+               const std::vector<BenchmarkQuery> &queries)
+{
+  typedef QuadTree<BenchmarkItem, BenchmarkAccessor> Quad;
+  typedef PackedRTree<BenchmarkItem, BenchmarkAccessor> Packed;
+
+  CountVisitor quad_visitor;
+  uint64_t start = MonotonicClockUS();
+  for (const auto &q : queries)
+    quad_tree.VisitWithinRange(Quad::Point(q.location.x, q.location.y),
+                               q.range, quad_visitor);
+  PrintTiming("range", "QuadTree", start, queries.size(), quad_visitor.n);
+
+  CountVisitor packed_visitor;
+  start = MonotonicClockUS();
+  for (const auto &q : queries)
+    packed.VisitWithinRange(Packed::Point(q.location.x, q.location.y),
+                            q.range, packed_visitor);
+  PrintTiming("range", "PackedRTree", start, queries.size(), packed_visitor.n);
+
+  if (packed_visitor.n != quad_visitor.n)
+    printf("range: result count mismatch\n");
+}
+
+/**
+ * Compare PackedRTree::VisitNearestIf() with the pattern it replaces:
+ * collect all matches within range and sort them by distance.
+ */
+template<typename P>
+static void
+BenchmarkKNearest(const char *name, unsigned k,
+                  const QuadTree<BenchmarkItem, BenchmarkAccessor> &quad_tree,
+                  const PackedRTree<BenchmarkItem, BenchmarkAccessor> &packed,
+                  const std::vector<BenchmarkQuery> &queries,
+                  const P &predicate)
+{
+  typedef QuadTree<BenchmarkItem, BenchmarkAccessor> Quad;
+  typedef PackedRTree<BenchmarkItem, BenchmarkAccessor> Packed;
+
+  std::vector<uint64_t> expected, found;
+  std::vector<uint64_t> distances;
+
+  unsigned n_results = 0;
+  uint64_t start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    distances.clear();
+    auto collect = [&distances, &q, &predicate](const BenchmarkItem &item){
+      if (predicate(item))
+        distances.push_back(SquareDistance(q.location, item.location));
+    };
+    quad_tree.VisitWithinRange(Quad::Point(q.location.x, q.location.y),
+                               q.range, collect);
+
+    const unsigned n = std::min<unsigned>(k, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + n,
+                      distances.end());
+    expected.insert(expected.end(), distances.begin(),
+                    distances.begin() + n);
+    n_results += n;
+  }
+  PrintTiming(name, "visit+sort", start, queries.size(), n_results);
+
+  std::vector<uint64_t> packed_expected;
+  n_results = 0;
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    distances.clear();
+    auto collect = [&distances, &q, &predicate](const BenchmarkItem &item){
+      if (predicate(item))
+        distances.push_back(SquareDistance(q.location, item.location));
+    };
+    packed.VisitWithinRange(Packed::Point(q.location.x, q.location.y),
+                            q.range, collect);
+
+    const unsigned n = std::min<unsigned>(k, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + n,
+                      distances.end());
+    packed_expected.insert(packed_expected.end(), distances.begin(),
+                           distances.begin() + n);
+    n_results += n;
+  }
+  PrintTiming(name, "packed+sort", start, queries.size(), n_results);
+
+  n_results = 0;
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    auto collect = [&found, &q](const BenchmarkItem &item){
+      found.push_back(SquareDistance(q.location, item.location));
+    };
+    n_results += packed.VisitNearestIf(Packed::Point(q.location.x,
+                                                     q.location.y),
+                                       q.range, k, predicate, collect);
+  }
+  PrintTiming(name, "PackedRTree", start, queries.size(), n_results);
+
+  if (packed_expected != expected || found != expected)
+    printf("%s: results differ\n", name);
+}
+
+/**
+ * Time Waypoints::VisitNearestIf(), which picks one of the strategies
+ * compared by BenchmarkKNearest().
+ */
+static void
+BenchmarkWaypoints(const char *name, unsigned k, const Waypoints &waypoints,
+                   const std::vector<GeoPoint> &locations, double range,
+                   bool (*predicate)(const Waypoint &))
+{
+  CountWaypointVisitor visitor;
+  uint64_t start = MonotonicClockUS();
+  for (const auto &location : locations)
+    waypoints.VisitNearestIf(location, range, k, predicate, visitor);
+  PrintTiming(name, "Waypoints", start, locations.size(), visitor.n);
+}
+
+static void
+Benchmark(const Waypoints &waypoints, double range, unsigned n_queries)
+{
+  if (waypoints.IsEmpty())
+    return;
+
+  std::vector<const Waypoint *> list;
+  for (const auto &wp : waypoints)
+    list.push_back(wp.get());
+
+  TaskProjection projection;
+  projection.Reset(list.front()->location);
+  for (const auto *wp : list)
+    projection.Scan(wp->location);
+  projection.Update();
+
+  std::vector<BenchmarkItem> items;
+  items.reserve(list.size());
+  for (const auto *wp : list)
+    items.push_back({projection.ProjectInteger(wp->location), wp});
+
+  uint64_t start = MonotonicClockUS();
+  QuadTree<BenchmarkItem, BenchmarkAccessor> quad_tree;
+  for (const auto &i : items)
+    quad_tree.Add(i);
+  quad_tree.Optimise();
+  PrintBuildTiming("QuadTree", start, quad_tree.size());
+
+  start = MonotonicClockUS();
+  PackedRTree<BenchmarkItem, BenchmarkAccessor> packed;
+  packed.Build(items.begin(), items.end());
+  PrintBuildTiming("PackedRTree", start, packed.size());
+
+  /* random locations up to the search range away from a waypoint */
+  srand(42);
+  std::vector<GeoPoint> locations;
+  locations.reserve(n_queries);
+  std::vector<BenchmarkQuery> queries;
+  queries.reserve(n_queries);
+  for (unsigned i = 0; i < n_queries; ++i) {
+    const Waypoint &wp = *list[rand() % list.size()];
+    const GeoPoint location =
+      GeoVector(range * rand() / RAND_MAX,
+                Angle::Degrees(rand() % 360)).EndPoint(wp.location);
+    locations.push_back(location);
+    queries.push_back({projection.ProjectInteger(location),
+                       projection.ProjectRangeInteger(location, range)});
+  }
+
+  BenchmarkNearest("nearest", quad_tree, packed, queries,
+                   [](const BenchmarkItem &){ return true; });
+  BenchmarkNearest("nearest_landable", quad_tree, packed, queries,
+                   [](const BenchmarkItem &item){
+                     return item.waypoint->IsLandable();
+                   });
+  BenchmarkRange(quad_tree, packed, queries);
+  BenchmarkKNearest("10_nearest", 10, quad_tree, packed, queries,
+                    [](const BenchmarkItem &){ return true; });
+  BenchmarkWaypoints("10_nearest", 10, waypoints, locations, range,
+                     [](const Waypoint &){ return true; });
+  BenchmarkKNearest("10_landables", 10, quad_tree, packed, queries,
+                    [](const BenchmarkItem &item){
+                      return item.waypoint->IsLandable();
+                    });
+  BenchmarkWaypoints("10_landables", 10, waypoints, locations, range,
+                     [](const Waypoint &wp){ return wp.IsLandable(); });
+}
+
 int main(int argc, char **argv)
 {
   WaypointType type = WaypointType::ALL;
   double range = 100000;
+  unsigned benchmark = 0;
 
   Args args(argc, argv,
             "PATH\n\nPATH is expected to be any compatible waypoint file.\n"
@@ -140,7 +454,9 @@ int main(int argc, char **argv)
             "2.12343 34.38432\n"
             "65.18234 -173.48307\n\n"
             "Output is in the format: LAT LON ELEV (in m) NAME\n\ne.g.\n"
-            "50.823055 6.186384 189 Aachen Merzbruc");
+            "50.823055 6.186384 189 Aachen Merzbruc\n\n"
+            "--benchmark=N compares the spatial indexes with N random\n"
+            "queries instead of reading stdin.");
 
   const char *arg;
   while ((arg = args.PeekNext()) != NULL && *arg == '-') {
@@ -155,6 +471,8 @@ int main(int argc, char **argv)
       type = WaypointType::AIRPORT;
     } else if (StringStartsWith(arg, "--landables-only")) {
       type = WaypointType::LANDABLE;
+    } else if ((value = StringAfterPrefix(arg, "--benchmark=")) != NULL) {
+      benchmark = strtoul(value, NULL, 10);
     } else {
       args.UsageError();
     }
@@ -167,6 +485,11 @@ int main(int argc, char **argv)
   if (!LoadWaypoints(path, waypoints))
     return EXIT_FAILURE;
 
+  if (benchmark > 0) {
+    Benchmark(waypoints, range, benchmark);
+    return EXIT_SUCCESS;
+  }
+
   char buffer[1024];
   const char *line;
   while ((line = fgets(buffer, sizeof(buffer) - 3, stdin)) != NULL) {
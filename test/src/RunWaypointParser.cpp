@@ -21,11 +21,20 @@ Copyright_License {
 }
 */
 
+/*
+ * Parses a waypoint file and dumps the waypoints to stdout.  The
+ * time needed for parsing, optimising and (if a cache directory is
+ * given) storing and loading the binary cache is printed to stderr.
+ */
+
 #include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/WaypointCache.hpp"
 #include "Waypoint/Factory.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "IO/FileCache.hpp"
 #include "OS/Args.hpp"
+#include "OS/Clock.hpp"
 #include "Operation/Operation.hpp"
 
 #include <stdio.h>
@@ -42,23 +51,85 @@ public:
   }
 };
 
+static void
+PrintTime(const char *name, uint64_t start_us)
+{
+  fprintf(stderr, "%s: %.1f ms\n",
+          name, (MonotonicClockUS() - start_us) / 1000.);
+}
+
+/**
+ * Store the waypoints in the binary cache, and load them back into a
+ * new #Waypoints instance.
+ */
+static bool
+BenchmarkCache(Path path, Path cache_path, const Waypoints &way_points)
+{
+  static const TCHAR *const cache_name = _T("waypoints");
+
+  FileCache cache(AllocatedPath{cache_path});
+
+  auto start = MonotonicClockUS();
+  if (!SaveWaypointCache(cache, cache_name, path, nullptr,
+                         WaypointOrigin::NONE, way_points)) {
+    fprintf(stderr, "SaveWaypointCache() has failed\n");
+    return false;
+  }
+  PrintTime("save cache", start);
+
+  Waypoints cached;
+
+  start = MonotonicClockUS();
+  if (!LoadWaypointCache(cache, cache_name, path, nullptr,
+                         WaypointOrigin::NONE, cached)) {
+    fprintf(stderr, "LoadWaypointCache() has failed\n");
+    return false;
+  }
+  PrintTime("load cache", start);
+
+  start = MonotonicClockUS();
+  cached.Optimise();
+  PrintTime("optimise cached", start);
+
+  if (cached.size() != way_points.size()) {
+    fprintf(stderr, "Cache size mismatch: %u != %u\n",
+            cached.size(), way_points.size());
+    return false;
+  }
+
+  return true;
+}
+
 int main(int argc, char **argv)
 {
-  Args args(argc, argv, "PATH\n");
+  Args args(argc, argv, "PATH [CACHEDIR]\n");
   const auto path = args.ExpectNextPath();
+  const AllocatedPath cache_path = args.IsEmpty()
+    ? nullptr
+    : AllocatedPath(args.ExpectNextPath());
   args.ExpectEnd();
 
   Waypoints way_points;
 
   NullOperationEnvironment operation;
+
+  auto start = MonotonicClockUS();
   if (!ReadWaypointFile(path, way_points,
                         WaypointFactory(WaypointOrigin::NONE),
                         operation)) {
     fprintf(stderr, "ReadWaypointFile() has failed\n");
     return EXIT_FAILURE;
   }
+  PrintTime("parse", start);
 
+  start = MonotonicClockUS();
   way_points.Optimise();
+  PrintTime("optimise", start);
+
+  if (!cache_path.IsNull() &&
+      !BenchmarkCache(path, cache_path, way_points))
+    return EXIT_FAILURE;
+
   printf("Size %d\n", way_points.size());
 
   DumpVisitor visitor;
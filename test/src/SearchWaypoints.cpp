@@ -0,0 +1,224 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/Factory.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Util/TrigramIndex.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringUtil.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Args.hpp"
+#include "Operation/Operation.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <tchar.h>
+
+static bool
+LoadWaypoints(Path path, Waypoints &waypoints)
+{
+  NullOperationEnvironment operation;
+  if (!ReadWaypointFile(path, waypoints,
+                        WaypointFactory(WaypointOrigin::NONE),
+                        operation)) {
+    fprintf(stderr, "ReadWaypointFile() failed\n");
+    return false;
+  }
+
+  waypoints.Optimise();
+  return true;
+}
+
+struct PrintVisitor : public WaypointVisitor {
+  void Visit(const WaypointPtr &wp) override {
+    _ftprintf(stdout, _T("%s\t%s\n"),
+              wp->name.c_str(), wp->comment.c_str());
+  }
+};
+
+static void
+PrintTiming(const char *name, std::vector<uint64_t> &durations_us,
+            unsigned n_results)
+{
+  uint64_t total_us = 0;
+  for (const auto i : durations_us)
+    total_us += i;
+
+  std::sort(durations_us.begin(), durations_us.end());
+  const uint64_t p99_us = durations_us.empty()
+    ? 0
+    : durations_us[durations_us.size() * 99 / 100];
+
+  printf("%-20s %10.1f us mean %10u us p99 %10u results\n", name,
+         durations_us.empty() ? 0. : double(total_us) / durations_us.size(),
+         unsigned(p99_us), n_results);
+}
+
+/**
+ * Generate a query from a random name: a substring of 4 to 8
+ * characters, with one character replaced in every other query.
+ */
+static std::basic_string<TCHAR>
+RandomQuery(const std::vector<const Waypoint *> &list, unsigned i)
+{
+  while (true) {
+    const tstring &name = list[rand() % list.size()]->name;
+    std::vector<TCHAR> buffer(name.length() + 1);
+    NormalizeSearchString(buffer.data(), name.c_str());
+
+    std::basic_string<TCHAR> query(buffer.data());
+    if (query.length() < 4)
+      continue;
+
+    const unsigned length = std::min<unsigned>(query.length(),
+                                               4 + rand() % 5);
+    query = query.substr(rand() % (query.length() - length + 1), length);
+    if (i % 2 == 1)
+      query[rand() % length] = _T('A') + rand() % 26;
+    return query;
+  }
+}
+
+/**
+ * Compare the trigram index with a linear scan over the same
+ * normalised strings.
+ */
+static void
+Benchmark(const Waypoints &waypoints, unsigned n_queries)
+{
+  if (waypoints.IsEmpty())
+    return;
+
+  std::vector<const Waypoint *> list;
+  for (const auto &wp : waypoints)
+    list.push_back(wp.get());
+
+  TrigramIndex index;
+  uint64_t start = MonotonicClockUS();
+  for (const auto *wp : list) {
+    index.Add(wp->name.c_str());
+    index.Add(wp->comment.c_str());
+  }
+  index.Build();
+  printf("%-20s %10.1f ms %10u strings %10u kB\n", "build",
+         (MonotonicClockUS() - start) / 1000., index.size(),
+         unsigned(index.GetMemoryUsage() / 1024));
+
+  srand(42);
+  std::vector<std::basic_string<TCHAR>> queries;
+  for (unsigned i = 0; i < n_queries; ++i)
+    queries.push_back(RandomQuery(list, i));
+
+  for (unsigned max_errors = 0; max_errors <= 2; ++max_errors) {
+    std::vector<uint64_t> search_us, scan_us;
+    unsigned n_search = 0, n_scan = 0, n_mismatches = 0;
+
+    std::vector<TrigramIndex::Match> search, scan;
+    for (const auto &q : queries) {
+      start = MonotonicClockUS();
+      index.Search(q.c_str(), max_errors, search);
+      search_us.push_back(MonotonicClockUS() - start);
+      n_search += search.size();
+
+      start = MonotonicClockUS();
+      index.Scan(q.c_str(), max_errors, scan);
+      scan_us.push_back(MonotonicClockUS() - start);
+      n_scan += scan.size();
+
+      if (search.size() != scan.size() ||
+          !std::equal(search.begin(), search.end(), scan.begin(),
+                      [](const TrigramIndex::Match &a,
+                         const TrigramIndex::Match &b){
+                        return a.id == b.id && a.errors == b.errors;
+                      }))
+        ++n_mismatches;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "index %u errors", max_errors);
+    PrintTiming(name, search_us, n_search);
+    snprintf(name, sizeof(name), "scan %u errors", max_errors);
+    PrintTiming(name, scan_us, n_scan);
+
+    if (n_mismatches > 0)
+      printf("%u mismatches\n", n_mismatches);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  unsigned max_errors = 0, max_results = 20, benchmark = 0;
+
+  Args args(argc, argv,
+            "PATH\n\nPATH is expected to be any compatible waypoint file.\n"
+            "Stdin expects one search text per line.  The names and\n"
+            "comments of the matching waypoints are printed.\n\n"
+            "--errors=N tolerates N typos (default 0)\n"
+            "--results=N prints at most N waypoints per search (default 20)\n"
+            "--benchmark=N compares the trigram index with a linear scan\n"
+            "on N random queries instead of reading stdin.");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != NULL && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--errors=")) != NULL) {
+      max_errors = strtoul(value, NULL, 10);
+    } else if ((value = StringAfterPrefix(arg, "--results=")) != NULL) {
+      max_results = strtoul(value, NULL, 10);
+    } else if ((value = StringAfterPrefix(arg, "--benchmark=")) != NULL) {
+      benchmark = strtoul(value, NULL, 10);
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  Waypoints waypoints;
+  if (!LoadWaypoints(path, waypoints))
+    return EXIT_FAILURE;
+
+  if (benchmark > 0) {
+    Benchmark(waypoints, benchmark);
+    return EXIT_SUCCESS;
+  }
+
+  PrintVisitor visitor;
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+    StripRight(buffer);
+    waypoints.VisitText(buffer, max_errors, max_results, visitor);
+    printf("\n");
+  }
+
+  return EXIT_SUCCESS;
+}
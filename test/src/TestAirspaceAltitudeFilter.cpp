@@ -0,0 +1,212 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+
+/*
+ * Verifies that the altitude-filtered airspace queries never drop an
+ * airspace which overlaps the altitude range.
+ */
+
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Engine/Airspace/Predicate/AirspacePredicateHeightRange.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+#include <set>
+#include <vector>
+
+#include <stdlib.h>
+
+static constexpr unsigned NUM_AIRSPACES = 2000;
+static constexpr unsigned NUM_QUERIES = 500;
+
+static constexpr double range = 20000;
+static constexpr double margin = 300;
+
+static const GeoPoint center(Angle::Degrees(7.7061111111111114),
+                             Angle::Degrees(51.051944444444445));
+
+typedef std::set<const AbstractAirspace *> AirspaceSet;
+
+static GeoPoint
+RandomLocation()
+{
+  return GeoPoint(center.longitude + Angle::Degrees((rand() % 2000 - 1000) / 1000.),
+                  center.latitude + Angle::Degrees((rand() % 2000 - 1000) / 1000.));
+}
+
+static AirspaceAltitude
+RandomAltitude(double minimum)
+{
+  AirspaceAltitude altitude;
+  switch (rand() % 4) {
+  case 0:
+    altitude.reference = AltitudeReference::STD;
+    altitude.flight_level = minimum / 30.48 + rand() % 150;
+    break;
+
+  case 1:
+    altitude.reference = AltitudeReference::AGL;
+    altitude.altitude_above_terrain = minimum + rand() % 3000;
+    break;
+
+  default:
+    altitude.reference = AltitudeReference::MSL;
+    altitude.altitude = minimum + rand() % 5000;
+    break;
+  }
+
+  return altitude;
+}
+
+static void
+SetupAirspaces(Airspaces &airspaces)
+{
+  for (unsigned i = 0; i < NUM_AIRSPACES; ++i) {
+    const GeoPoint c = RandomLocation();
+
+    AbstractAirspace *as;
+    if (rand() % 3 != 0) {
+      as = new AirspaceCircle(c, 2000 + rand() % 10000);
+    } else {
+      std::vector<GeoPoint> pts;
+      const unsigned num = 5 + rand() % 20;
+      for (unsigned j = 0; j < num; ++j)
+        pts.push_back(GeoVector(3000 + rand() % 8000,
+                                Angle::FullCircle() * j / num).EndPoint(c));
+      as = new AirspacePolygon(pts, false);
+    }
+
+    const AirspaceAltitude base = RandomAltitude(0);
+    const AirspaceAltitude top = RandomAltitude(3000);
+    as->SetProperties(_T("Test"), AirspaceClass(rand() % 14), base, top);
+    airspaces.Add(as);
+  }
+
+  airspaces.Optimise();
+
+  /* a QNH far from standard moves the flight levels */
+  airspaces.SetFlightLevels(AtmosphericPressure::HectoPascal(980));
+}
+
+/**
+ * Collect the airspaces of a query result which pass the exact
+ * altitude check.
+ */
+template<typename R, typename P>
+static AirspaceSet
+Filter(const R &range, const P &predicate)
+{
+  AirspaceSet result;
+  for (const auto &i : range)
+    if (predicate(i.GetAirspace()))
+      result.insert(&i.GetAirspace());
+  return result;
+}
+
+class CollectingIntersectionVisitor final : public AirspaceIntersectionVisitor {
+public:
+  AirspaceSet airspaces;
+
+  void Visit(const AbstractAirspace &as) override {
+    airspaces.insert(&as);
+  }
+};
+
+static AirspaceSet
+Filter(const AirspaceSet &src, const AirspacePredicateHeightRange &predicate)
+{
+  AirspaceSet result;
+  for (const auto *as : src)
+    if (predicate(*as))
+      result.insert(as);
+  return result;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(5);
+
+  Airspaces airspaces;
+  SetupAirspaces(airspaces);
+
+  bool within_range = true, intersecting = true, inside = true;
+  bool inside_aircraft = true, visit_intersecting = true;
+
+  for (unsigned i = 0; i < NUM_QUERIES; ++i) {
+    AircraftState state;
+    state.location = RandomLocation();
+    state.altitude = rand() % 8000;
+
+    const GeoPoint target = GeoVector(5000 + rand() % 20000,
+                                      Angle::Degrees(rand() % 360))
+      .EndPoint(state.location);
+
+    const double h_min = state.altitude - margin;
+    const double h_max = state.altitude + margin;
+    const AirspacePredicateHeightRange predicate(h_min, h_max);
+
+    within_range &=
+      Filter(airspaces.QueryWithinRange(state.location, range,
+                                        h_min, h_max), predicate) ==
+      Filter(airspaces.QueryWithinRange(state.location, range), predicate);
+
+    intersecting &=
+      Filter(airspaces.QueryIntersecting(state.location, target,
+                                         h_min, h_max), predicate) ==
+      Filter(airspaces.QueryIntersecting(state.location, target), predicate);
+
+    inside &=
+      Filter(airspaces.QueryInside(state.location, h_min, h_max),
+             predicate) ==
+      Filter(airspaces.QueryInside(state.location), predicate);
+
+    const auto inside_state = [&state](const AbstractAirspace &as){
+      return as.Inside((const AltitudeState &)state);
+    };
+    inside_aircraft &=
+      Filter(airspaces.QueryInside(state), inside_state) ==
+      Filter(airspaces.QueryInside(state.location), inside_state);
+
+    CollectingIntersectionVisitor visitor_2d, visitor_altitude;
+    airspaces.VisitIntersecting(state.location, target, true, visitor_2d);
+    airspaces.VisitIntersecting(state.location, target, true, h_min, h_max,
+                                visitor_altitude);
+    visit_intersecting &=
+      Filter(visitor_altitude.airspaces, predicate) ==
+      Filter(visitor_2d.airspaces, predicate);
+  }
+
+  ok(within_range, "QueryWithinRange");
+  ok(intersecting, "QueryIntersecting");
+  ok(inside, "QueryInside");
+  ok(inside_aircraft, "QueryInside(AircraftState)");
+  ok(visit_intersecting, "VisitIntersecting");
+
+  return exit_status();
+}
@@ -0,0 +1,88 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspaceClass.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "TestUtil.hpp"
+
+static AbstractAirspace *
+MakeAirspace(const GeoPoint &center, double agl)
+{
+  AirspaceAltitude base;
+  base.reference = AltitudeReference::AGL;
+  base.altitude_above_terrain = agl;
+
+  AirspaceAltitude top;
+  top.reference = AltitudeReference::MSL;
+  top.altitude = 3000;
+
+  auto *airspace = new AirspaceCircle(center, 5000);
+  airspace->SetProperties(_T("Test"), CLASSD, base, top);
+  return airspace;
+}
+
+static double
+GetBase(const Airspaces &airspaces)
+{
+  return airspaces.QueryAll().begin()->GetAirspace().GetBase().altitude;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(4);
+
+  const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+  /* FakeTerrain.cpp: the terrain is at sea level everywhere */
+  RasterMap map;
+
+  Airspaces airspaces;
+  airspaces.Add(MakeAirspace(center, 100));
+  airspaces.Optimise();
+
+  airspaces.SetGroundLevels(map);
+  ok1(equals(GetBase(airspaces), 100));
+
+  /* nothing has changed: the ground levels are not looked up again,
+     and the bogus value survives */
+  airspaces.QueryAll().begin()->SetGroundLevel(500);
+  ok1(equals(GetBase(airspaces), 600));
+  airspaces.SetGroundLevels(map);
+  ok1(equals(GetBase(airspaces), 600));
+
+  /* a new airspace changes the serial */
+  airspaces.Add(MakeAirspace(center, 200));
+  airspaces.Optimise();
+  airspaces.SetGroundLevels(map);
+
+  bool all_updated = true;
+  for (const auto &i : airspaces.QueryAll()) {
+    const double agl = i.GetAirspace().GetBase().altitude_above_terrain;
+    all_updated &= equals(i.GetAirspace().GetBase().altitude, agl);
+  }
+  ok1(all_updated);
+
+  return exit_status();
+}
@@ -0,0 +1,115 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/DouglasPeucker.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <limits>
+
+static inline GeoPoint
+make_geo_point(double longitude, double latitude)
+{
+  return GeoPoint(Angle::Degrees(longitude),
+                  Angle::Degrees(latitude));
+}
+
+static unsigned
+CountSelected(const float *ranks, unsigned n, double tolerance)
+{
+  return std::count_if(ranks, ranks + n,
+                       [tolerance](float rank){ return rank >= tolerance; });
+}
+
+static void
+test_line()
+{
+  /* a straight line with a spike in the middle */
+  const GeoPoint points[] = {
+    make_geo_point(0, 0),
+    make_geo_point(0.1, 0),
+    make_geo_point(0.2, 0),
+    make_geo_point(0.3, 0.05),
+    make_geo_point(0.4, 0),
+    make_geo_point(0.5, 0),
+  };
+  constexpr unsigned n = sizeof(points) / sizeof(points[0]);
+
+  float ranks[n];
+  CalculateDouglasPeuckerRanks(points, n, false, ranks);
+
+  ok1(ranks[0] == std::numeric_limits<float>::max());
+  ok1(ranks[n - 1] == std::numeric_limits<float>::max());
+
+  /* the spike has the highest finite rank, roughly its height */
+  ok1(equals(ranks[3], Angle::Degrees(0.05).Radians(), 3));
+  ok1(ranks[1] < ranks[3]);
+  ok1(ranks[2] < ranks[3]);
+  ok1(ranks[4] < ranks[3]);
+
+  /* collinear vertices go first */
+  ok1(CountSelected(ranks, n, Angle::Degrees(0.001).Radians()) == 5);
+  ok1(CountSelected(ranks, n, Angle::Degrees(0.1).Radians()) == 2);
+}
+
+static void
+test_polygon()
+{
+  /* a square with an extra vertex in the middle of each edge */
+  const GeoPoint points[] = {
+    make_geo_point(0, 0),
+    make_geo_point(0.5, 0),
+    make_geo_point(1, 0),
+    make_geo_point(1, 0.5),
+    make_geo_point(1, 1),
+    make_geo_point(0.5, 1),
+    make_geo_point(0, 1),
+    make_geo_point(0, 0.5),
+  };
+  constexpr unsigned n = sizeof(points) / sizeof(points[0]);
+
+  float ranks[n];
+  CalculateDouglasPeuckerRanks(points, n, true, ranks);
+
+  /* the corners survive any sensible tolerance, the edge midpoints
+     don't */
+  const double tolerance = Angle::Degrees(0.001).Radians();
+  ok1(ranks[0] >= tolerance);
+  ok1(ranks[2] >= tolerance);
+  ok1(ranks[4] >= tolerance);
+  ok1(ranks[6] >= tolerance);
+  ok1(CountSelected(ranks, n, tolerance) == 4);
+
+  /* never less than a triangle */
+  ok1(CountSelected(ranks, n, 1000) == 3);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(14);
+
+  test_line();
+  test_polygon();
+
+  return exit_status();
+}
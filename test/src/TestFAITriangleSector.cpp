@@ -0,0 +1,119 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Task/Shapes/FAITriangleSector.hpp"
+#include "Engine/Task/Shapes/FAITriangleRules.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+static GeoPoint
+MakeGeoPoint(double longitude, double latitude)
+{
+  return GeoPoint(Angle::Degrees(longitude), Angle::Degrees(latitude));
+}
+
+static const GeoPoint start = MakeGeoPoint(7.7, 51.0);
+
+/* legs of about 90 km, 280 km, 750 km and 1300 km */
+static const GeoPoint ends[] = {
+  MakeGeoPoint(9, 51),
+  MakeGeoPoint(11.5, 50.4),
+  MakeGeoPoint(17, 48),
+  MakeGeoPoint(22, 44),
+};
+
+/**
+ * Compare IsInside() of both sides with FAITriangleRules on a grid
+ * of points around the leg.
+ */
+static bool
+TestIsInside(const GeoPoint &end, const FAITriangleSettings &settings)
+{
+  FAITriangleSector left, right;
+  left.Update(start, end, false, settings);
+  right.Update(start, end, true, settings);
+
+  /* degrees, large enough to contain both areas */
+  const double size = start.Distance(end) / 25000.;
+  const double longitude = start.longitude.Degrees();
+  const double latitude = start.latitude.Degrees();
+
+  for (unsigned i = 0; i <= 100; ++i) {
+    for (unsigned j = 0; j <= 100; ++j) {
+      const GeoPoint p = MakeGeoPoint(longitude + size * (i / 50. - 1),
+                                      latitude + size * (j / 50. - 1) * 0.7);
+      const bool in_left = left.IsInside(p), in_right = right.IsInside(p);
+      if ((in_left && in_right) ||
+          (in_left || in_right) !=
+          FAITriangleRules::TestDistances(start, end, p, settings))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static void
+TestRefine()
+{
+  FAITriangleSettings settings;
+  settings.SetDefaults();
+
+  FAITriangleSector a, b;
+  a.Update(start, ends[2], false, settings);
+  b.Update(start, ends[2], false, settings);
+
+  a.GetBoundary(4);
+  const auto refined = a.GetBoundary(8);
+  const auto fresh = b.GetBoundary(8);
+  ok1(refined.size == fresh.size);
+  ok1(refined.size % 8 == 0);
+
+  bool equal = true;
+  for (unsigned i = 0; i < fresh.size; ++i)
+    equal &= refined[i] == fresh[i];
+  ok1(equal);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 + 2 * ARRAY_SIZE(ends) + 3);
+
+  FAITriangleSettings settings;
+  settings.SetDefaults();
+
+  FAITriangleSector sector;
+  ok1(sector.Update(start, ends[0], false, settings));
+  ok1(!sector.Update(start, ends[0], false, settings));
+  ok1(sector.Update(start, ends[0], true, settings));
+
+  for (const auto &end : ends) {
+    settings.threshold = FAITriangleSettings::Threshold::FAI;
+    ok1(TestIsInside(end, settings));
+    settings.threshold = FAITriangleSettings::Threshold::KM500;
+    ok1(TestIsInside(end, settings));
+  }
+
+  TestRefine();
+
+  return exit_status();
+}
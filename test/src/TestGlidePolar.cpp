@@ -22,6 +22,12 @@
 
 #include "TestUtil.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlideState.hpp"
+#include "GlideSolvers/GlideResult.hpp"
+#include "GlideSolvers/MacCready.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/SpeedVector.hpp"
 #include "Units/System.hpp"
 
 #include <cstdio>
@@ -39,6 +45,9 @@ private:
   void TestBallast();
   void TestBugs();
   void TestMC();
+  void TestSpeedToFly();
+  void TestOptimiseGlide();
+  void TestSolveStraightBatch();
 };
 
 void
@@ -61,6 +70,8 @@ GlidePolarTest::Init()
   // MC zero
   polar.mc = 0;
 
+  polar.SetCruiseEfficiency(1);
+
   polar.SetVMax(Units::ToSysUnit(200, Unit::KILOMETER_PER_HOUR), false);
 }
 
@@ -163,6 +174,133 @@ GlidePolarTest::TestMC()
   ok1(equals(polar.GetVBestLD(), 25.830434162));
 }
 
+/**
+ * Compare the closed-form speed to fly with a dense scan of the
+ * MacCready-adjusted glide ratio over ground.
+ */
+void
+GlidePolarTest::TestSpeedToFly()
+{
+  for (double mc = 0; mc <= 4; mc += 1) {
+    polar.SetMC(mc);
+
+    bool success = true;
+    for (double sink = -2; sink <= 3; sink += 0.5) {
+      for (double head_wind = -15; head_wind <= 15; head_wind += 2.5) {
+        auto f = [&](double v) {
+          return (polar.MSinkRate(v) + sink) / (v - head_wind);
+        };
+
+        const double v_min = std::max(1., polar.GetVMin() - head_wind)
+          + head_wind;
+        double f_best = f(v_min);
+        for (double v = v_min; v <= polar.GetVMax(); v += 0.01)
+          f_best = std::min(f_best, f(v));
+
+        const double v_stf = polar.SpeedToFly(sink, head_wind);
+        if (v_stf < v_min - 1e-6 || v_stf > polar.GetVMax() + 1e-6 ||
+            f(v_stf) > f_best + 1e-6)
+          success = false;
+      }
+    }
+
+    ok(success, "speed to fly MC=%.0f", mc);
+  }
+
+  polar.SetMC(0);
+}
+
+/**
+ * Compare the optimal final glide at MC=0 with a dense scan of the
+ * cruise speed.
+ */
+void
+GlidePolarTest::TestOptimiseGlide()
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  polar.SetMC(0);
+  const MacCready mac(settings, polar);
+
+  for (double wind = 0; wind <= 20; wind += 5) {
+    bool success = true;
+    for (double angle = 0; angle < 360; angle += 30) {
+      const SpeedVector wind_vector(Angle::Degrees(angle), wind);
+      const GlideState task(GeoVector(20000, Angle::Zero()), 0, 1000,
+                            wind_vector);
+
+      const GlideResult result = MacCready::Solve(settings, polar, task);
+      if (!result.IsOk()) {
+        success = false;
+        continue;
+      }
+
+      double best = result.height_glide / result.vector.distance;
+      for (double v = polar.GetVMin(); v <= polar.GetVMax(); v += 0.05) {
+        const GlideResult r = mac.SolveGlide(task, v);
+        if (r.IsOk() && r.vector.distance > 0)
+          best = std::min(best, r.height_glide / r.vector.distance);
+      }
+
+      if (result.height_glide / result.vector.distance > best * 1.001)
+        success = false;
+    }
+
+    ok(success, "optimise glide wind=%.0f", wind);
+  }
+}
+
+/**
+ * Compare the batch glide solver with individual SolveStraight()
+ * calls.
+ */
+void
+GlidePolarTest::TestSolveStraightBatch()
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  constexpr unsigned n = 96;
+  double distance[n], altitude_difference[n], arrival[n];
+  Angle bearing[n];
+  bool valid[n];
+
+  for (unsigned i = 0; i < n; ++i) {
+    distance[i] = (i % 8) * 10000;
+    bearing[i] = Angle::Degrees(i * 15);
+    altitude_difference[i] = (i % 5) * 400. - 200;
+  }
+
+  for (double mc = 0; mc <= 2; mc += 2) {
+    polar.SetMC(mc);
+    const MacCready mac(settings, polar);
+
+    for (double wind = 0; wind <= 30; wind += 15) {
+      const SpeedVector wind_vector(Angle::Degrees(40), wind);
+
+      mac.SolveStraight(wind_vector, n, distance, bearing,
+                        altitude_difference, arrival, valid);
+
+      bool success = true;
+      for (unsigned i = 0; i < n; ++i) {
+        const GlideState task(GeoVector(distance[i], bearing[i]), 0,
+                              altitude_difference[i], wind_vector);
+        const GlideResult result = mac.SolveStraight(task);
+
+        if (valid[i] != result.IsOk() ||
+            (valid[i] && fabs(arrival[i] - result.pure_glide_altitude_difference)
+             > 0.5))
+          success = false;
+      }
+
+      ok(success, "batch glide MC=%.0f wind=%.0f", mc, wind);
+    }
+  }
+
+  polar.SetMC(0);
+}
+
 void
 GlidePolarTest::Run()
 {
@@ -171,11 +309,14 @@ GlidePolarTest::Run()
   TestBallast();
   TestBugs();
   TestMC();
+  TestSpeedToFly();
+  TestOptimiseGlide();
+  TestSolveStraightBatch();
 }
 
 int main(int argc, char **argv)
 {
-  plan_tests(46);
+  plan_tests(62);
 
   GlidePolarTest test;
   test.Run();
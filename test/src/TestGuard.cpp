@@ -0,0 +1,79 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Thread/Guard.hpp"
+#include "Thread/Thread.hpp"
+#include "TestUtil.hpp"
+
+class LeaseThread final : public Thread {
+  Guard<unsigned> &guard;
+
+public:
+  explicit LeaseThread(Guard<unsigned> &_guard):guard(_guard) {}
+
+protected:
+  void Run() override {
+    Guard<unsigned>::ExclusiveLease lease(guard);
+    ++(unsigned &)lease;
+  }
+};
+
+static void
+TestGuardWaits()
+{
+  unsigned value = 0;
+  Guard<unsigned> guard(value);
+
+  {
+    Guard<unsigned>::Lease a(guard), b(guard);
+  }
+
+  {
+    Guard<unsigned>::ExclusiveLease lease(guard);
+  }
+
+  ok1(guard.GetSharedWaits() == 0);
+  ok1(guard.GetExclusiveWaits() == 0);
+
+  LeaseThread thread(guard);
+
+  {
+    /* the thread cannot obtain its lease while this one exists */
+    Guard<unsigned>::Lease lease(guard);
+    thread.Start();
+    while (guard.GetExclusiveWaits() == 0) {}
+  }
+
+  thread.Join();
+
+  ok1(guard.GetExclusiveWaits() == 1);
+  ok1(value == 1);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(4);
+
+  TestGuardWaits();
+
+  return exit_status();
+}
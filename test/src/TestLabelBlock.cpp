@@ -0,0 +1,111 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Renderer/LabelBlock.hpp"
+#include "Renderer/LabelHistory.hpp"
+#include "TestUtil.hpp"
+
+static constexpr PixelRect
+Rect(int left, int top, int right, int bottom)
+{
+  return PixelRect(left, top, right, bottom);
+}
+
+static void
+TestLabelBlock()
+{
+  LabelBlock block;
+
+  ok1(block.check(Rect(0, 0, 100, 20)));
+  ok1(!block.check(Rect(0, 0, 100, 20)));
+  ok1(!block.check(Rect(50, 10, 150, 30)));
+  ok1(block.check(Rect(101, 0, 200, 20)));
+  ok1(block.check(Rect(1000, 700, 1100, 720)));
+
+  /* shares the grid cells with the first rectangle, but doesn't
+     overlap it */
+  ok1(block.check(Rect(2048, 0, 2148, 20)));
+  ok1(block.check(Rect(0, 2048, 100, 2068)));
+
+  /* negative coordinates */
+  ok1(!block.check(Rect(-50, -10, 10, 5)));
+  ok1(block.check(Rect(-200, -100, -150, -80)));
+  ok1(!block.check(Rect(-180, -90, -170, -85)));
+
+  /* larger than the grid */
+  ok1(!block.check(Rect(-5000, -5000, 5000, 5000)));
+
+  block.reset();
+  ok1(block.check(Rect(-5000, -5000, 5000, 5000)));
+  ok1(!block.check(Rect(50, 10, 150, 30)));
+  ok1(!block.check(Rect(3000, 3000, 3010, 3010)));
+  ok1(!block.check(Rect(-3000, 3000, -2990, 3010)));
+
+  /* more labels than it can remember */
+  block.reset();
+  bool all = true;
+  for (int i = 0; i < 4000; ++i) {
+    const int x = (i % 100) * 20, y = (i / 100) * 20;
+    if (!block.check(Rect(x, y, x + 10, y + 10)))
+      all = false;
+  }
+
+  ok1(all);
+  ok1(!block.check(Rect(0, 0, 10, 10)));
+}
+
+static void
+TestLabelHistory()
+{
+  const int a = 0, b = 0, c = 0;
+
+  LabelHistory history;
+  ok1(!history.WasPlaced(&a));
+
+  history.Placed(&b);
+  history.Placed(&a);
+  ok1(!history.WasPlaced(&a));
+
+  history.Commit();
+  ok1(history.WasPlaced(&a));
+  ok1(history.WasPlaced(&b));
+  ok1(!history.WasPlaced(&c));
+
+  history.Placed(&c);
+  history.Commit();
+  ok1(!history.WasPlaced(&a));
+  ok1(history.WasPlaced(&c));
+
+  history.Clear();
+  ok1(!history.WasPlaced(&c));
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(25);
+
+  TestLabelBlock();
+  TestLabelHistory();
+
+  return exit_status();
+}
@@ -27,7 +27,17 @@
 #include "Engine/Task/Ordered/Points/StartPoint.hpp"
 #include "Engine/Task/Ordered/Points/FinishPoint.hpp"
 #include "Engine/Task/Ordered/Points/ASTPoint.hpp"
+#include "Engine/Task/Ordered/Points/AATPoint.hpp"
+#include "Engine/Task/Ordered/AATIsolineSegment.hpp"
 #include "Engine/Task/ObservationZones/LineSectorZone.hpp"
+#include "Engine/Task/ObservationZones/CylinderZone.hpp"
+#include "Engine/Task/ObservationZones/AnnularSectorZone.hpp"
+#include "Engine/Task/ObservationZones/KeyholeZone.hpp"
+#include "Engine/Task/ObservationZones/SymmetricSectorZone.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMin.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMax.hpp"
+#include "Engine/Task/Solvers/TaskOptTargets.hpp"
+#include "Engine/Task/Solvers/TaskMacCreadyRemaining.hpp"
 
 #define ACCURACY 500
 
@@ -407,6 +417,252 @@ TestLowTPFinal()
   CheckTotal(aircraft, stats, tp1, tp2, tp3);
 }
 
+/**
+ * Optimise the targets of a 6 point AAT task in wind.
+ */
+static void
+TestOptTargets()
+{
+  const GlidePolar polar(1);
+
+  OrderedTask task(task_behaviour);
+  const StartPoint start(new LineSectorZone(wp1->location),
+                         WaypointPtr(wp1), task_behaviour,
+                         ordered_task_settings.start_constraints);
+  task.Append(start);
+  for (const auto &wp : {wp2, wp3, wp4, wp5}) {
+    const AATPoint tp(new CylinderZone(wp->location, 20000),
+                      WaypointPtr(wp), task_behaviour);
+    task.Append(tp);
+  }
+  const FinishPoint finish(new LineSectorZone(wp1->location),
+                           WaypointPtr(wp1), task_behaviour,
+                           ordered_task_settings.finish_constraints, false);
+  task.Append(finish);
+  task.UpdateGeometry();
+
+  ok1(task.CheckTask());
+
+  AircraftState aircraft;
+  aircraft.Reset();
+  aircraft.location = MakeGeoPoint(0, 44.9);
+  aircraft.altitude = 1500;
+  aircraft.wind = SpeedVector(Angle::Degrees(80), 12);
+  task.Update(aircraft, aircraft, polar);
+
+  std::vector<OrderedTaskPoint *> points;
+  for (unsigned i = 0; i < task.TaskSize(); ++i)
+    points.push_back(&task.GetPoint(i));
+  StartPoint *tp_start = (StartPoint *)points.front();
+
+  TaskMacCreadyRemaining tm(points.cbegin(), points.cend(), 0,
+                            task_behaviour.glide, polar, false);
+  const auto before = tm.glide_solution(aircraft).time_elapsed;
+
+  TaskOptTargets opt(points, 0, aircraft, task_behaviour.glide, polar,
+                     task.GetTaskProjection(), tp_start);
+  ok1(equals(opt.GetTimeElapsed(), before));
+
+  ok1(opt.Search());
+  const auto after = opt.GetTimeElapsed();
+  ok1(after < before);
+
+  /* the targets have been applied to the task */
+  ok1(equals(tm.glide_solution(aircraft).time_elapsed, after));
+
+  bool inside = true;
+  for (unsigned i = 1; i + 1 < points.size(); ++i) {
+    const AATPoint &ap = (const AATPoint &)*points[i];
+    inside &= ap.GetObservationZone().IsInSector(ap.GetTargetLocation());
+  }
+  ok1(inside);
+}
+
+static bool
+SameSegment(const AATIsolineSegment &a, const AATIsolineSegment &b)
+{
+  return a.Parametric(0) == b.Parametric(0) &&
+    a.Parametric(1) == b.Parametric(1);
+}
+
+static void
+TestIsolineMemento()
+{
+  OrderedTask task(task_behaviour);
+  const StartPoint start(new LineSectorZone(wp1->location),
+                         WaypointPtr(wp1), task_behaviour,
+                         ordered_task_settings.start_constraints);
+  task.Append(start);
+  const AATPoint tp(new CylinderZone(wp3->location, 20000),
+                    WaypointPtr(wp3), task_behaviour);
+  task.Append(tp);
+  const FinishPoint finish(new LineSectorZone(wp4->location),
+                           WaypointPtr(wp4), task_behaviour,
+                           ordered_task_settings.finish_constraints, false);
+  task.Append(finish);
+  task.UpdateGeometry();
+
+  AATPoint &ap = (AATPoint &)task.GetPoint(1);
+  const FlatProjection &projection = task.GetTaskProjection();
+
+  const AATIsolineSegment first(ap, projection);
+  ok1(first.IsValid());
+
+  /* unchanged geometry: the saved segment is reused */
+  ok1(SameSegment(AATIsolineSegment(ap, projection), first));
+
+  /* a new target is a new key, and the segment is searched again */
+  ap.SetTarget(MakeGeoPoint(0.1, 46.05), true);
+  const AATIsolineSegment moved(ap, projection);
+  ok1(!SameSegment(moved, first));
+
+  task.UpdateGeometry();
+  ok1(SameSegment(AATIsolineSegment(ap, projection), moved));
+
+  /* modifying the observation zone discards the saved segment */
+  ((CylinderZone &)ap.GetObservationZone()).SetRadius(10000);
+  task.UpdateGeometry();
+  const AATIsolineSegment shrunk(ap, projection);
+  ok1(shrunk.IsValid());
+  ok1(!SameSegment(shrunk, moved));
+
+  /* a reader with another projection (e.g. the map's) searches its
+     own segment, and neither uses nor replaces the saved one */
+  const AATPoint &const_ap = ap;
+  const GeoPoint &previous = ap.GetPrevious()->GetLocationRemaining();
+  const GeoPoint &next = ap.GetNext()->GetLocationRemaining();
+  const FlatProjection other_projection(MakeGeoPoint(0.5, 45.5));
+  double t_up, t_down;
+
+  const AATIsolineSegment other(const_ap, other_projection);
+  ok1(other.IsValid());
+  ok1(!const_ap.GetIsolineMemento().Lookup(previous, next,
+                                           ap.GetTargetLocation(),
+                                           other_projection, t_up, t_down));
+  ok1(const_ap.GetIsolineMemento().Lookup(previous, next,
+                                          ap.GetTargetLocation(),
+                                          projection, t_up, t_down));
+  ok1(SameSegment(AATIsolineSegment(const_ap, projection), shrunk));
+
+  /* after a change, the calculation thread saves the segment during
+     UpdateIdle(), and the renderers' lookups hit again */
+  ((CylinderZone &)ap.GetObservationZone()).SetRadius(15000);
+  task.UpdateGeometry();
+  ok1(!const_ap.GetIsolineMemento().Lookup(previous, next,
+                                           ap.GetTargetLocation(),
+                                           projection, t_up, t_down));
+
+  AircraftState aircraft;
+  aircraft.Reset();
+  aircraft.location = wp1->location;
+  aircraft.altitude = 1000;
+  task.UpdateIdle(aircraft, glide_polar);
+  ok1(const_ap.GetIsolineMemento().Lookup(previous, next,
+                                          ap.GetTargetLocation(),
+                                          projection, t_up, t_down));
+}
+
+/**
+ * The length of the path through the solutions of a search.
+ */
+static double
+GetSolutionDistance(const TaskDijkstra &dijkstra, unsigned n)
+{
+  double distance = 0;
+  for (unsigned i = 1; i < n; ++i)
+    distance += dijkstra.GetSolution(i - 1).GetLocation()
+      .Distance(dijkstra.GetSolution(i).GetLocation());
+  return distance;
+}
+
+/**
+ * Check the minimum and maximum distance found by the task, which
+ * searches the coarse boundary points and refines the solution along
+ * the arcs, against a search over all boundary points.
+ */
+static void
+CheckRefinedDistances(OrderedTask &task, const GeoPoint &location)
+{
+  task.UpdateGeometry();
+  ok1(task.CheckTask());
+
+  AircraftState aircraft;
+  aircraft.Reset();
+  aircraft.location = location;
+  aircraft.altitude = 2000;
+  task.Update(aircraft, aircraft, glide_polar);
+
+  const unsigned n = task.TaskSize();
+  const TaskStats &stats = task.GetStats();
+
+  TaskDijkstraMax dijkstra_max;
+  dijkstra_max.SetTaskSize(n);
+  for (unsigned i = 0; i < n; ++i)
+    dijkstra_max.SetBoundary(i, task.GetPoint(i).GetBoundaryPoints());
+  ok1(dijkstra_max.DistanceMax());
+  const double dense_max = GetSolutionDistance(dijkstra_max, n);
+
+  TaskDijkstraMin dijkstra_min;
+  dijkstra_min.SetTaskSize(n);
+  for (unsigned i = 0; i < n; ++i)
+    dijkstra_min.SetBoundary(i, task.GetPoint(i).GetBoundaryPoints());
+  ok1(dijkstra_min.DistanceMin(SearchPoint(location,
+                                           task.GetTaskProjection())));
+  const double dense_min = GetSolutionDistance(dijkstra_min, n);
+
+  diag("max: dense %.0f m, refined %.0f m; min: dense %.0f m, refined %.0f m",
+       dense_max, stats.distance_max, dense_min, stats.distance_min);
+
+  /* the refined optimum is at least as good as the dense one */
+  ok1(stats.distance_max >= dense_max - 1);
+  ok1(stats.distance_min <= dense_min + 1);
+}
+
+static void
+TestRefinedBoundary()
+{
+  const GeoPoint location = MakeGeoPoint(0.5, 44.8);
+
+  {
+    /* AAT with a cylinder and an annular sector */
+    OrderedTask task(task_behaviour);
+    task.Append(StartPoint(new LineSectorZone(wp1->location),
+                           WaypointPtr(wp1), task_behaviour,
+                           ordered_task_settings.start_constraints));
+    task.Append(AATPoint(new CylinderZone(wp3->location, 20000),
+                         WaypointPtr(wp3), task_behaviour));
+    task.Append(AATPoint(new AnnularSectorZone(wp4->location, 30000,
+                                               Angle::Degrees(180),
+                                               Angle::Degrees(360),
+                                               10000),
+                         WaypointPtr(wp4), task_behaviour));
+    task.Append(FinishPoint(new LineSectorZone(wp1->location),
+                            WaypointPtr(wp1), task_behaviour,
+                            ordered_task_settings.finish_constraints,
+                            false));
+    CheckRefinedDistances(task, location);
+  }
+
+  {
+    /* racing task with keyhole and FAI sectors; a finish cylinder
+       would have its radius subtracted from the maximum distance */
+    OrderedTask task(task_behaviour);
+    task.Append(StartPoint(new LineSectorZone(wp1->location),
+                           WaypointPtr(wp1), task_behaviour,
+                           ordered_task_settings.start_constraints));
+    task.Append(ASTPoint(KeyholeZone::CreateDAeCKeyholeZone(wp3->location),
+                         WaypointPtr(wp3), task_behaviour, true));
+    task.Append(ASTPoint(SymmetricSectorZone::CreateFAISectorZone(wp4->location,
+                                                                  true),
+                         WaypointPtr(wp4), task_behaviour, true));
+    task.Append(FinishPoint(new LineSectorZone(wp2->location),
+                            WaypointPtr(wp2), task_behaviour,
+                            ordered_task_settings.finish_constraints,
+                            false));
+    CheckRefinedDistances(task, location);
+  }
+}
+
 static void
 TestAll()
 {
@@ -421,7 +677,7 @@ TestAll()
 
 int main(int argc, char **argv)
 {
-  plan_tests(728);
+  plan_tests(756);
 
   task_behaviour.SetDefaults();
 
@@ -436,5 +692,9 @@ int main(int argc, char **argv)
   glide_polar.SetMC(4);
   TestAll();
 
+  TestOptTargets();
+  TestIsolineMemento();
+  TestRefinedBoundary();
+
   return exit_status();
 }
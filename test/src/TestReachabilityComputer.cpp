@@ -0,0 +1,169 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Computer/ReachabilityComputer.hpp"
+#include "Computer/Settings.hpp"
+#include "Task/RoutePlannerGlue.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+static WaypointPtr
+AddWaypoint(Waypoints &waypoints, const GeoPoint &center,
+            double distance, Waypoint::Type type, bool watched=false)
+{
+  Waypoint waypoint(GeoVector(distance, Angle::Zero()).EndPoint(center));
+  waypoint.elevation = 0;
+  waypoint.type = type;
+  if (watched)
+    waypoint.origin = WaypointOrigin::WATCHED;
+  return waypoints.Append(std::move(waypoint));
+}
+
+static double
+GetDirect(const ReachabilityComputer &computer, unsigned id)
+{
+  ProtectedReachabilityCache::Lease lease(computer.GetProtectedCache());
+  const auto *item = lease->Find(id);
+  return item != nullptr ? item->reach.direct : -1;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(13);
+
+  const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+  Waypoints waypoints;
+  const auto near = AddWaypoint(waypoints, center, 5000,
+                                Waypoint::Type::AIRFIELD);
+  const auto far = AddWaypoint(waypoints, center, 20000,
+                               Waypoint::Type::OUTLANDING);
+  const auto turnpoint = AddWaypoint(waypoints, center, 1000,
+                                     Waypoint::Type::NORMAL);
+  const auto watched = AddWaypoint(waypoints, center, 2000,
+                                   Waypoint::Type::NORMAL, true);
+  const auto remote = AddWaypoint(waypoints, center, 300000,
+                                  Waypoint::Type::AIRFIELD);
+  waypoints.Optimise();
+
+  /* only the attributes used by ReachabilityComputer */
+  MoreData basic;
+  basic.clock = 1;
+  basic.location = center;
+  basic.location_available.Update(basic.clock);
+  basic.nav_altitude = 1000;
+  basic.gps_altitude = basic.nav_altitude;
+  basic.gps_altitude_available.Update(basic.clock);
+  basic.baro_altitude_available.Clear();
+
+  DerivedInfo calculated;
+  calculated.wind_available.Clear();
+  calculated.glide_polar_safety = GlidePolar(0);
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.glide.SetDefaults();
+  task_behaviour.route_planner.SetDefaults();
+  task_behaviour.route_planner.reach_polar_mode =
+    RoutePlannerConfig::Polar::SAFETY;
+  task_behaviour.safety_height_arrival = 300;
+
+  PolarSettings polar_settings;
+  polar_settings.glide_polar_task = calculated.glide_polar_safety;
+
+  /* no terrain: all arrival altitudes are calculated directly */
+  const RoutePlannerGlue route_planner;
+
+  ReachabilityComputer computer;
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+
+  {
+    ProtectedReachabilityCache::Lease lease(computer.GetProtectedCache());
+    ok1(lease->size() == 3);
+    ok1(lease->Find(turnpoint->id) == nullptr);
+    ok1(lease->Find(remote->id) == nullptr);
+
+    const auto *item = lease->Find(watched->id);
+    ok1(item != nullptr &&
+        item->reachable == ReachabilityCache::Reachability::TERRAIN);
+  }
+
+  const double near_direct = GetDirect(computer, near->id);
+  const double far_direct = GetDirect(computer, far->id);
+  ok1(near_direct > 0);
+  ok1(far_direct > 0 && far_direct < near_direct);
+
+  /* small changes don't trigger a new calculation */
+  basic.nav_altitude += 1;
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(equals(GetDirect(computer, near->id), near_direct));
+
+  /* climbing above the threshold does */
+  basic.nav_altitude += 20;
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(equals(GetDirect(computer, near->id), near_direct + 21));
+
+  /* so does moving away */
+  basic.location = GeoVector(1000, Angle::HalfCircle()).EndPoint(center);
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(GetDirect(computer, near->id) < near_direct + 21);
+
+  /* a worse polar with the same settings does */
+  const double moved_direct = GetDirect(computer, near->id);
+  PolarCoefficients coefficients =
+    calculated.glide_polar_safety.GetCoefficients();
+  coefficients.c *= 1.5;
+  calculated.glide_polar_safety.SetCoefficients(coefficients);
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(GetDirect(computer, near->id) < moved_direct);
+
+  /* below the safety height, nothing is reachable */
+  basic.nav_altitude = 100;
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  {
+    ProtectedReachabilityCache::Lease lease(computer.GetProtectedCache());
+    ok1(lease->IsEmpty());
+  }
+
+  /* losing the GPS fix clears the cache */
+  basic.nav_altitude = 1000;
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(GetDirect(computer, near->id) > 0);
+
+  basic.location_available.Clear();
+  computer.Update(waypoints, basic, calculated, task_behaviour,
+                  polar_settings, route_planner);
+  ok1(GetDirect(computer, near->id) < 0);
+
+  return exit_status();
+}
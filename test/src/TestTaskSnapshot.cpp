@@ -0,0 +1,87 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Task/ProtectedTaskManager.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "TestUtil.hpp"
+
+static Waypoint
+MakeWaypoint(double longitude, double latitude)
+{
+  Waypoint waypoint(GeoPoint(Angle::Degrees(longitude),
+                             Angle::Degrees(latitude)));
+  waypoint.elevation = 0;
+  return waypoint;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(9);
+
+  Waypoints waypoints;
+  const auto in_database = waypoints.Append(MakeWaypoint(7.7, 51.4));
+  waypoints.Optimise();
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, waypoints);
+  ProtectedTaskManager protected_task_manager(task_manager, task_behaviour);
+
+  /* the initial snapshot describes the (empty) task */
+  const auto empty = protected_task_manager.GetSnapshot();
+  ok1(empty != nullptr);
+  ok1(empty->waypoints.empty());
+
+  /* releasing a writable lease publishes the change */
+  protected_task_manager.DoGoto(in_database);
+  const auto first = protected_task_manager.GetSnapshot();
+  ok1(first->waypoints.size() == 1);
+  ok1(first->waypoints.front() == in_database);
+
+  /* a waypoint which is not in the database, like the takeoff point
+     of a "goto" task, is still in the snapshot */
+  const WaypointPtr takeoff(new Waypoint(MakeWaypoint(7.8, 51.5)));
+  {
+    ProtectedTaskManager::ExclusiveLease lease(protected_task_manager);
+    lease->DoGoto(WaypointPtr(takeoff));
+  }
+
+  const auto second = protected_task_manager.GetSnapshot();
+  ok1(second->waypoints.size() == 1);
+  ok1(second->waypoints.front() == takeoff);
+
+  /* a snapshot is never modified after it was published */
+  ok1(first->waypoints.front() == in_database);
+  ok1(empty->waypoints.empty());
+
+  /* a read-only lease does not publish a new snapshot */
+  {
+    ProtectedTaskManager::Lease lease(protected_task_manager);
+  }
+  ok1(protected_task_manager.GetSnapshot() == second);
+
+  return exit_status();
+}
@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Util/TrigramIndex.hpp"
+#include "Util/StringAPI.hxx"
+#include "TestUtil.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+
+typedef std::vector<TrigramIndex::Match> MatchList;
+
+static bool
+Equals(const MatchList &matches, std::initializer_list<unsigned> ids,
+       unsigned errors)
+{
+  if (matches.size() != ids.size())
+    return false;
+
+  auto i = matches.begin();
+  for (const unsigned id : ids) {
+    if (i->id != id || i->errors != errors)
+      return false;
+    ++i;
+  }
+
+  return true;
+}
+
+static bool
+Equals(const MatchList &a, const MatchList &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (a[i].id != b[i].id || a[i].errors != b[i].errors)
+      return false;
+
+  return true;
+}
+
+static void
+TestSearch()
+{
+  TrigramIndex index;
+  index.Add(_T("Aachen Merzbrueck"));
+  index.Add(_T("Merzhausen"));
+  index.Add(_T("Bad Merzig"));
+  index.Add(_T(""));
+  index.Add(_T("ab"));
+  index.Add(_T("Xyz-123"));
+  index.Build();
+
+  ok1(index.size() == 6);
+  ok1(StringIsEqual(index.GetNormalised(0), _T("AACHENMERZBRUECK")));
+  ok1(StringIsEqual(index.GetNormalised(5), _T("XYZ123")));
+
+  MatchList matches;
+  index.Search(_T("merz"), 0, matches);
+  ok1(Equals(matches, {0, 1, 2}, 0));
+
+  index.Search(_T("M-E-R-Z"), 0, matches);
+  ok1(Equals(matches, {0, 1, 2}, 0));
+
+  index.Search(_T("z-123"), 0, matches);
+  ok1(Equals(matches, {5}, 0));
+
+  /* shorter than a trigram */
+  index.Search(_T("ab"), 0, matches);
+  ok1(Equals(matches, {4}, 0));
+
+  index.Search(_T(""), 2, matches);
+  ok1(matches.empty());
+
+  /* one deleted character */
+  index.Search(_T("merzhasen"), 0, matches);
+  ok1(matches.empty());
+  index.Search(_T("merzhasen"), 1, matches);
+  ok1(Equals(matches, {1}, 1));
+
+  /* one replaced character */
+  index.Search(_T("bad merzog"), 1, matches);
+  ok1(Equals(matches, {2}, 1));
+}
+
+static std::basic_string<TCHAR>
+RandomString(unsigned alphabet_size, unsigned length)
+{
+  static const TCHAR alphabet[] = _T("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
+
+  std::basic_string<TCHAR> s;
+  for (unsigned i = 0; i < length; ++i)
+    s.push_back(alphabet[rand() % alphabet_size]);
+  return s;
+}
+
+/**
+ * Compare Search() with Scan() on random strings: a small alphabet
+ * produces many matches, a large one sparse posting lists with
+ * multi-byte deltas.
+ */
+static void
+TestRandom(unsigned alphabet_size)
+{
+  TrigramIndex index;
+  std::vector<std::basic_string<TCHAR>> strings;
+  for (unsigned i = 0; i < 3000; ++i) {
+    strings.push_back(RandomString(alphabet_size, 4 + rand() % 16));
+    index.Add(strings.back().c_str());
+  }
+
+  index.Build();
+
+  for (unsigned max_errors = 0; max_errors <= 2; ++max_errors) {
+    bool equal = true;
+    for (unsigned i = 0; i < 200; ++i) {
+      /* a substring of an indexed string, with one character
+         replaced */
+      std::basic_string<TCHAR> query = strings[rand() % strings.size()];
+      query = query.substr(rand() % 3, 3 + rand() % 6);
+      query[rand() % query.length()] = RandomString(alphabet_size, 1)[0];
+
+      MatchList search, scan;
+      index.Search(query.c_str(), max_errors, search);
+      index.Scan(query.c_str(), max_errors, scan);
+      if (!Equals(search, scan))
+        equal = false;
+    }
+
+    ok1(equal);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(17);
+
+  srand(42);
+
+  TestSearch();
+  TestRandom(4);
+  TestRandom(36);
+
+  return exit_status();
+}
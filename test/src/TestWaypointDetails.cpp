@@ -0,0 +1,196 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/WaypointDetailsReader.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Path.hpp"
+#include "Operation/Operation.hpp"
+#include "Util/StaticString.hxx"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+
+static const char details_file[] =
+  "ignored text before the first section\n"
+  "[Aachen]\n"
+  "Runway 07/25\n"
+  "\n"
+  "image=aachen.png\n"
+  "file=aachen.pdf\n"
+  "[Bonn]\n"
+  "Tower 118.0\n"
+  "[Nowhere]\n"
+  "No such waypoint\n"
+  "[ST GOAR]\n"
+  "Ferry\n"
+  "[koeln]\n"
+  "Line 1\n"
+  "Line 2";
+
+static bool
+WriteFile(Path path, const char *contents)
+{
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+
+  fputs(contents, file);
+  return fclose(file) == 0;
+}
+
+static void
+AddWaypoint(Waypoints &waypoints, const TCHAR *name)
+{
+  Waypoint wp(GeoPoint(Angle::Degrees(7), Angle::Degrees(50)));
+  wp.name = name;
+  waypoints.Append(std::move(wp));
+}
+
+static void
+MakeWaypoints(Waypoints &waypoints)
+{
+  AddWaypoint(waypoints, _T("Aachen"));
+  AddWaypoint(waypoints, _T("Bonn AF"));
+  AddWaypoint(waypoints, _T("Koeln AD"));
+  AddWaypoint(waypoints, _T("Duesseldorf"));
+  AddWaypoint(waypoints, _T("St. Goar"));
+  /* no " AD" suffix: this is not "[Bonn]" */
+  AddWaypoint(waypoints, _T("BonnAD"));
+  waypoints.Optimise();
+}
+
+static bool
+EqualDetails(const AirfieldDetails &a, const AirfieldDetails &b)
+{
+  return a.details == b.details && a.files_embed == b.files_embed &&
+    a.files_external == b.files_external;
+}
+
+static void
+TestDetails(Path path)
+{
+  NullOperationEnvironment operation;
+
+  Waypoints eager;
+  MakeWaypoints(eager);
+  {
+    FileLineReader reader(path, Charset::AUTO);
+    WaypointDetails::ReadFile(reader, eager, operation);
+  }
+
+  const auto aachen = eager.LookupName(_T("Aachen"));
+  ok1(aachen->details == _T("Runway 07/25\n"));
+  ok1(!aachen->files_embed.empty() &&
+      aachen->files_embed.front() == _T("aachen.png"));
+  ok1(eager.LookupName(_T("Bonn AF"))->details == _T("Tower 118.0\n"));
+  ok1(eager.LookupName(_T("Koeln AD"))->details == _T("Line 1\nLine 2\n"));
+  /* case and punctuation are ignored */
+  ok1(eager.LookupName(_T("St. Goar"))->details == _T("Ferry\n"));
+
+  WaypointDetails::Index index;
+  FileLineReader reader(path, Charset::AUTO);
+  WaypointDetails::IndexFile(reader, index, operation);
+  ok1(index.size() == 5);
+
+  Waypoints lazy;
+  MakeWaypoints(lazy);
+  ok1(lazy.LookupName(_T("Aachen"))->details.empty());
+
+  for (const auto &wp : lazy) {
+    AirfieldDetails details;
+    const bool found = WaypointDetails::LoadIndexed(reader, index, *wp,
+                                                    details);
+    ok1(found == (wp->name != _T("Duesseldorf") &&
+                  wp->name != _T("BonnAD")));
+    ok1(EqualDetails(details, AirfieldDetails(*eager.LookupName(wp->name))));
+  }
+
+  /* the waypoints in the database are not modified */
+  ok1(lazy.LookupName(_T("Aachen"))->details.empty());
+}
+
+/**
+ * A file which is larger than the reader's buffer, so the positions
+ * recorded by IndexFile() must account for data which was read
+ * ahead.
+ */
+static void
+TestLargeFile(Path path)
+{
+  constexpr unsigned N = 2000;
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    skip(2, 0, "Failed to create file");
+    return;
+  }
+
+  for (unsigned i = 0; i < N; ++i)
+    fprintf(file, "[WP%u]\nDetails of waypoint %u\nimage=%u.png\n", i, i, i);
+  fclose(file);
+
+  Waypoints waypoints;
+  for (unsigned i = 0; i < N; ++i) {
+    StaticString<32> name;
+    name.Format(_T("WP%u"), i);
+    AddWaypoint(waypoints, name);
+  }
+  waypoints.Optimise();
+
+  NullOperationEnvironment operation;
+  WaypointDetails::Index index;
+  FileLineReader reader(path, Charset::AUTO);
+  WaypointDetails::IndexFile(reader, index, operation);
+  ok1(index.size() == N);
+
+  unsigned n_correct = 0;
+  for (unsigned i = N; i-- > 0;) {
+    StaticString<32> name, expected;
+    name.Format(_T("WP%u"), i);
+    expected.Format(_T("Details of waypoint %u\n"), i);
+
+    const auto wp = waypoints.LookupName(name);
+    AirfieldDetails details;
+    if (WaypointDetails::LoadIndexed(reader, index, *wp, details) &&
+        details.details == expected.c_str() &&
+        !details.files_embed.empty())
+      ++n_correct;
+  }
+
+  ok1(n_correct == N);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(22);
+
+  const Path path("output/TestWaypointDetails.txt");
+  if (!WriteFile(path, details_file)) {
+    skip(20, 0, "Failed to create file");
+  } else
+    TestDetails(path);
+
+  TestLargeFile(path);
+
+  return exit_status();
+}
@@ -0,0 +1,196 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/CupWriter.hpp"
+#include "Waypoint/WaypointJournal.hpp"
+#include "Waypoint/Factory.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "IO/FileLineReader.hpp"
+#include "OS/Path.hpp"
+#include "Util/tstring.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+static const Path path("output/TestWaypointJournal.txt");
+
+static Waypoint
+MakeWaypoint(const TCHAR *name, double latitude, double longitude,
+             WaypointOrigin origin=WaypointOrigin::USER)
+{
+  Waypoint wp(GeoPoint(Angle::Degrees(longitude), Angle::Degrees(latitude)));
+  wp.name = name;
+  wp.origin = origin;
+  wp.elevation = 100;
+  return wp;
+}
+
+static std::vector<tstring>
+ReadLines()
+{
+  std::vector<tstring> lines;
+  FileLineReader reader(path);
+  TCHAR *line;
+  while ((line = reader.ReadLine()) != nullptr)
+    lines.emplace_back(line);
+  return lines;
+}
+
+static void
+TestFormat()
+{
+  Waypoint airfield = MakeWaypoint(_T("Bergneustadt"), 51.05, 7.7);
+  airfield.type = Waypoint::Type::AIRFIELD;
+  airfield.elevation = 488;
+  airfield.runway.SetDirectionDegrees(40);
+  airfield.runway.SetLength(590);
+  airfield.radio_frequency = RadioFrequency::Parse(_T("123.650"));
+  airfield.comment = _T("Foo");
+
+  Waypoint turnpoint = MakeWaypoint(_T("Somewhere"), -33.5, -70.25);
+  turnpoint.elevation = -5;
+
+  {
+    FileOutputStream file(path);
+    BufferedOutputStream writer(file);
+    WriteCup(writer, airfield);
+    WriteCup(writer, turnpoint);
+    writer.Flush();
+    file.Commit();
+  }
+
+  const auto lines = ReadLines();
+  ok1(lines.size() == 2);
+  ok1(lines.size() > 0 &&
+      lines[0] == _T("\"Bergneustadt\",,,5103.000N,00742.000E,488M,2,040,590M,\"123.650\",\"Foo\""));
+  ok1(lines.size() > 1 &&
+      lines[1] == _T("\"Somewhere\",,,3330.000S,07015.000W,-5M,1,,,,\"\""));
+}
+
+static void
+TestBulk()
+{
+  /* the tree's iteration order differs from the id order */
+  Waypoints waypoints;
+  waypoints.Append(MakeWaypoint(_T("A"), 50, 10));
+  waypoints.Append(MakeWaypoint(_T("P"), 48, 8, WaypointOrigin::PRIMARY));
+  waypoints.Append(MakeWaypoint(_T("B"), 45, 5));
+  waypoints.Append(MakeWaypoint(_T("C"), 52, 12));
+  waypoints.Append(MakeWaypoint(_T("D"), 46, 11));
+  waypoints.Optimise();
+
+  {
+    FileOutputStream file(path);
+    BufferedOutputStream writer(file);
+    WriteCup(writer, waypoints, WaypointOrigin::USER);
+    writer.Flush();
+    file.Commit();
+  }
+
+  const auto lines = ReadLines();
+  ok1(lines.size() == 4);
+
+  const TCHAR *const expected[] = { _T("\"A\""), _T("\"B\""), _T("\"C\""), _T("\"D\"") };
+  bool ordered = lines.size() == 4;
+  for (unsigned i = 0; ordered && i < 4; ++i)
+    ordered = lines[i].compare(0, 3, expected[i]) == 0;
+  ok1(ordered);
+}
+
+static unsigned
+Replay(Waypoints &waypoints)
+{
+  FileLineReader reader(path);
+  const unsigned n =
+    ReplayWaypointJournal(waypoints, reader,
+                          WaypointFactory(WaypointOrigin::USER));
+  waypoints.Optimise();
+  return n;
+}
+
+static void
+TestJournal()
+{
+  Waypoints waypoints;
+  waypoints.Append(MakeWaypoint(_T("A"), 50, 10));
+  waypoints.Append(MakeWaypoint(_T("B"), 51, 11));
+  waypoints.Append(MakeWaypoint(_T("P"), 52, 12, WaypointOrigin::PRIMARY));
+  waypoints.Optimise();
+
+  const Waypoint b2 = MakeWaypoint(_T("B2"), 51, 11);
+  const Waypoint p2 = MakeWaypoint(_T("P2"), 52, 12);
+
+  {
+    FileOutputStream file(path);
+    BufferedOutputStream writer(file);
+    WriteJournalRecord(writer, WaypointJournalRecord::ADD,
+                       MakeWaypoint(_T("C"), 49, 9));
+    WriteJournalRecord(writer, WaypointJournalRecord::REMOVE,
+                       *waypoints.LookupName(_T("A")));
+    WriteJournalRecord(writer, WaypointJournalRecord::REMOVE,
+                       *waypoints.LookupName(_T("B")));
+    WriteJournalRecord(writer, WaypointJournalRecord::ADD, b2);
+    /* removing a non-user waypoint has no effect */
+    WriteJournalRecord(writer, WaypointJournalRecord::REMOVE,
+                       *waypoints.LookupName(_T("P")));
+    WriteJournalRecord(writer, WaypointJournalRecord::ADD, p2);
+    /* a damaged record */
+    writer.Write("+\"Partial\",,,52");
+    writer.Flush();
+    file.Commit();
+  }
+
+  ok1(Replay(waypoints) == 6);
+  ok1(waypoints.size() == 4);
+  ok1(waypoints.LookupName(_T("A")) == nullptr);
+  ok1(waypoints.LookupName(_T("B")) == nullptr);
+  ok1(waypoints.LookupName(_T("B2")) != nullptr);
+  ok1(waypoints.LookupName(_T("C")) != nullptr);
+  ok1(waypoints.LookupName(_T("P")) != nullptr);
+  ok1(waypoints.LookupName(_T("P2")) != nullptr);
+  ok1(waypoints.LookupName(_T("Partial")) == nullptr);
+
+  /* replaying again after the journal was merged changes nothing */
+  Replay(waypoints);
+  ok1(waypoints.size() == 4);
+
+  /* at startup, the journal is replayed before Optimise() */
+  Waypoints loading;
+  loading.Append(MakeWaypoint(_T("A"), 50, 10));
+  loading.Append(MakeWaypoint(_T("B"), 51, 11));
+  loading.Append(MakeWaypoint(_T("P"), 52, 12, WaypointOrigin::PRIMARY));
+  ok1(Replay(loading) == 6);
+  ok1(loading.size() == 4 && loading.LookupName(_T("A")) == nullptr);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(17);
+
+  TestFormat();
+  TestBulk();
+  TestJournal();
+
+  return exit_status();
+}
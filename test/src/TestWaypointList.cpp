@@ -0,0 +1,233 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/WaypointList.hpp"
+#include "Waypoint/WaypointListBuilder.hpp"
+#include "Waypoint/WaypointFilter.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+#include <functional>
+
+static const GeoPoint center(Angle::Degrees(7.85), Angle::Degrees(51.4));
+
+/**
+ * Add 151 waypoints on a spiral around the center, 1 km further out
+ * each.
+ */
+static void
+AddSpiralWaypoints(Waypoints &waypoints)
+{
+  for (unsigned i = 0; i <= 150; ++i) {
+    Waypoint waypoint(GeoVector(i * 1000, Angle::Degrees(i * 15))
+                      .EndPoint(center));
+    waypoint.original_id = i;
+
+    StaticString<64> buffer;
+    if (i % 3 == 0) {
+      buffer.Format(_T("Field #%u"), i);
+      waypoint.type = Waypoint::Type::OUTLANDING;
+    } else
+      buffer.Format(_T("Waypoint #%u"), i);
+    waypoint.name = buffer;
+
+    waypoints.Append(std::move(waypoint));
+  }
+
+  waypoints.Optimise();
+}
+
+static WaypointFilter
+MakeFilter(const TCHAR *name, double distance)
+{
+  WaypointFilter filter;
+  filter.Clear();
+  filter.name = name;
+  filter.distance = distance;
+  return filter;
+}
+
+static void
+Build(WaypointList &list, const Waypoints &waypoints,
+      const WaypointFilter &filter)
+{
+  list.clear();
+  WaypointListBuilder builder(filter, center, list, nullptr, 0);
+  builder.Visit(waypoints);
+}
+
+/**
+ * Are the first #n items of both lists the same waypoints?
+ */
+static bool
+EqualPrefix(const WaypointList &a, const WaypointList &b, unsigned n)
+{
+  if (a.size() < n || b.size() < n)
+    return false;
+
+  for (unsigned i = 0; i < n; ++i)
+    if (a[i].waypoint != b[i].waypoint)
+      return false;
+
+  return true;
+}
+
+static bool
+Equal(const WaypointList &a, const WaypointList &b)
+{
+  return a.size() == b.size() && EqualPrefix(a, b, a.size());
+}
+
+static void
+TestPartialSort(const Waypoints &waypoints)
+{
+  const WaypointFilter filter = MakeFilter(_T(""), 200000);
+
+  WaypointList full;
+  Build(full, waypoints, filter);
+  ok1(full.size() == 151);
+  full.SortByDistance(center);
+
+  WaypointList partial;
+  Build(partial, waypoints, filter);
+  partial.PartialSortByDistance(center, 10);
+  ok1(EqualPrefix(partial, full, 10));
+
+  partial.SortUpTo(50);
+  ok1(EqualPrefix(partial, full, 50));
+
+  /* erasing keeps the sorted part sorted */
+  const std::function<bool(const WaypointListItem &)> is_odd =
+    [](const WaypointListItem &item){
+      return item.waypoint->original_id % 2 == 1;
+    };
+  partial.EraseIf(is_odd);
+  full.EraseIf(is_odd);
+  ok1(partial.size() == 76);
+
+  partial.SortUpTo(partial.size());
+  ok1(Equal(partial, full));
+}
+
+static void
+TestNarrow(const Waypoints &waypoints, double distance)
+{
+  const WaypointFilter broad = MakeFilter(_T("Fie"), distance);
+  const WaypointFilter narrow = MakeFilter(_T("field #1"), distance);
+
+  ok1(narrow.IsSubsetOf(broad));
+  ok1(!broad.IsSubsetOf(narrow));
+
+  WaypointList list;
+  Build(list, waypoints, broad);
+  list.PartialSortByDistance(center, 5);
+
+  WaypointListBuilder builder(narrow, center, list, nullptr, 0);
+  builder.Narrow(list);
+  list.SortUpTo(list.size());
+
+  WaypointList expected;
+  Build(expected, waypoints, narrow);
+  expected.SortByDistance(center);
+
+  /* 12, 15, 18 and 102..150 */
+  ok1(expected.size() == 3 + 17);
+  ok1(Equal(list, expected));
+}
+
+static void
+TestTextSearch(const Waypoints &waypoints)
+{
+  /* 121, 122, 124, 125, 127 and 128; the others are fields */
+  WaypointList list;
+  Build(list, waypoints, MakeFilter(_T("point #12"), 0));
+  ok1(list.size() == 6);
+
+  /* too short for the text search */
+  Build(list, waypoints, MakeFilter(_T("#1"), 0));
+  ok1(list.empty());
+
+  const WaypointFilter broad = MakeFilter(_T("poi"), 0);
+  const WaypointFilter narrow = MakeFilter(_T("point #12"), 0);
+  ok1(narrow.IsSubsetOf(broad));
+
+  Build(list, waypoints, broad);
+  ok1(list.size() == 100);
+
+  WaypointListBuilder builder(narrow, center, list, nullptr, 0);
+  builder.Narrow(list);
+  ok1(list.size() == 6);
+
+  /* name prefix matches come first, then the comment matches */
+  Waypoints small;
+  Waypoint alpha(center);
+  alpha.name = _T("Alpha");
+  alpha.comment = _T("next to the big field");
+  small.Append(std::move(alpha));
+  Waypoint field(GeoVector(1000, Angle::Zero()).EndPoint(center));
+  field.name = _T("Field Bravo");
+  small.Append(std::move(field));
+  small.Optimise();
+
+  Build(list, small, MakeFilter(_T("fiel"), 0));
+  ok1(list.size() == 2);
+  ok1(list.size() == 2 && list[0].waypoint->name == _T("Field Bravo") &&
+      list[1].waypoint->name == _T("Alpha"));
+}
+
+static void
+TestSubset()
+{
+  const WaypointFilter a = MakeFilter(_T("AB"), 0);
+
+  ok1(a.IsSubsetOf(a));
+  ok1(a.IsSubsetOf(MakeFilter(_T("a"), 0)));
+  ok1(!a.IsSubsetOf(MakeFilter(_T("ABC"), 0)));
+  ok1(!a.IsSubsetOf(MakeFilter(_T("B"), 0)));
+  ok1(!a.IsSubsetOf(MakeFilter(_T("A"), 10000)));
+
+  /* the text search finds more than the prefix search */
+  ok1(!MakeFilter(_T("ABC"), 0).IsSubsetOf(a));
+  ok1(MakeFilter(_T("ABC"), 10000).IsSubsetOf(MakeFilter(_T("AB"), 10000)));
+
+  WaypointFilter landable = MakeFilter(_T("AB"), 0);
+  landable.type_index = TypeFilter::LANDABLE;
+  ok1(!landable.IsSubsetOf(MakeFilter(_T("A"), 0)));
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(28);
+
+  Waypoints waypoints;
+  AddSpiralWaypoints(waypoints);
+
+  TestPartialSort(waypoints);
+  TestNarrow(waypoints, 0);
+  TestNarrow(waypoints, 200000);
+  TestTextSearch(waypoints);
+  TestSubset();
+
+  return exit_status();
+}
@@ -22,11 +22,13 @@
 
 #include "Waypoint/WaypointReader.hpp"
 #include "Waypoint/WaypointReaderBase.hpp"
+#include "Waypoint/WaypointCache.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Units/System.hpp"
 #include "TestUtil.hpp"
 #include "OS/Path.hpp"
+#include "IO/FileCache.hpp"
 #include "Util/tstring.hpp"
 #include "Util/StringAPI.hxx"
 #include "Util/ExtractParameters.hpp"
@@ -299,6 +301,51 @@ TestSeeYou(wp_vector org_wp)
   }
 }
 
+static void
+TestCache(wp_vector org_wp)
+{
+  const Path path(_T("test/data/waypoints.cup"));
+
+  Waypoints way_points;
+  if (!TestWaypointFile(path, way_points, org_wp.size())) {
+    skip(9 + 10 * org_wp.size(), 0, "opening waypoints.cup failed");
+    return;
+  }
+
+  FileCache cache(AllocatedPath(Path(_T("output/TestWaypointCache"))));
+  ok1(SaveWaypointCache(cache, _T("waypoints"), path, nullptr,
+                        WaypointOrigin::NONE, way_points));
+
+  Waypoints cached;
+  ok1(LoadWaypointCache(cache, _T("waypoints"), path, nullptr,
+                        WaypointOrigin::NONE, cached));
+  cached.Optimise();
+  ok1(cached.size() == org_wp.size());
+
+  for (auto it = org_wp.begin(); it < org_wp.end(); it++) {
+    const auto wp = GetWaypoint(*it, cached);
+    TestSeeYouWaypoint(*it, wp.get());
+  }
+
+  // a cache built without terrain must not be used with terrain
+  const Path terrain_path(_T("test/data/benalla9.xcm"));
+  Waypoints rejected;
+  ok1(!LoadWaypointCache(cache, _T("waypoints"), path, terrain_path,
+                         WaypointOrigin::NONE, rejected));
+  ok1(rejected.IsEmpty());
+
+  // nor with another terrain file than the one it was built with
+  const Path other_terrain_path(_T("test/data/waypoints.wpz"));
+  ok1(SaveWaypointCache(cache, _T("waypoints"), path, terrain_path,
+                        WaypointOrigin::NONE, way_points));
+  ok1(LoadWaypointCache(cache, _T("waypoints"), path, terrain_path,
+                        WaypointOrigin::NONE, rejected));
+  rejected.Clear();
+  ok1(!LoadWaypointCache(cache, _T("waypoints"), path, other_terrain_path,
+                         WaypointOrigin::NONE, rejected));
+  ok1(rejected.IsEmpty());
+}
+
 static void
 TestZanderWaypoint(const Waypoint org_wp, const Waypoint *wp)
 {
@@ -537,12 +584,13 @@ int main(int argc, char **argv)
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(360);
+  plan_tests(422);
 
   TestExtractParameters();
 
   TestWinPilot(org_wp);
   TestSeeYou(org_wp);
+  TestCache(org_wp);
   TestZander(org_wp);
   TestFS(org_wp);
   TestFS_UTM(org_wp);
@@ -23,13 +23,67 @@
 #include "Waypoint/WaypointVisitor.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Geo/GeoVector.hpp"
+#include "Geo/GeoBounds.hpp"
 #include "test_debug.hpp"
 
+#include <algorithm>
 #include <functional>
+#include <initializer_list>
+#include <new>
+#include <vector>
 
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <tchar.h>
 
+/* incremented by each best-first search of Waypoints::VisitNearestIf() */
+extern unsigned n_best_first_searches;
+
+/* count the heap blocks and bytes in use, to report the memory used
+   by the waypoint storage */
+
+struct HeapUsage {
+  size_t blocks, bytes;
+
+  HeapUsage operator-(const HeapUsage &other) const {
+    return {blocks - other.blocks, bytes - other.bytes};
+  }
+};
+
+static HeapUsage heap_usage;
+
+void *
+operator new(size_t size)
+{
+  size_t *p = (size_t *)malloc(sizeof(max_align_t) + size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+
+  *p = size;
+  ++heap_usage.blocks;
+  heap_usage.bytes += size;
+  return (char *)p + sizeof(max_align_t);
+}
+
+void
+operator delete(void *p) noexcept
+{
+  if (p == nullptr)
+    return;
+
+  size_t *q = (size_t *)((char *)p - sizeof(max_align_t));
+  --heap_usage.blocks;
+  heap_usage.bytes -= *q;
+  free(q);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  operator delete(p);
+}
+
 class WaypointPredicateCounter: public WaypointVisitor
 {
 public:
@@ -53,6 +107,16 @@ public:
   }
 };
 
+class WaypointListVisitor: public WaypointVisitor
+{
+public:
+  std::vector<WaypointPtr> list;
+
+  void Visit(const WaypointPtr &wp) override {
+    list.push_back(wp);
+  }
+};
+
 static void
 AddSpiralWaypoints(Waypoints &waypoints,
                    const GeoPoint &center = GeoPoint(Angle::Degrees(51.4),
@@ -188,6 +252,39 @@ TestRangeVisitor(const Waypoints &waypoints, const GeoPoint &center)
   TestRangeVisitor(waypoints, center, 1000000, 151);
 }
 
+static void
+TestBoundsVisitor(const Waypoints &waypoints, const GeoBounds &bounds)
+{
+  unsigned expected_results = 0;
+  for (const auto &wp : waypoints)
+    if (bounds.IsInside(wp->location))
+      ++expected_results;
+
+  WaypointPredicateCounter::Predicate predicate =
+    [&bounds](const Waypoint &wp){ return bounds.IsInside(wp.location); };
+  WaypointPredicateCounter bounds_counter(predicate);
+  waypoints.VisitWithinBounds(bounds, bounds_counter);
+  ok1(bounds_counter.GetCounter() == expected_results);
+}
+
+static void
+TestBoundsVisitor(const Waypoints &waypoints, const GeoPoint &center)
+{
+  const Angle small = Angle::Degrees(0.05), large = Angle::Degrees(1);
+
+  TestBoundsVisitor(waypoints, GeoBounds(center));
+  TestBoundsVisitor(waypoints,
+                    GeoBounds(GeoPoint(center.longitude - small,
+                                       center.latitude + small),
+                              GeoPoint(center.longitude + small,
+                                       center.latitude - small)));
+  TestBoundsVisitor(waypoints,
+                    GeoBounds(GeoPoint(center.longitude,
+                                       center.latitude + large),
+                              GeoPoint(center.longitude + large,
+                                       center.latitude)));
+}
+
 static bool
 OriginalIDAbove5(const Waypoint &waypoint) {
   return waypoint.original_id > 5;
@@ -234,6 +331,204 @@ TestGetNearest(const Waypoints &waypoints, const GeoPoint &center)
   ok1(waypoint->original_id == 6);
 }
 
+static bool
+IsLandable(const Waypoint &waypoint)
+{
+  return waypoint.IsLandable();
+}
+
+/**
+ * Check that the visited waypoints have the given original ids, in
+ * this order.
+ */
+static bool
+HasOriginalIds(const WaypointListVisitor &visitor,
+               std::initializer_list<unsigned> ids)
+{
+  if (visitor.list.size() != ids.size())
+    return false;
+
+  auto i = visitor.list.begin();
+  for (const unsigned id : ids)
+    if ((*i++)->original_id != id)
+      return false;
+
+  return true;
+}
+
+static void
+TestVisitNearest(const Waypoints &waypoints, const GeoPoint &center)
+{
+  WaypointListVisitor nearest;
+  ok1(waypoints.VisitNearest(center, 10000, 5, nearest) == 5);
+  ok1(HasOriginalIds(nearest, {0, 1, 2, 3, 4}));
+
+  WaypointListVisitor landable;
+  ok1(waypoints.VisitNearestIf(center, 100000, 5, IsLandable,
+                               landable) == 5);
+  ok1(HasOriginalIds(landable, {0, 3, 6, 7, 9}));
+
+  /* the range limits the result */
+  WaypointListVisitor in_range;
+  ok1(waypoints.VisitNearest(center, 5500, 20, in_range) == 6);
+
+  WaypointListVisitor none;
+  ok1(waypoints.VisitNearest(center, 10000, 0, none) == 0);
+}
+
+/**
+ * Compare GetNearest() with a linear search at many locations in
+ * and around the spiral.
+ */
+static void
+TestNearestLinear(const Waypoints &waypoints, const GeoPoint &center)
+{
+  const double range = 20000;
+
+  unsigned n_mismatches = 0;
+  for (unsigned i = 0; i < 500; ++i) {
+    const GeoPoint location =
+      GeoVector(i * 400, Angle::Degrees(i * 37)).EndPoint(center);
+
+    double best = range * 2;
+    for (const auto &wp : waypoints)
+      best = std::min(best, location.Distance(wp->location));
+
+    const auto found = waypoints.GetNearest(location, range);
+    if (best < range * 0.95) {
+      if (!found || location.Distance(found->location) > best * 1.01 + 10)
+        ++n_mismatches;
+    } else if (best > range * 1.05 && found)
+      ++n_mismatches;
+  }
+
+  ok1(n_mismatches == 0);
+}
+
+/**
+ * Queries must see a waypoint which was appended after Optimise(),
+ * before and after the next Optimise() call.
+ */
+static void
+TestAppendOptimised(Waypoints &waypoints, const GeoPoint &center)
+{
+  const GeoPoint location =
+    GeoVector(300, Angle::Degrees(90)).EndPoint(center);
+
+  Waypoint waypoint(location);
+  waypoint.name = _T("Appended");
+  waypoints.Append(std::move(waypoint));
+
+  WaypointPtr found = waypoints.GetNearest(location, 100);
+  ok1(found && found->name == _T("Appended"));
+
+  WaypointListVisitor nearest;
+  ok1(waypoints.VisitNearest(location, 5000, 3, nearest) == 3 &&
+      nearest.list.front()->name == _T("Appended"));
+
+  waypoints.Optimise();
+  found = waypoints.GetNearest(location, 100);
+  ok1(found && found->name == _T("Appended"));
+  ok1(waypoints.size() == 152);
+}
+
+/**
+ * Appending a waypoint to an optimised database must keep the packed
+ * index in use, before and after the next Optimise() call.
+ */
+static void
+TestAppendIndexed(Waypoints &waypoints, const GeoPoint &center)
+{
+  const GeoPoint location =
+    GeoVector(700, Angle::Degrees(270)).EndPoint(center);
+
+  Waypoint waypoint(location);
+  waypoint.name = _T("Indexed");
+  waypoints.Append(std::move(waypoint));
+
+  unsigned n = n_best_first_searches;
+  WaypointListVisitor before;
+  waypoints.VisitNearest(location, 150000, 3, before);
+  ok1(n_best_first_searches == n + 1 && !before.list.empty() &&
+      before.list.front()->name == _T("Indexed"));
+
+  waypoints.Optimise();
+
+  n = n_best_first_searches;
+  WaypointListVisitor after;
+  waypoints.VisitNearest(location, 150000, 3, after);
+  ok1(n_best_first_searches == n + 1 && !after.list.empty() &&
+      after.list.front()->name == _T("Indexed"));
+
+  const WaypointPtr found = waypoints.GetNearest(location, 100);
+  ok1(found && found->name == _T("Indexed"));
+
+  waypoints.Erase(WaypointPtr(found));
+  waypoints.Optimise();
+  ok1(waypoints.GetNearest(location, 100) == nullptr);
+}
+
+/**
+ * Check that the visited waypoints are ordered by increasing
+ * distance from the given location.
+ */
+static bool
+IsOrderedByDistance(const WaypointListVisitor &visitor,
+                    const GeoPoint &location)
+{
+  double last = 0;
+  for (const auto &wp : visitor.list) {
+    const double distance = location.Distance(wp->location);
+    if (distance < last - 1)
+      return false;
+
+    last = distance;
+  }
+
+  return true;
+}
+
+/**
+ * VisitNearestIf() must keep using the best-first search after a
+ * single Append() or Replace(), and merge the changed waypoints into
+ * its results.
+ */
+static void
+TestVisitNearestChanged(Waypoints &waypoints, const GeoPoint &center)
+{
+  const GeoPoint location =
+    GeoVector(2500, Angle::Degrees(180)).EndPoint(center);
+
+  Waypoint waypoint(location);
+  waypoint.name = _T("Landable");
+  waypoint.type = Waypoint::Type::OUTLANDING;
+  const WaypointPtr appended = waypoints.Append(std::move(waypoint));
+
+  unsigned n = n_best_first_searches;
+  WaypointListVisitor landable;
+  ok1(waypoints.VisitNearestIf(location, 150000, 10, IsLandable,
+                               landable) == 10);
+  ok1(n_best_first_searches == n + 1);
+  ok1(landable.list.front() == appended);
+  ok1(IsOrderedByDistance(landable, location));
+
+  /* move it to the other side of the spiral */
+  Waypoint moved = *appended;
+  moved.location = GeoVector(2500, Angle::Degrees(0)).EndPoint(center);
+  waypoints.Replace(appended, std::move(moved));
+
+  n = n_best_first_searches;
+  WaypointListVisitor replaced;
+  ok1(waypoints.VisitNearestIf(location, 150000, 10, IsLandable,
+                               replaced) == 10);
+  ok1(n_best_first_searches == n + 1);
+  ok1(replaced.list.front()->name != _T("Landable"));
+  ok1(IsOrderedByDistance(replaced, location));
+
+  waypoints.Erase(waypoints.LookupName(_T("Landable")));
+  waypoints.Optimise();
+}
+
 static void
 TestIterator(const Waypoints &waypoints)
 {
@@ -246,6 +541,166 @@ TestIterator(const Waypoints &waypoints)
   ok1(count == 151);
 }
 
+static Waypoint
+MakeWaypoint(const GeoPoint &location, const TCHAR *name,
+             const TCHAR *comment=_T(""))
+{
+  Waypoint waypoint(location);
+  waypoint.name = name;
+  waypoint.comment = comment;
+  return waypoint;
+}
+
+static void
+TestVisitText(const Waypoints &spiral, const GeoPoint &center)
+{
+  /* "Field" and "Airfield" waypoints; one replaced character */
+  WaypointPredicateCounter counter([](const Waypoint &wp){
+      return wp.name.find(_T("ield")) != tstring::npos;
+    });
+  ok1(spiral.VisitText(_T("fjeld"), 1, 1000, counter) == 65);
+  ok1(counter.GetCounter() == 65);
+
+  WaypointListVisitor visitor;
+  ok1(spiral.VisitText(_T("fjeld"), 0, 1000, visitor) == 0);
+
+  /* two corners, so the center is within the bounds of the tree */
+  const GeoPoint north_east(center.longitude + Angle::Degrees(0.1),
+                            center.latitude + Angle::Degrees(0.1));
+  const GeoPoint south_west(center.longitude - Angle::Degrees(0.1),
+                            center.latitude - Angle::Degrees(0.1));
+
+  Waypoints waypoints;
+  const auto a = waypoints.Append(MakeWaypoint(center, _T("Hahnweide")));
+  waypoints.Append(MakeWaypoint(north_east, _T("Hohe Weide")));
+  const auto c = waypoints.Append(MakeWaypoint(center, _T("Kirchheim"),
+                                               _T("near Hahnweide")));
+  const auto d = waypoints.Append(MakeWaypoint(south_west, _T("Hahnwede")));
+  waypoints.Optimise();
+
+  /* exact matches in the name first, then in the comment */
+  ok1(waypoints.VisitText(_T("hahn-weide"), 0, 10, visitor) == 2);
+  ok1(visitor.list.size() == 2 &&
+      visitor.list[0] == a && visitor.list[1] == c);
+
+  /* then the typos */
+  visitor.list.clear();
+  ok1(waypoints.VisitText(_T("hahnweide"), 1, 10, visitor) == 3);
+  ok1(visitor.list.size() == 3 && visitor.list[2] == d);
+
+  visitor.list.clear();
+  ok1(waypoints.VisitText(_T("hahnweide"), 1, 2, visitor) == 2);
+
+  /* single changes update the index without Optimise() */
+  waypoints.Append(MakeWaypoint(center, _T("Hahnweide Nord")));
+  ok1(waypoints.VisitText(_T("hahnweide"), 0, 10, visitor) == 3);
+  waypoints.Erase(WaypointPtr(a));
+  ok1(waypoints.VisitText(_T("hahnweide"), 0, 10, visitor) == 2);
+  waypoints.Replace(c, MakeWaypoint(center, _T("Kirchheim"),
+                                    _T("near Nabern")));
+  ok1(waypoints.VisitText(_T("hahnweide"), 0, 10, visitor) == 1);
+  waypoints.Optimise();
+  ok1(waypoints.VisitText(_T("hahnweide"), 0, 10, visitor) == 1);
+
+  /* before Optimise(), all waypoints are scanned */
+  Waypoints unoptimised;
+  unoptimised.Append(MakeWaypoint(center, _T("Hahnweide")));
+  ok1(unoptimised.VisitText(_T("hahnweide"), 0, 10, visitor) == 1);
+}
+
+static constexpr unsigned N_STORAGE = 10000;
+
+static std::vector<Waypoint>
+MakeStorageList(const GeoPoint &center)
+{
+  std::vector<Waypoint> list;
+  for (unsigned i = 0; i < N_STORAGE; ++i) {
+    StaticString<64> name;
+    name.Format(_T("Waypoint number %u"), i);
+    list.push_back(MakeWaypoint(GeoVector(i * 10., Angle::Degrees(i))
+                                .EndPoint(center),
+                                name, _T("a comment which is too long")));
+  }
+
+  return list;
+}
+
+/**
+ * Compare the memory used by waypoints appended one by one (e.g. user
+ * markers) with a batch (e.g. a file).
+ */
+static void
+TestStorage(const GeoPoint &center)
+{
+  HeapUsage start = heap_usage;
+
+  Waypoints single;
+  {
+    std::vector<Waypoint> list = MakeStorageList(center);
+    for (auto &wp : list)
+      single.Append(std::move(wp));
+  }
+  single.Optimise();
+
+  const HeapUsage single_usage = heap_usage - start;
+
+  start = heap_usage;
+
+  Waypoints batch;
+  {
+    std::vector<Waypoint> list = MakeStorageList(center);
+    batch.Append(std::move(list));
+    ok1(list.empty());
+  }
+  batch.Optimise();
+
+  const HeapUsage batch_usage = heap_usage - start;
+
+  diag("%u waypoints appended one by one: %u heap blocks, %u kB",
+       N_STORAGE, unsigned(single_usage.blocks),
+       unsigned(single_usage.bytes / 1024));
+  diag("%u waypoints appended as a batch: %u heap blocks, %u kB",
+       N_STORAGE, unsigned(batch_usage.blocks),
+       unsigned(batch_usage.bytes / 1024));
+
+  ok1(batch.size() == N_STORAGE);
+  ok1(batch_usage.blocks < single_usage.blocks);
+  ok1(batch_usage.bytes < single_usage.bytes);
+
+  /* the comments of a batch are interned */
+  const WaypointPtr first = batch.LookupName(_T("Waypoint number 1"));
+  const WaypointPtr second = batch.LookupName(_T("Waypoint number 2"));
+  ok1(first != nullptr && second != nullptr &&
+      first->comment.IsSharedWith(second->comment) &&
+      first->comment == _T("a comment which is too long"));
+
+  /* waypoints of the batch remain valid after they were erased */
+  WaypointPtr wp = batch.LookupName(_T("Waypoint number 42"));
+  ok1(wp != nullptr);
+  const WaypointPtr copy = wp;
+  batch.Erase(std::move(wp));
+  batch.Clear();
+  ok1(copy->name == _T("Waypoint number 42"));
+
+  /* a waypoint which outlives its container keeps only its own
+     block alive, not the whole batch */
+  start = heap_usage;
+  WaypointPtr survivor;
+  {
+    Waypoints reloaded;
+    reloaded.Append(MakeStorageList(center));
+    survivor = reloaded.LookupName(_T("Waypoint number 42"));
+  }
+
+  const HeapUsage retained_usage = heap_usage - start;
+  diag("1 waypoint referenced after its container was deleted:"
+       " %u heap blocks, %u kB",
+       unsigned(retained_usage.blocks),
+       unsigned(retained_usage.bytes / 1024));
+  ok1(survivor != nullptr);
+  ok1(retained_usage.bytes < batch_usage.bytes / 50);
+}
+
 static unsigned
 TestCopy(Waypoints& waypoints)
 {
@@ -301,7 +756,7 @@ main(int argc, char** argv)
   if (!ParseArgs(argc, argv))
     return 0;
 
-  plan_tests(52);
+  plan_tests(100);
 
   Waypoints waypoints;
   GeoPoint center(Angle::Degrees(51.4), Angle::Degrees(7.85));
@@ -316,8 +771,16 @@ main(int argc, char** argv)
   TestLookups(waypoints, center);
   TestNamePrefixVisitor(waypoints);
   TestRangeVisitor(waypoints, center);
+  TestBoundsVisitor(waypoints, center);
   TestGetNearest(waypoints, center);
   TestIterator(waypoints);
+  TestNearestLinear(waypoints, center);
+  TestVisitNearest(waypoints, center);
+  TestAppendOptimised(waypoints, center);
+  TestAppendIndexed(waypoints, center);
+  TestVisitNearestChanged(waypoints, center);
+  TestVisitText(waypoints, center);
+  TestStorage(center);
 
   ok(TestCopy(waypoints), "waypoint copy", 0);
   ok(TestErase(waypoints, 3), "waypoint erase", 0);
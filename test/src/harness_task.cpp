@@ -931,48 +931,42 @@ bool test_task_random(TaskManager& task_manager,
   return true;
 }
 
-bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
-                      const Waypoints &waypoints,
-                      const unsigned _num_points)
+/**
+ * @param valid_for_type if true, clamp the number of points to the
+ * factory maximum, close the task if the factory requires it and
+ * update the full geometry, so the task validates for any factory
+ * type; if false, generate the task exactly like
+ * test_task_random_RT_AAT_FAI() always did
+ */
+static bool
+generate_random_task(TaskManager& task_manager,
+                     const Waypoints &waypoints,
+                     TaskFactoryType type,
+                     const unsigned _num_points,
+                     bool valid_for_type)
 {
   WaypointPtr wp;
 
   OrderedTaskPoint *tp;
   char tmp[255];
-  char tskType[20];
-  tskType[0] = '\0';
 
-
-  switch (rand() %3) {
-  case 0:
-    task_manager.SetFactory(TaskFactoryType::AAT);
-    strcpy(tskType,"AAT");
-    test_note("# creating random AAT task\n");
-    break;
-  case 1:
-    task_manager.SetFactory(TaskFactoryType::RACING);
-    strcpy(tskType,"RT");
-    test_note("# creating random RT task\n");
-    break;
-  case 2:
-    task_manager.SetFactory(TaskFactoryType::FAI_GENERAL);
-    strcpy(tskType,"FAI");
-    test_note("# creating random FAI GENERAL\n");
-    break;
-  }
+  task_manager.SetFactory(type);
 
   AbstractTaskFactory &fact = task_manager.GetFactory();
 
   //max points includes start & finish
   const TaskFactoryConstraints &constraints =
     task_manager.GetOrderedTask().GetFactoryConstraints();
-  const unsigned num_points_total =
+  unsigned num_points_total =
     std::max(constraints.min_points,
              _num_points % constraints.max_points) + 1;
+  if (valid_for_type)
+    num_points_total = std::min(num_points_total, constraints.max_points);
   const unsigned num_int_points = num_points_total - 2;
 
   test_note("# adding start\n");
   wp = random_waypoint(waypoints);
+  const WaypointPtr start_wp = wp;
   if (wp) {
     const TaskPointFactoryType s = GetRandomType(fact.GetStartTypes());
 
@@ -998,7 +992,9 @@ bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
   }
 
   test_note("# adding finish\n");
-  wp = random_waypoint(waypoints);
+  wp = valid_for_type && constraints.is_closed
+    ? start_wp
+    : random_waypoint(waypoints);
   if (wp) {
     const TaskPointFactoryType s = GetRandomType(fact.GetFinishTypes());
 
@@ -1009,7 +1005,11 @@ bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
     delete tp;
   }
 
-  fact.UpdateStatsGeometry();
+  if (valid_for_type)
+    /* the FAI triangle validator needs the planned leg vectors */
+    fact.UpdateGeometry();
+  else
+    fact.UpdateStatsGeometry();
 
   test_note("# validating task..\n");
   if (!fact.Validate()) {
@@ -1032,12 +1032,42 @@ bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
   }
   task_manager.Resume();
   sprintf(tmp, "# SUCCESS CREATING %s task! task_size():%d..\n",
-      tskType,
+      factory_name(type),
       task_manager.TaskSize());
   test_note(tmp);
   return true;
 }
 
+bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
+                      const Waypoints &waypoints,
+                      const unsigned _num_points)
+{
+  switch (rand() %3) {
+  case 0:
+    test_note("# creating random AAT task\n");
+    return generate_random_task(task_manager, waypoints,
+                                TaskFactoryType::AAT, _num_points, false);
+  case 1:
+    test_note("# creating random RT task\n");
+    return generate_random_task(task_manager, waypoints,
+                                TaskFactoryType::RACING, _num_points, false);
+  default:
+    test_note("# creating random FAI GENERAL\n");
+    return generate_random_task(task_manager, waypoints,
+                                TaskFactoryType::FAI_GENERAL, _num_points,
+                                false);
+  }
+}
+
+bool test_task_random_type(TaskManager& task_manager,
+                           const Waypoints &waypoints,
+                           TaskFactoryType type,
+                           const unsigned _num_points)
+{
+  return generate_random_task(task_manager, waypoints, type, _num_points,
+                              true);
+}
+
 bool test_task(TaskManager& task_manager,
                const Waypoints &waypoints,
                int test_num)
@@ -1068,6 +1098,35 @@ bool test_task(TaskManager& task_manager,
 }
 
 
+const char *
+factory_name(TaskFactoryType type)
+{
+  switch (type) {
+  case TaskFactoryType::FAI_GENERAL:
+    return "FAI";
+  case TaskFactoryType::FAI_TRIANGLE:
+    return "FAI triangle";
+  case TaskFactoryType::FAI_OR:
+    return "FAI OR";
+  case TaskFactoryType::FAI_GOAL:
+    return "FAI goal";
+  case TaskFactoryType::RACING:
+    return "RT";
+  case TaskFactoryType::AAT:
+    return "AAT";
+  case TaskFactoryType::MAT:
+    return "MAT";
+  case TaskFactoryType::MIXED:
+    return "mixed";
+  case TaskFactoryType::TOURING:
+    return "touring";
+  case TaskFactoryType::COUNT:
+    break;
+  }
+
+  return "unknown";
+}
+
 const char* task_name(int test_num)
 {
   switch (test_num) {
@@ -24,6 +24,7 @@
 #define TEST_TASK_HPP
 
 #include "Task/TaskManager.hpp"
+#include "Task/Factory/TaskFactoryType.hpp"
 
 #define NUM_TASKS 5
 
@@ -70,6 +71,15 @@ bool test_task_random_RT_AAT_FAI(TaskManager& task_manager,
                       const Waypoints &waypoints,
                       const unsigned num_points);
 
+/**
+ * Generates a random task of the given factory type with valid
+ * random start/finish/intermediate points
+ */
+bool test_task_random_type(TaskManager& task_manager,
+                           const Waypoints &waypoints,
+                           TaskFactoryType type,
+                           const unsigned num_points);
+
 bool test_task(TaskManager& task_manager,
                const Waypoints &waypoints,
                int test_num);
@@ -84,6 +94,8 @@ task_report(const TaskManager &task_manager, const char *text);
 
 const char* task_name(int test_num);
 
+const char *factory_name(TaskFactoryType type);
+
 WaypointPtr random_waypoint(const Waypoints &waypoints);
 
 #endif
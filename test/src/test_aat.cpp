@@ -23,6 +23,10 @@
 #include "harness_flight.hpp"
 #include "harness_wind.hpp"
 #include "test_debug.hpp"
+#include "Task/PathSolvers/TaskDijkstraMin.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Clock.hpp"
 
 static bool
 test_aat(int test_num, int n_wind)
@@ -43,6 +47,84 @@ test_aat(int test_num, int n_wind)
   return fine;
 }
 
+/**
+ * Generate the search points of a sector: its centre plus a ring.
+ */
+static void
+make_sector(SearchPointVector &points, const GeoPoint &center,
+            double radius, unsigned n)
+{
+  points.clear();
+  points.push_back(SearchPoint(center));
+  for (unsigned i = 0; i < n; ++i)
+    points.push_back(SearchPoint(GeoVector(radius,
+                                           Angle::FullCircle() * i / n)
+                                 .EndPoint(center)));
+}
+
+/**
+ * Measure the cost of a minimum distance update after a new sample
+ * in the active sector, reusing the previous search (warm) and
+ * starting from scratch (cold).
+ */
+static bool
+test_dijkstra_update()
+{
+  const GeoPoint origin(Angle::Degrees(7), Angle::Degrees(45));
+  constexpr unsigned n_stages = 5;
+  SearchPointVector stages[n_stages];
+  for (unsigned i = 0; i < n_stages; ++i)
+    make_sector(stages[i],
+                GeoVector(40000. * i, Angle::Degrees(60. * i)).EndPoint(origin),
+                i == 0 || i + 1 == n_stages ? 3000 : 20000,
+                i == 0 || i + 1 == n_stages ? 32 : 256);
+
+  SearchPointVector &active = stages[0];
+  active.resize(1);
+
+  TaskDijkstraMin warm, cold;
+  warm.SetTaskSize(n_stages);
+  cold.SetTaskSize(n_stages);
+  for (unsigned i = 0; i < n_stages; ++i) {
+    warm.SetBoundary(i, stages[i]);
+    cold.SetBoundary(i, stages[i]);
+  }
+
+  constexpr unsigned n_updates = 100;
+  uint64_t warm_time = 0, cold_time = 0;
+  unsigned warm_stages = 0;
+  bool success = true;
+
+  for (unsigned i = 0; i < n_updates; ++i) {
+    /* the aircraft flies through the active sector and adds a
+       sample */
+    const GeoPoint location = GeoVector(100. * i, Angle::Degrees(20))
+      .EndPoint(origin);
+    active.push_back(SearchPoint(location));
+    const SearchPoint ac(location);
+
+    auto start = MonotonicClockUS();
+    success &= warm.DistanceMin(ac);
+    warm_time += MonotonicClockUS() - start;
+    warm_stages += warm.GetStagesCalculated();
+
+    start = MonotonicClockUS();
+    cold.Invalidate();
+    success &= cold.DistanceMin(ac);
+    cold_time += MonotonicClockUS() - start;
+
+    for (unsigned j = 0; j < n_stages; ++j)
+      success &= warm.GetSolution(j).GetLocation() ==
+        cold.GetSolution(j).GetLocation();
+  }
+
+  printf("# dijkstra update: warm %.1f us (%.1f stages), cold %.1f us\n",
+         double(warm_time) / n_updates, double(warm_stages) / n_updates,
+         double(cold_time) / n_updates);
+
+  return success;
+}
+
 int main(int argc, char** argv) 
 {
   // default arguments
@@ -54,7 +136,9 @@ int main(int argc, char** argv)
 
 #define NUM_FLIGHT 2
 
-  plan_tests(NUM_FLIGHT*2);
+  plan_tests(NUM_FLIGHT*2 + 1);
+
+  ok(test_dijkstra_update(), "dijkstra update", 0);
 
   for (int i=0; i<NUM_FLIGHT; i++) {
     unsigned k = rand()%NUM_WIND;
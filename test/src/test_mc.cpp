@@ -28,6 +28,7 @@
 #include "GlideSolvers/MacCready.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/Clock.hpp"
 
 #include <stdio.h>
 #include <fstream>
@@ -266,15 +267,108 @@ test_cb()
   return true;
 }
 
+/**
+ * Time the speed to fly and MC=0 final glide solvers, which are
+ * called per task leg, alternate and landable in every cycle.
+ */
+static bool
+test_timing()
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  const unsigned n = 20000;
+  double sum = 0;
+
+  {
+    GlidePolar polar(1);
+    const auto start = MonotonicClockUS();
+    for (unsigned i = 0; i < n; ++i)
+      sum += polar.SpeedToFly((i % 50) * 0.1 - 2, (i % 31) - 15.);
+    const auto elapsed = MonotonicClockUS() - start;
+    diag("SpeedToFly: %.3f us/call", double(elapsed) / n);
+  }
+
+  {
+    GlidePolar polar(0);
+    const auto start = MonotonicClockUS();
+    for (unsigned i = 0; i < n; ++i) {
+      const SpeedVector wind(Angle::Degrees((i % 36) * 10.), (i % 5) * 5.);
+      const GlideState gs(GeoVector(20000, Angle::Zero()), 0, 1000, wind);
+      sum += MacCready::Solve(settings, polar, gs).v_opt;
+    }
+    const auto elapsed = MonotonicClockUS() - start;
+    diag("OptimiseGlide: %.3f us/call", double(elapsed) / n);
+  }
+
+  return sum > 0;
+}
+
+/**
+ * Time the arrival altitude calculation for many destinations, one
+ * SolveStraight() call each versus one batch call.
+ */
+static bool
+test_batch_timing()
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  constexpr unsigned n = 5000;
+  static double distance[n], altitude_difference[n], arrival[n];
+  static Angle bearing[n];
+  static bool valid[n];
+
+  for (unsigned i = 0; i < n; ++i) {
+    distance[i] = 1000 + (i * 7919) % 100000;
+    bearing[i] = Angle::Degrees((i * 37) % 360);
+    altitude_difference[i] = 1500. - (i % 50) * 20;
+  }
+
+  bool success = true;
+
+  for (double mc = 0; mc <= 1; mc += 1) {
+    GlidePolar polar(mc);
+    const MacCready mac(settings, polar);
+    const SpeedVector wind(Angle::Degrees(30), 10);
+
+    auto start = MonotonicClockUS();
+    double sum = 0;
+    for (unsigned i = 0; i < n; ++i) {
+      const GlideState gs(GeoVector(distance[i], bearing[i]), 0,
+                          altitude_difference[i], wind);
+      sum += mac.SolveStraight(gs).pure_glide_altitude_difference;
+    }
+    const auto single = MonotonicClockUS() - start;
+
+    start = MonotonicClockUS();
+    mac.SolveStraight(wind, n, distance, bearing, altitude_difference,
+                      arrival, valid);
+    const auto batch = MonotonicClockUS() - start;
+
+    for (unsigned i = 0; i < n; ++i)
+      sum -= arrival[i];
+
+    diag("%u destinations MC=%.0f: single %.3f ms, batch %.3f ms",
+         n, mc, single / 1000., batch / 1000.);
+
+    success = success && fabs(sum) < n;
+  }
+
+  return success;
+}
+
 int main() {
 
-  plan_tests(3);
+  plan_tests(5);
 
   Directory::Create(Path(_T("output/results")));
 
   ok(test_mc(),"mc output",0);
   ok(test_stf(),"mc stf",0);
   ok(test_cb(),"cruise bearing",0);
+  ok(test_timing(),"solver timing",0);
+  ok(test_batch_timing(),"batch timing",0);
 
   return exit_status();
 